@@ -0,0 +1,257 @@
+// Generated by tools/embed_web.py from web/index.html. Do not edit.
+#ifndef WebUi_H
+#define WebUi_H
+
+#include <Arduino.h>
+
+// 3890 bytes, 13683 uncompressed
+const char INDEX_HTML_ETAG[] = "\"5b0a67970a9ae55d\"";
+const size_t INDEX_HTML_GZ_SIZE = 3890;
+const uint8_t INDEX_HTML_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xad, 0x1b, 0x69, 0x73, 0xdb, 0x36,
+    0xf6, 0x7b, 0x7e, 0x05, 0xc2, 0x9d, 0xa9, 0xc9, 0x58, 0x97, 0xed, 0x34, 0x9b, 0xb1, 0x25, 0x75,
+    0x14, 0x5b, 0x69, 0xbc, 0x63, 0xc7, 0x19, 0xd9, 0x3d, 0x76, 0xb3, 0x99, 0x0c, 0x44, 0x42, 0x12,
+    0x6b, 0x5e, 0x4b, 0x42, 0xb6, 0x95, 0xd6, 0xff, 0x7d, 0xdf, 0xc3, 0x41, 0x82, 0x87, 0x0e, 0x3b,
+    0xed, 0xb4, 0x15, 0x09, 0xbc, 0x0b, 0x0f, 0x0f, 0xef, 0x02, 0xdd, 0x7f, 0x79, 0x76, 0x75, 0x7a,
+    0xf3, 0xef, 0x4f, 0x63, 0xf2, 0xe1, 0xe6, 0xf2, 0x62, 0xd8, 0x5f, 0xf0, 0x30, 0x18, 0xbe, 0x20,
+    0xfd, 0x05, 0xa3, 0x1e, 0xfc, 0xc2, 0x3f, 0xfd, 0x90, 0x71, 0x4a, 0x22, 0x1a, 0xb2, 0x81, 0x75,
+    0xe7, 0xb3, 0xfb, 0x24, 0x4e, 0xb9, 0x45, 0xdc, 0x38, 0xe2, 0x2c, 0xe2, 0x03, 0xeb, 0xde, 0xf7,
+    0xf8, 0x62, 0xe0, 0xb1, 0x3b, 0xdf, 0x65, 0x6d, 0xf1, 0xd2, 0x22, 0x7e, 0xe4, 0x73, 0x9f, 0x06,
+    0xed, 0xcc, 0xa5, 0x01, 0x1b, 0x1c, 0x58, 0x8a, 0x50, 0xc6, 0x57, 0x01, 0x93, 0xcf, 0x84, 0x20,
+    0x23, 0xf2, 0xa7, 0x7a, 0x21, 0x64, 0x06, 0xf4, 0xda, 0x33, 0x1a, 0xfa, 0xc1, 0xea, 0x98, 0x8c,
+    0x52, 0xc0, 0x3e, 0xc9, 0xe7, 0x3c, 0x3f, 0x4b, 0x02, 0x0a, 0xe3, 0x7e, 0x14, 0xf8, 0x11, 0x6b,
+    0x4f, 0x83, 0xd8, 0xbd, 0x2d, 0xa6, 0x43, 0x9a, 0xce, 0xfd, 0xe8, 0x98, 0xf4, 0x92, 0x07, 0x42,
+    0x97, 0x3c, 0x2e, 0x66, 0x38, 0x7b, 0xe0, 0x6d, 0x1a, 0xf8, 0x73, 0x98, 0x75, 0x41, 0x5a, 0x96,
+    0xea, 0xb9, 0x47, 0x29, 0x51, 0x37, 0x17, 0xa9, 0xdf, 0xd5, 0x2b, 0xee, 0x4f, 0x63, 0x6f, 0xa5,
+    0x24, 0x5e, 0x1c, 0x0e, 0x2f, 0x68, 0x42, 0x6e, 0xfc, 0x90, 0xa5, 0x00, 0x71, 0xa8, 0x86, 0x13,
+    0xbd, 0x88, 0x7e, 0x96, 0xd0, 0x08, 0x40, 0x32, 0x4e, 0x6e, 0x52, 0x7f, 0x3e, 0x67, 0xa9, 0x1c,
+    0x22, 0xbe, 0x37, 0xb0, 0x02, 0x18, 0x4e, 0x97, 0x91, 0x35, 0x04, 0x36, 0x08, 0xa6, 0x7e, 0x34,
+    0xea, 0xe2, 0x60, 0x58, 0x86, 0xe5, 0x92, 0x82, 0x35, 0x6c, 0x93, 0x8c, 0xb9, 0x39, 0x12, 0xc0,
+    0x99, 0xdc, 0x04, 0x38, 0x90, 0xcd, 0xac, 0x2a, 0xc1, 0x69, 0x5a, 0x07, 0x04, 0xc5, 0xf9, 0x7c,
+    0x13, 0xa4, 0xf9, 0xb8, 0xe4, 0x3c, 0x96, 0x68, 0x53, 0x1e, 0x7d, 0xcd, 0x38, 0x4d, 0x79, 0xc6,
+    0xe3, 0xc4, 0x22, 0x7c, 0x95, 0xc0, 0xe6, 0xcb, 0x79, 0x6b, 0x78, 0x8d, 0x13, 0xfd, 0xae, 0x7c,
+    0x6d, 0xe4, 0x1e, 0xd2, 0x20, 0x90, 0xec, 0x39, 0xe5, 0x4b, 0x29, 0x29, 0x8e, 0x6d, 0x06, 0x4e,
+    0xe2, 0x7b, 0x5c, 0x7d, 0x15, 0x76, 0x71, 0x34, 0xbc, 0xf0, 0xef, 0x18, 0x99, 0xc0, 0xfe, 0xf8,
+    0xd1, 0x3c, 0x03, 0x8d, 0x1c, 0x15, 0xd8, 0x2c, 0x60, 0x2e, 0x17, 0xe8, 0xee, 0x02, 0xc4, 0x9a,
+    0x53, 0xce, 0x2c, 0xb2, 0xf0, 0x3d, 0x8f, 0x09, 0x85, 0x8b, 0xe9, 0x26, 0xb6, 0x2e, 0x8d, 0xee,
+    0x68, 0x56, 0x20, 0x5a, 0x44, 0x1a, 0xb2, 0x75, 0xf4, 0xa6, 0x07, 0x04, 0x98, 0x3f, 0x5f, 0x80,
+    0x71, 0x1f, 0xbc, 0xed, 0xa1, 0x40, 0x12, 0x78, 0xad, 0xf4, 0xc3, 0x33, 0x1f, 0x16, 0x1a, 0xb9,
+    0x8c, 0xd8, 0xd3, 0x80, 0xba, 0xb7, 0x4e, 0x8b, 0xd0, 0x3b, 0x96, 0xd2, 0xb9, 0x18, 0x58, 0x32,
+    0x78, 0x57, 0x7b, 0x4b, 0xf8, 0x22, 0x65, 0xd9, 0x22, 0x0e, 0xbc, 0x8c, 0xd8, 0xf3, 0x94, 0xad,
+    0x60, 0xca, 0x63, 0x1c, 0x64, 0xf4, 0xe3, 0x08, 0x86, 0x52, 0xe6, 0x39, 0xc6, 0xee, 0x79, 0xcc,
+    0xf5, 0x43, 0x8a, 0x73, 0xa6, 0x11, 0x55, 0xb5, 0x73, 0xcd, 0x38, 0xaf, 0x29, 0x66, 0x16, 0xa7,
+    0xa1, 0xdc, 0x02, 0x35, 0x6b, 0x0d, 0xf3, 0x63, 0xd1, 0x0f, 0xe8, 0x94, 0x05, 0xc3, 0x09, 0x8d,
+    0xe0, 0xdc, 0xcc, 0xc9, 0x39, 0x1e, 0x8c, 0x3b, 0x1a, 0x10, 0x3b, 0x04, 0xbb, 0x73, 0xfa, 0x5d,
+    0x39, 0x5d, 0x80, 0xfb, 0x51, 0xb2, 0xe4, 0xca, 0x08, 0xa2, 0x65, 0x38, 0x85, 0x5d, 0x92, 0x56,
+    0x28, 0x09, 0xb4, 0x7d, 0x45, 0xc0, 0x52, 0x5e, 0xc2, 0x63, 0x70, 0x5a, 0x4d, 0x7e, 0x85, 0xc2,
+    0x72, 0xe6, 0xef, 0x96, 0x29, 0x1c, 0x9a, 0x0f, 0xa0, 0x89, 0x27, 0xb3, 0x9d, 0x22, 0x6a, 0x1b,
+    0x95, 0xa8, 0x19, 0x8a, 0x11, 0xa4, 0xb5, 0x85, 0xe9, 0x6f, 0x7e, 0xe4, 0xc5, 0xf7, 0xe4, 0xda,
+    0xff, 0xc6, 0x76, 0x67, 0x77, 0x2f, 0x90, 0xda, 0x19, 0x20, 0x69, 0x7e, 0x72, 0x08, 0xc9, 0x6c,
+    0x61, 0x78, 0xa6, 0xf7, 0xf6, 0x89, 0x3c, 0x73, 0x9b, 0x28, 0xb1, 0xcd, 0x47, 0x9f, 0xc4, 0xf9,
+    0x92, 0xf1, 0x45, 0xec, 0xd5, 0x79, 0xab, 0xa3, 0x53, 0x21, 0x2d, 0xa1, 0xab, 0x52, 0x84, 0x72,
+    0xb4, 0xc0, 0x06, 0xfc, 0x38, 0x11, 0xe4, 0x61, 0xdf, 0x97, 0x40, 0x00, 0xce, 0xc9, 0x27, 0x96,
+    0xa2, 0x93, 0x05, 0x77, 0x3d, 0x9b, 0xb1, 0x94, 0xc1, 0x79, 0xe8, 0x77, 0x25, 0xd0, 0x06, 0xbc,
+    0x03, 0xe1, 0x4f, 0x38, 0x1c, 0x20, 0x1f, 0x82, 0x45, 0x1d, 0xa1, 0x7a, 0x86, 0xd7, 0x58, 0x13,
+    0x05, 0x28, 0x08, 0x0d, 0x5b, 0x56, 0x39, 0x55, 0x60, 0x63, 0xe0, 0x06, 0xe7, 0x2a, 0xd6, 0x06,
+    0xa5, 0x86, 0xdb, 0x2c, 0x1f, 0xdf, 0xbc, 0xd2, 0x4b, 0x46, 0xa3, 0xdd, 0xd6, 0x76, 0xc9, 0x3c,
+    0x7f, 0x27, 0xd8, 0x43, 0x6b, 0xf8, 0x81, 0x86, 0x09, 0x7b, 0xb6, 0x0a, 0xb4, 0xf6, 0xcf, 0x72,
+    0xed, 0xeb, 0x90, 0xb4, 0xbb, 0xd9, 0x25, 0x92, 0x46, 0x1b, 0x77, 0xb0, 0xad, 0xc3, 0x91, 0xd2,
+    0x9d, 0x9a, 0x43, 0xf2, 0x37, 0x3a, 0x50, 0x6d, 0x14, 0xe8, 0x3f, 0xed, 0x6b, 0x37, 0x4e, 0x9f,
+    0x21, 0xc5, 0x37, 0xc8, 0x1b, 0x00, 0xb1, 0x2a, 0xc0, 0x37, 0x41, 0x6e, 0x37, 0xde, 0xa3, 0x19,
+    0x78, 0x24, 0x52, 0x9c, 0x81, 0x33, 0xf4, 0x48, 0xbb, 0x4b, 0x40, 0x11, 0xbd, 0x5d, 0x98, 0xbf,
+    0x74, 0x68, 0x4a, 0x0e, 0x31, 0x99, 0x93, 0x3e, 0xdb, 0xc1, 0xd7, 0x5d, 0xfa, 0x11, 0xd1, 0x69,
+    0xc4, 0x93, 0xbd, 0x5d, 0xe8, 0x47, 0xed, 0x80, 0x26, 0x6d, 0xb0, 0xcc, 0xdc, 0x11, 0xc0, 0x18,
+    0xd0, 0x43, 0x72, 0xdb, 0x38, 0xd3, 0x87, 0xef, 0xe0, 0x4c, 0x1f, 0xea, 0x9c, 0xe9, 0xc3, 0x6e,
+    0x9c, 0x2f, 0xe2, 0x39, 0xb9, 0x60, 0x77, 0x68, 0xcf, 0x1b, 0x8f, 0x64, 0x10, 0xcf, 0x05, 0x98,
+    0x64, 0x09, 0x6f, 0xed, 0x40, 0xbc, 0x6e, 0x3e, 0x80, 0x67, 0xe3, 0x77, 0xbf, 0xfc, 0xbc, 0xdb,
+    0x09, 0x3c, 0xff, 0xf8, 0xfe, 0x6a, 0xb7, 0xf3, 0xf7, 0xdb, 0x68, 0xf2, 0xf1, 0xfc, 0xe3, 0x2e,
+    0x64, 0x8f, 0xac, 0xe1, 0x78, 0x32, 0xb9, 0x9a, 0x3c, 0xfb, 0xac, 0x62, 0xa6, 0xb3, 0x45, 0x31,
+    0x22, 0x1b, 0xba, 0x8c, 0x3d, 0x66, 0x15, 0xc9, 0x51, 0x3b, 0xc4, 0xf7, 0xad, 0x5e, 0x18, 0x63,
+    0x3f, 0xdd, 0xdd, 0xfd, 0xd2, 0x3b, 0x08, 0xe2, 0xdf, 0xb5, 0x14, 0xf2, 0x8e, 0x46, 0xb7, 0x60,
+    0x5f, 0xa3, 0xc5, 0x53, 0xc2, 0x38, 0xe5, 0x70, 0x90, 0x56, 0x6d, 0x97, 0x26, 0xd4, 0xf5, 0x79,
+    0x7e, 0xbe, 0xd4, 0xf8, 0xa9, 0x1e, 0x2e, 0xf3, 0x2f, 0xcb, 0x60, 0xd2, 0xce, 0x96, 0xd3, 0x10,
+    0x72, 0x5d, 0xbd, 0xb2, 0x5f, 0x12, 0x0f, 0x73, 0xc1, 0x35, 0xc0, 0x90, 0x85, 0xb1, 0x02, 0x76,
+    0x22, 0xde, 0xf2, 0xdc, 0xa9, 0x8b, 0x0a, 0x54, 0xa9, 0x7e, 0x37, 0xa9, 0xe5, 0xfc, 0x22, 0xe5,
+    0x8a, 0xb2, 0x38, 0x05, 0xd7, 0x46, 0x51, 0xcb, 0x46, 0xda, 0x55, 0xc9, 0xa1, 0x39, 0x02, 0x54,
+    0xf3, 0xe7, 0x09, 0x03, 0x47, 0xe6, 0xd5, 0x12, 0x68, 0x4a, 0x20, 0x37, 0x9c, 0x0d, 0xac, 0xae,
+    0x42, 0x82, 0x0c, 0x23, 0x0a, 0x62, 0x0a, 0x94, 0xc4, 0x40, 0x67, 0xea, 0x03, 0xee, 0x99, 0x1a,
+    0xec, 0x77, 0xe9, 0x46, 0x01, 0xdf, 0x07, 0x98, 0xc0, 0x12, 0xc9, 0x4a, 0xd4, 0x2e, 0x47, 0xf5,
+    0xe2, 0x60, 0x26, 0x80, 0x30, 0xd1, 0x47, 0x45, 0x55, 0x6b, 0x84, 0xf2, 0x4a, 0x24, 0x6c, 0x75,
+    0x29, 0xef, 0x53, 0xc6, 0x30, 0xaf, 0x59, 0xb7, 0x14, 0x8d, 0x55, 0xac, 0x45, 0x8e, 0x3c, 0x6d,
+    0x31, 0xe8, 0xc1, 0x3e, 0x40, 0x86, 0x10, 0xa7, 0xab, 0xe6, 0x85, 0x80, 0x97, 0xca, 0x76, 0x5b,
+    0x86, 0x1b, 0x30, 0x9a, 0x7e, 0x45, 0xf8, 0xea, 0x52, 0x4e, 0x71, 0x66, 0xfd, 0x4a, 0x68, 0xe2,
+    0x77, 0xef, 0x0e, 0xe0, 0x48, 0x64, 0x19, 0xa6, 0xea, 0x70, 0x6c, 0xd4, 0x53, 0x2e, 0x7c, 0x03,
+    0x34, 0xf2, 0xf9, 0x29, 0xf0, 0xc1, 0x2c, 0x07, 0x07, 0xbd, 0x1e, 0x1c, 0xce, 0x11, 0x94, 0x3a,
+    0x38, 0xb8, 0x75, 0xc5, 0xf1, 0xbc, 0x6c, 0x56, 0x45, 0xc5, 0x81, 0x35, 0x2d, 0x4d, 0x19, 0x25,
+    0xf0, 0x9f, 0x17, 0x47, 0xc1, 0x4a, 0x3b, 0x4e, 0x8b, 0xa4, 0xf1, 0x7d, 0x36, 0xb0, 0x7e, 0xec,
+    0x61, 0x75, 0x1e, 0xc8, 0x27, 0x50, 0x87, 0x46, 0x28, 0x31, 0x84, 0x85, 0xaa, 0x2a, 0xb7, 0x9f,
+    0xb9, 0xa9, 0x9f, 0xa8, 0x53, 0xde, 0xed, 0x92, 0x9b, 0x05, 0x23, 0x09, 0x96, 0x2e, 0x3e, 0x87,
+    0xf3, 0x3f, 0x23, 0x7e, 0x46, 0x50, 0xb3, 0xbe, 0x4b, 0x68, 0xe4, 0x11, 0x97, 0xba, 0x0b, 0xe6,
+    0xb5, 0x08, 0xf8, 0xe8, 0x74, 0xc5, 0x17, 0x58, 0x3e, 0xc8, 0xd2, 0x9f, 0x64, 0x09, 0x14, 0x2b,
+    0x33, 0x00, 0x73, 0xe3, 0x90, 0x65, 0x64, 0x96, 0xc6, 0x21, 0x54, 0x3b, 0x8c, 0x8c, 0x3e, 0x9d,
+    0x0b, 0xd2, 0xb3, 0x65, 0x24, 0x63, 0x31, 0x94, 0x3f, 0xf7, 0xb0, 0xa3, 0x22, 0x1a, 0xb5, 0x08,
+    0x54, 0xb2, 0x8e, 0xd1, 0x06, 0x70, 0x41, 0xa3, 0x1c, 0xcb, 0x5f, 0x32, 0x20, 0x76, 0x42, 0xd3,
+    0x8c, 0xbd, 0x07, 0x0b, 0xe1, 0x32, 0x74, 0x91, 0x2e, 0x41, 0x35, 0x3a, 0x1d, 0x1e, 0xbf, 0xf7,
+    0x1f, 0x98, 0x67, 0x1f, 0x39, 0x46, 0x93, 0x20, 0x76, 0x97, 0x21, 0x24, 0x28, 0x9d, 0x39, 0xe3,
+    0xe3, 0x80, 0xe1, 0xe3, 0xbb, 0xd5, 0xb9, 0x67, 0xef, 0x19, 0xa5, 0xf5, 0x9e, 0xd3, 0xf1, 0xa3,
+    0x88, 0xa5, 0xd8, 0xea, 0x40, 0x06, 0xc8, 0x67, 0x9f, 0x58, 0xc8, 0xcf, 0xda, 0x95, 0x14, 0x08,
+    0x0c, 0x64, 0x50, 0xa9, 0xa7, 0xb2, 0x05, 0x02, 0x84, 0x60, 0x8c, 0xfc, 0x44, 0x6c, 0xcb, 0xc6,
+    0x87, 0x7f, 0x58, 0x40, 0x13, 0x1f, 0x80, 0xb2, 0x63, 0x39, 0xe4, 0x98, 0x58, 0x96, 0xa4, 0xfd,
+    0xf8, 0xa2, 0xae, 0x89, 0x09, 0x54, 0xf2, 0x88, 0x96, 0x99, 0x5a, 0x58, 0x2b, 0x00, 0x02, 0x36,
+    0x71, 0xcf, 0x3a, 0x01, 0x8b, 0xe6, 0x7c, 0x41, 0x06, 0x03, 0xd2, 0x03, 0x51, 0x2c, 0x8b, 0x1c,
+    0x1b, 0x4e, 0xdf, 0xba, 0x8a, 0x40, 0xb3, 0x50, 0x24, 0x31, 0x10, 0x46, 0x4a, 0x97, 0x75, 0x42,
+    0xd8, 0x83, 0x94, 0x0c, 0x86, 0xc4, 0x92, 0x12, 0x77, 0x94, 0xcc, 0x02, 0xc2, 0x4e, 0x3b, 0x0c,
+    0x0d, 0x95, 0x79, 0x97, 0x7e, 0x10, 0x80, 0x0d, 0x54, 0x55, 0x7f, 0xe0, 0x14, 0x9a, 0xeb, 0xfc,
+    0x11, 0xfb, 0x91, 0x6d, 0xb5, 0x88, 0x56, 0xa2, 0x5a, 0x28, 0x5a, 0x13, 0x43, 0xf1, 0x79, 0xba,
+    0x02, 0x83, 0x00, 0xef, 0x9e, 0xb5, 0x00, 0x83, 0x91, 0xc0, 0x9f, 0x76, 0x8d, 0x99, 0x38, 0x15,
+    0x96, 0x22, 0xc2, 0x16, 0x7f, 0x51, 0x98, 0xc1, 0xe9, 0x87, 0xd1, 0xe4, 0xe6, 0xeb, 0xf5, 0xe8,
+    0xf2, 0xd3, 0xc5, 0xf8, 0x1a, 0x16, 0x7a, 0xd4, 0xeb, 0x9d, 0xd4, 0xa6, 0x2f, 0x47, 0xbf, 0x7f,
+    0x3d, 0xbd, 0x84, 0xd9, 0xd7, 0xe5, 0xd9, 0xf1, 0xaf, 0xe3, 0x8f, 0x37, 0x5f, 0x4f, 0xaf, 0x2e,
+    0xae, 0x26, 0x88, 0xfb, 0xe7, 0x21, 0x2c, 0x3d, 0xc6, 0x8a, 0x95, 0x81, 0xa0, 0xaf, 0xe1, 0x05,
+    0xcb, 0x6f, 0x78, 0xfc, 0x11, 0x1e, 0xa1, 0xec, 0xb6, 0x1e, 0x25, 0x72, 0xc0, 0xc0, 0xfc, 0x20,
+    0x11, 0x0f, 0xc0, 0x86, 0x07, 0xe4, 0xf3, 0x97, 0x62, 0x54, 0xb4, 0x09, 0x7e, 0x06, 0x1f, 0x03,
+    0xe3, 0xbd, 0x62, 0xb8, 0x9e, 0x17, 0x0b, 0x49, 0x0b, 0x80, 0x4a, 0x69, 0x25, 0xb1, 0xcb, 0x86,
+    0x40, 0x3d, 0xef, 0x3d, 0xaa, 0xc7, 0xc6, 0x4a, 0xe4, 0xcd, 0xeb, 0xfa, 0x81, 0x98, 0xae, 0xb8,
+    0x90, 0xe7, 0x17, 0x28, 0xb5, 0xdf, 0x8e, 0xd2, 0x94, 0xae, 0x3a, 0x78, 0xc0, 0x6c, 0xa8, 0x55,
+    0xa6, 0x1a, 0xa9, 0x45, 0x5c, 0xdc, 0x4d, 0xb7, 0x83, 0x82, 0x9e, 0x42, 0xa2, 0x30, 0xe2, 0x76,
+    0xcf, 0x31, 0xcc, 0x5a, 0x92, 0xc2, 0x16, 0x1e, 0x50, 0x8a, 0xe0, 0xff, 0x67, 0x94, 0xd3, 0x5f,
+    0xe1, 0xd5, 0x16, 0xe4, 0x3b, 0xd3, 0x25, 0x56, 0x0e, 0x35, 0x04, 0x30, 0x1c, 0x61, 0x66, 0x88,
+    0x88, 0x06, 0x29, 0x64, 0x80, 0xfd, 0xaf, 0xc2, 0x15, 0xcd, 0x8a, 0x1a, 0xf0, 0xa1, 0x01, 0x8c,
+    0x2a, 0x09, 0xa5, 0x4d, 0x95, 0xc1, 0x8e, 0x0e, 0xed, 0xd7, 0xd8, 0x28, 0x59, 0x32, 0x03, 0x1a,
+    0x6d, 0xc3, 0x46, 0x14, 0x5f, 0xe8, 0x0d, 0x7e, 0xfa, 0x52, 0x20, 0x78, 0xdc, 0xdf, 0x37, 0x15,
+    0xa5, 0xc5, 0x88, 0x67, 0x33, 0x08, 0xe6, 0x00, 0xfd, 0x16, 0x0c, 0xd4, 0x27, 0xaf, 0xc8, 0xdb,
+    0x13, 0x03, 0x46, 0x71, 0xde, 0x2f, 0xb3, 0x3e, 0x78, 0x63, 0x4b, 0xb4, 0x1a, 0x7f, 0x42, 0xfc,
+    0x19, 0xb1, 0xcb, 0xab, 0x51, 0x1c, 0xf6, 0xc9, 0x3f, 0x1d, 0xf2, 0x72, 0x50, 0xd8, 0x45, 0x59,
+    0x1a, 0x21, 0x0f, 0xf7, 0xa3, 0x25, 0x33, 0xa9, 0x3d, 0x1a, 0xcf, 0xca, 0xcc, 0x3a, 0xc9, 0x32,
+    0x5b, 0xd8, 0x65, 0x54, 0x29, 0xe6, 0xb1, 0xfa, 0x6d, 0x95, 0xe6, 0x3c, 0xd5, 0x6c, 0x3a, 0xce,
+    0x97, 0x70, 0x6e, 0xac, 0x00, 0xc4, 0x3a, 0x54, 0xab, 0x28, 0xa3, 0xa9, 0x8e, 0xd4, 0x5a, 0xac,
+    0xd7, 0x8d, 0x58, 0xe0, 0xe7, 0x23, 0x7e, 0x4c, 0xd6, 0x28, 0xe0, 0x8d, 0x63, 0x2e, 0xcd, 0x50,
+    0x5b, 0xb1, 0xcc, 0xe2, 0x2c, 0xe9, 0xe5, 0x66, 0x01, 0x84, 0x0b, 0xbb, 0x5d, 0x3a, 0xdc, 0x3b,
+    0x38, 0x5f, 0xb3, 0x19, 0x56, 0xf5, 0x80, 0x86, 0xe9, 0x0d, 0xc9, 0x81, 0x74, 0xc5, 0x22, 0x42,
+    0x09, 0x5f, 0x66, 0xcc, 0x82, 0xcb, 0xea, 0x88, 0xc0, 0x09, 0x81, 0xab, 0xec, 0x9b, 0x05, 0xeb,
+    0x94, 0xde, 0x9f, 0xe2, 0x6e, 0xda, 0x4e, 0xb3, 0xc3, 0x36, 0x00, 0x6a, 0x47, 0x54, 0x35, 0x14,
+    0x07, 0xeb, 0x17, 0x20, 0xfb, 0x8c, 0xf5, 0xf3, 0xc5, 0x1f, 0x00, 0x4b, 0xa2, 0x23, 0x8e, 0x58,
+    0xd6, 0x03, 0xb7, 0xad, 0x43, 0xaf, 0x04, 0xcc, 0x1f, 0x3a, 0x22, 0x7b, 0x81, 0x9c, 0x0e, 0x0e,
+    0x76, 0x8b, 0xc0, 0xbf, 0x0a, 0x49, 0x75, 0xdd, 0xd5, 0x9b, 0xec, 0x5d, 0x1a, 0x98, 0x68, 0xc1,
+    0x5a, 0xf9, 0x2a, 0x4c, 0xf4, 0xc9, 0x61, 0xd9, 0x5a, 0x53, 0xc6, 0x97, 0x69, 0x64, 0x6e, 0x60,
+    0x35, 0x24, 0x63, 0xd3, 0xb7, 0xd8, 0xc5, 0xcf, 0xbd, 0x2f, 0x1d, 0x69, 0x9c, 0xd5, 0xe5, 0x88,
+    0xa4, 0x6c, 0x40, 0x2e, 0x29, 0x5f, 0x40, 0x88, 0x79, 0xd0, 0x9c, 0x3f, 0x57, 0x24, 0x68, 0x93,
+    0x03, 0x4d, 0x01, 0x9e, 0x05, 0xf5, 0x16, 0xa9, 0x3b, 0x15, 0x54, 0x4d, 0x86, 0x6e, 0xcd, 0xce,
+    0x2a, 0xd0, 0x98, 0x0d, 0x08, 0x5e, 0xaf, 0x4a, 0x6a, 0xa8, 0x12, 0x58, 0xa1, 0x6e, 0x43, 0xe1,
+    0x18, 0x4d, 0xf5, 0x00, 0x15, 0x29, 0x21, 0x04, 0xae, 0x5c, 0x54, 0x37, 0x04, 0xad, 0x82, 0x1f,
+    0x35, 0x03, 0x0b, 0xb2, 0x29, 0x05, 0x9a, 0x57, 0x65, 0x42, 0x55, 0x7e, 0xd8, 0x47, 0xc2, 0xd4,
+    0x02, 0x32, 0xb0, 0x38, 0x6d, 0xc9, 0x02, 0xc3, 0x41, 0xf6, 0x25, 0x4f, 0x05, 0x7b, 0x09, 0x99,
+    0x44, 0x7c, 0xcb, 0xae, 0xf1, 0xfe, 0x01, 0x45, 0x44, 0xf0, 0x93, 0x0a, 0xc8, 0x94, 0xcd, 0xfd,
+    0xe8, 0x13, 0x48, 0x67, 0x97, 0x3c, 0x92, 0xd6, 0x24, 0xf8, 0xc6, 0x31, 0xa4, 0x63, 0xb6, 0x0d,
+    0x51, 0xd5, 0x17, 0x3c, 0x7c, 0x1d, 0xff, 0x11, 0x3b, 0x8c, 0xef, 0xd8, 0x4d, 0x6c, 0xc3, 0x0e,
+    0xc0, 0x92, 0x56, 0xb6, 0x90, 0x04, 0x9e, 0x1d, 0xb4, 0x7a, 0x9c, 0x47, 0x49, 0x1b, 0xe7, 0x9d,
+    0x93, 0x46, 0x51, 0x4d, 0x21, 0x1e, 0x4f, 0x5e, 0x94, 0x5d, 0xb4, 0xda, 0x7b, 0xf0, 0xbe, 0x5a,
+    0xbc, 0xb2, 0x7d, 0xa1, 0x0d, 0x9a, 0x11, 0xf9, 0x73, 0xd6, 0x11, 0xae, 0xe5, 0x4b, 0xcd, 0x69,
+    0xd6, 0x54, 0xd3, 0x88, 0x76, 0x52, 0x43, 0x5a, 0xa3, 0x2c, 0x52, 0xd7, 0x45, 0xaf, 0x01, 0xa0,
+    0xa4, 0x8c, 0x75, 0x07, 0x69, 0xbd, 0x3e, 0x4c, 0x8f, 0x57, 0x3c, 0x41, 0xfe, 0x33, 0xd2, 0xde,
+    0x46, 0xdf, 0x00, 0x64, 0xe4, 0x7e, 0xc1, 0x22, 0x4c, 0xae, 0x75, 0xe6, 0x60, 0xf4, 0x4b, 0x8b,
+    0xac, 0x59, 0xdf, 0x1f, 0x00, 0x36, 0x24, 0xdc, 0x99, 0x18, 0xcb, 0xef, 0x0e, 0x3a, 0x26, 0x07,
+    0xcc, 0xd7, 0xb3, 0xa2, 0x83, 0x6a, 0xde, 0x30, 0x78, 0x2c, 0x61, 0x90, 0xb3, 0x83, 0xe3, 0x42,
+    0xf4, 0x28, 0xf6, 0x33, 0xd6, 0x02, 0xf6, 0xbe, 0xbb, 0xc0, 0xac, 0x3e, 0x8a, 0x31, 0xd1, 0x06,
+    0xfe, 0x34, 0x88, 0xa3, 0x79, 0xa7, 0xe4, 0x2e, 0x6a, 0x39, 0x0b, 0x98, 0x55, 0x53, 0xb0, 0x4d,
+    0x60, 0x7f, 0xea, 0x09, 0x90, 0xa9, 0x17, 0x54, 0xac, 0x6d, 0x89, 0xa2, 0x4f, 0x25, 0x5c, 0xe2,
+    0x38, 0x67, 0x1d, 0xbd, 0xc2, 0x57, 0xc4, 0x3e, 0xec, 0xf5, 0xc0, 0x33, 0x27, 0x78, 0xd4, 0xc4,
+    0x73, 0x1b, 0x9e, 0x9d, 0xe7, 0x10, 0x69, 0x1b, 0x44, 0xf6, 0xcb, 0x44, 0x8a, 0x5d, 0x91, 0xc4,
+    0xf0, 0x5e, 0xa6, 0x46, 0xc7, 0x4c, 0x53, 0x14, 0x14, 0x75, 0x6f, 0x0b, 0x30, 0x1d, 0x7a, 0xc1,
+    0x7f, 0xe2, 0x29, 0x2b, 0xf9, 0x85, 0x63, 0x63, 0xde, 0x59, 0x9f, 0xef, 0x63, 0xa2, 0x90, 0xd9,
+    0x78, 0x4d, 0x95, 0x35, 0xd5, 0x3d, 0xa2, 0x01, 0xb4, 0x2d, 0x86, 0x88, 0x4b, 0x2e, 0x43, 0x56,
+    0x89, 0xd6, 0x91, 0xb7, 0x5e, 0x80, 0x2d, 0xa8, 0x1b, 0xae, 0xbe, 0x06, 0x69, 0x16, 0x41, 0x66,
+    0x00, 0x94, 0x88, 0xb9, 0x5f, 0xc1, 0x57, 0xed, 0x5a, 0x14, 0x26, 0x64, 0xaa, 0x36, 0xa6, 0x8e,
+    0x57, 0xa2, 0x59, 0x24, 0x20, 0x3a, 0xd8, 0xb6, 0x11, 0xc5, 0x80, 0x8d, 0xd1, 0x56, 0x0c, 0xa5,
+    0x71, 0xc0, 0x64, 0xfd, 0x03, 0xf8, 0x2d, 0x32, 0xa3, 0x01, 0x9a, 0x9e, 0x70, 0x4f, 0x45, 0xba,
+    0xe4, 0x6c, 0x50, 0x13, 0xde, 0x09, 0x80, 0x37, 0xe2, 0x95, 0xb4, 0x6a, 0xad, 0x5e, 0xca, 0x17,
+    0x96, 0xd5, 0xfc, 0x40, 0xd0, 0xc1, 0xfa, 0x26, 0xc2, 0x93, 0x08, 0xe5, 0xd1, 0xb5, 0xb8, 0xd6,
+    0x3c, 0xc6, 0x07, 0x8c, 0xc9, 0x27, 0xbb, 0x31, 0x90, 0x8d, 0x99, 0x35, 0xc4, 0x45, 0xa7, 0xc5,
+    0x20, 0xaf, 0x7a, 0x2f, 0x30, 0x22, 0x18, 0xc9, 0x37, 0xab, 0x1a, 0x2e, 0x64, 0x3b, 0x24, 0xa7,
+    0x22, 0x5f, 0x75, 0xd7, 0x66, 0x07, 0xb1, 0x4a, 0x2d, 0x9c, 0xaa, 0x64, 0xaa, 0xd7, 0xa2, 0x53,
+    0x30, 0xdc, 0x22, 0xe5, 0x8d, 0x32, 0xab, 0xe4, 0xd4, 0xa0, 0xde, 0x53, 0xb0, 0xe0, 0x80, 0xbe,
+    0x31, 0x2c, 0x66, 0x61, 0xe3, 0xe4, 0xb3, 0xac, 0x18, 0xd5, 0x34, 0xa0, 0x67, 0xb0, 0x43, 0xc7,
+    0x24, 0x07, 0x67, 0xec, 0x9b, 0x5a, 0x34, 0x22, 0xc8, 0xb7, 0x66, 0x14, 0x6b, 0x97, 0x12, 0xdb,
+    0xec, 0x35, 0xad, 0x59, 0x8e, 0x12, 0xf1, 0xaf, 0xbf, 0x9a, 0x84, 0x98, 0x80, 0x99, 0x42, 0x39,
+    0x24, 0x54, 0x2e, 0x9b, 0x53, 0x35, 0x95, 0x2f, 0x64, 0x27, 0x29, 0xd7, 0x39, 0x94, 0xb9, 0xaa,
+    0xb9, 0xb4, 0x83, 0x78, 0x46, 0xa7, 0xa9, 0x2a, 0x9e, 0xa2, 0xab, 0x2c, 0x41, 0xaa, 0x1b, 0xc2,
+    0x21, 0xaa, 0x42, 0x4f, 0xe9, 0x56, 0xa7, 0x98, 0x13, 0x4d, 0xa8, 0xea, 0x36, 0x68, 0xc8, 0xd9,
+    0x32, 0x08, 0x94, 0x52, 0xe1, 0xe9, 0x58, 0x94, 0x6b, 0x88, 0x40, 0x68, 0xca, 0xa4, 0xe7, 0x06,
+    0x30, 0xa8, 0x5a, 0xa5, 0x5e, 0xd7, 0x51, 0xf1, 0x68, 0x08, 0x5e, 0xcd, 0x83, 0xa4, 0xb8, 0x27,
+    0x89, 0x99, 0xc2, 0xe8, 0x49, 0x94, 0x45, 0x3d, 0x5b, 0xd5, 0x6d, 0xd2, 0xbd, 0x1a, 0xad, 0xa9,
+    0x8c, 0xc3, 0x9b, 0xec, 0x08, 0xb4, 0x48, 0x69, 0x70, 0xb2, 0x8c, 0x2a, 0x78, 0xa2, 0xb3, 0x91,
+    0x9f, 0xbc, 0xac, 0x32, 0x2b, 0xfd, 0xa0, 0x9c, 0x96, 0xde, 0xb0, 0xba, 0x4f, 0xa2, 0xe3, 0x9d,
+    0xef, 0x92, 0x78, 0xdb, 0x61, 0x83, 0xe4, 0x47, 0x04, 0xd5, 0xbd, 0xb1, 0x46, 0xd3, 0x78, 0xc9,
+    0xc5, 0xf2, 0x05, 0x40, 0x47, 0xdd, 0xf4, 0xa9, 0xf6, 0x06, 0x1c, 0x10, 0xb9, 0x5f, 0xe1, 0xa8,
+    0xb6, 0x23, 0x12, 0x5e, 0x35, 0xa5, 0x2f, 0xa1, 0x9e, 0xc3, 0x4a, 0xbc, 0xa4, 0xd0, 0x66, 0x90,
+    0x2e, 0x79, 0x53, 0x6f, 0x97, 0x2c, 0x74, 0x30, 0x96, 0x8b, 0x9b, 0xd2, 0xe8, 0x76, 0xcd, 0x16,
+    0x4a, 0x9a, 0x1e, 0x63, 0xc9, 0xb9, 0x07, 0xbe, 0x54, 0x30, 0xc3, 0x37, 0xe2, 0xc3, 0x6b, 0x69,
+    0x9f, 0x9a, 0xdc, 0x27, 0xac, 0x7c, 0xe6, 0xcf, 0x31, 0x2b, 0x83, 0x1f, 0xd3, 0x81, 0x36, 0x76,
+    0x2b, 0x24, 0x58, 0x67, 0x53, 0x20, 0xaf, 0x37, 0x31, 0x14, 0x52, 0x65, 0xe2, 0xa4, 0x29, 0x2d,
+    0x94, 0x8d, 0x77, 0x38, 0x0b, 0x6b, 0x77, 0x2d, 0xff, 0x48, 0xc1, 0xe9, 0xfc, 0x6f, 0x09, 0x4a,
+    0xbc, 0x16, 0xd1, 0x26, 0x4e, 0x47, 0x41, 0x60, 0x5b, 0x02, 0xfd, 0xb3, 0xe8, 0xd6, 0xca, 0xfb,
+    0x83, 0x2f, 0x2d, 0x15, 0x8e, 0x2c, 0xa7, 0x92, 0x65, 0x22, 0x64, 0x47, 0x64, 0xb2, 0xb9, 0x84,
+    0x9f, 0xe5, 0x20, 0x06, 0xa9, 0x52, 0xd6, 0x88, 0xc9, 0x59, 0x90, 0xc5, 0x62, 0x37, 0xc4, 0x6d,
+    0x80, 0xcc, 0xd5, 0x51, 0x4c, 0xdd, 0x8c, 0xaa, 0x51, 0xf6, 0xd8, 0x8c, 0x2e, 0x03, 0xfe, 0xeb,
+    0x4e, 0x0c, 0x74, 0x3d, 0x10, 0x62, 0xae, 0x97, 0xeb, 0x4b, 0xbe, 0xaf, 0xc3, 0xc1, 0xdc, 0x4b,
+    0x4e, 0xe1, 0x72, 0x31, 0x5c, 0xe6, 0x57, 0x26, 0x3f, 0xfc, 0xa0, 0x68, 0x55, 0x33, 0x66, 0x09,
+    0x0f, 0x85, 0x0c, 0x30, 0x91, 0x10, 0xf8, 0x72, 0xd2, 0x04, 0x43, 0x1f, 0x0c, 0x18, 0xfa, 0xd0,
+    0x04, 0x93, 0x71, 0x96, 0x14, 0x40, 0xf8, 0xb6, 0x2d, 0xcb, 0x35, 0xf3, 0x7f, 0x99, 0xbf, 0x3c,
+    0x7b, 0xa7, 0x9b, 0x77, 0xd5, 0x60, 0xa0, 0x2e, 0xaf, 0xb0, 0xca, 0x90, 0xf9, 0x88, 0x1c, 0xa8,
+    0xe9, 0x44, 0x0e, 0xeb, 0xfd, 0x92, 0x3c, 0x18, 0x5a, 0xad, 0x9a, 0x50, 0x26, 0x92, 0x6f, 0xa1,
+    0xa2, 0x56, 0xdb, 0x8f, 0xea, 0x7a, 0xab, 0x67, 0x2d, 0x65, 0xb0, 0x88, 0x8c, 0xdb, 0xf2, 0xfb,
+    0x88, 0x16, 0x59, 0xa6, 0x01, 0x1c, 0x53, 0xca, 0x69, 0x0b, 0x0e, 0xfa, 0xf5, 0xd2, 0x75, 0x59,
+    0x56, 0x92, 0x0d, 0x3b, 0x59, 0x0f, 0x8b, 0x54, 0xf5, 0xdf, 0x7e, 0xbf, 0xbc, 0xf8, 0xc0, 0x79,
+    0x32, 0x51, 0x44, 0x0c, 0x0f, 0x08, 0x30, 0xb0, 0x34, 0x16, 0x99, 0x84, 0x9d, 0xd2, 0x2c, 0xe8,
+    0x51, 0xe1, 0x7d, 0x80, 0x90, 0xce, 0x52, 0xdb, 0x52, 0xde, 0xae, 0x7d, 0x03, 0x96, 0x83, 0x9e,
+    0x89, 0x26, 0x49, 0x00, 0x15, 0x01, 0xca, 0xd9, 0xfd, 0x23, 0xc3, 0xae, 0xc9, 0x49, 0x85, 0x42,
+    0xe4, 0xd9, 0x28, 0x2b, 0xe8, 0x61, 0x40, 0x96, 0x11, 0x28, 0x0b, 0x72, 0x5e, 0x0f, 0x5c, 0x4d,
+    0x84, 0xc1, 0xe7, 0x98, 0xfc, 0xeb, 0xfa, 0xea, 0x23, 0xd6, 0x3a, 0xb0, 0x5d, 0xfe, 0x6c, 0x25,
+    0x40, 0x1d, 0xe7, 0x45, 0x89, 0x06, 0xa4, 0x83, 0x63, 0xac, 0xc7, 0x2e, 0x20, 0xa6, 0xb0, 0x08,
+    0xa5, 0xc0, 0xfb, 0x1c, 0xe0, 0x6e, 0x8b, 0x32, 0xad, 0x56, 0xf8, 0xa2, 0x7d, 0x0b, 0xde, 0xe2,
+    0xbb, 0x30, 0xec, 0x9e, 0x41, 0xaa, 0x5e, 0xdd, 0x3c, 0x1a, 0xb0, 0x94, 0xdb, 0x82, 0xbb, 0xb8,
+    0x01, 0x10, 0x18, 0x70, 0x44, 0x13, 0xd8, 0x68, 0x76, 0x03, 0x7e, 0xdd, 0xe9, 0xb0, 0x34, 0x8d,
+    0xd3, 0x52, 0xf3, 0x89, 0x30, 0x48, 0x31, 0xab, 0x56, 0xa0, 0xb7, 0x60, 0x23, 0x31, 0xa7, 0x79,
+    0xbf, 0x1d, 0x73, 0xc3, 0x77, 0xce, 0x3b, 0xeb, 0x0a, 0x71, 0x61, 0x13, 0x6e, 0xd7, 0x69, 0x44,
+    0xdb, 0xcf, 0xde, 0xa7, 0xab, 0xeb, 0x9b, 0xbd, 0x16, 0xd9, 0xcb, 0xef, 0x99, 0x30, 0xe8, 0xc1,
+    0xc0, 0x9f, 0x2a, 0x69, 0x3d, 0x96, 0x9d, 0xb8, 0x0e, 0xb0, 0x02, 0x11, 0xca, 0xd1, 0x6d, 0xa0,
+    0xd3, 0xd8, 0xc7, 0x56, 0x91, 0x3b, 0x2b, 0xf1, 0x9d, 0x93, 0x1d, 0x16, 0xa0, 0xf3, 0xda, 0xbf,
+    0x5f, 0x78, 0x9d, 0x02, 0x6f, 0x11, 0x5f, 0x25, 0xc7, 0xcf, 0x95, 0x3f, 0xcf, 0x17, 0xff, 0xf6,
+    0x05, 0xe8, 0x14, 0x78, 0xa3, 0xf4, 0x2a, 0xcf, 0x7c, 0xae, 0xf4, 0xc6, 0x95, 0xe4, 0x93, 0x57,
+    0x80, 0xe7, 0x49, 0xb8, 0xb0, 0x34, 0xb4, 0xad, 0x33, 0x70, 0x62, 0x9c, 0x11, 0xfc, 0x9c, 0x52,
+    0x66, 0x87, 0x22, 0x63, 0xfc, 0xa9, 0xea, 0x4e, 0xf3, 0x55, 0x9f, 0x8d, 0x2f, 0xc6, 0x37, 0x63,
+    0x73, 0xdd, 0x08, 0x0f, 0xef, 0xb9, 0x2f, 0xa8, 0xad, 0xc8, 0xf0, 0x84, 0x5b, 0xd7, 0x66, 0x94,
+    0xaa, 0x4d, 0xcb, 0x5a, 0xa8, 0xab, 0x98, 0xc6, 0x75, 0x99, 0x77, 0x2d, 0xe2, 0xd8, 0x9e, 0x47,
+    0xdc, 0x2e, 0x6d, 0x82, 0x6c, 0xac, 0x9d, 0x34, 0xf4, 0x99, 0x3f, 0x7f, 0xd9, 0xd4, 0xd1, 0xdd,
+    0x2a, 0xb6, 0x11, 0xa0, 0xea, 0x52, 0xab, 0x6f, 0x0c, 0xd6, 0x48, 0x2d, 0x05, 0x4c, 0x52, 0xf1,
+    0x7b, 0x26, 0x63, 0x8f, 0xed, 0x94, 0x9c, 0xbf, 0xa6, 0x8e, 0x37, 0x52, 0x8f, 0x9b, 0x93, 0xa5,
+    0xd2, 0x72, 0xbf, 0x27, 0x2b, 0xd2, 0x3c, 0xcd, 0xa4, 0xc3, 0xd4, 0xab, 0x91, 0x35, 0x35, 0x36,
+    0x4c, 0xd6, 0x1e, 0x13, 0x19, 0x3c, 0xf7, 0x5a, 0x39, 0x87, 0x96, 0x91, 0x7c, 0xae, 0x3b, 0x02,
+    0x35, 0xa5, 0xee, 0x9d, 0x5d, 0x5d, 0xaa, 0xe3, 0x74, 0x01, 0xc1, 0x83, 0x79, 0x7b, 0xad, 0x22,
+    0xc0, 0x1a, 0x8d, 0xf6, 0x5c, 0x8c, 0x9f, 0xc7, 0x8d, 0x87, 0x75, 0x93, 0xd5, 0xae, 0xc3, 0xcd,
+    0x57, 0x50, 0x41, 0xd6, 0x4b, 0x78, 0x51, 0x1c, 0xb3, 0x97, 0x2f, 0xe5, 0x57, 0x9f, 0x1d, 0x21,
+    0xfd, 0x75, 0xbc, 0x84, 0x64, 0xd9, 0xd4, 0xf3, 0x1d, 0x4d, 0x49, 0x26, 0x46, 0x55, 0x74, 0x37,
+    0xe0, 0xec, 0xbd, 0xae, 0xd8, 0xcd, 0x6c, 0xcf, 0x31, 0x1a, 0xa7, 0x12, 0xba, 0x41, 0x21, 0x18,
+    0xf9, 0x0d, 0x25, 0xd8, 0xac, 0xde, 0x7a, 0x8b, 0x03, 0xa8, 0xbc, 0xe2, 0xb9, 0x6d, 0x09, 0xd4,
+    0x8c, 0x80, 0xc0, 0x91, 0xc8, 0x71, 0xcc, 0x28, 0xff, 0xa8, 0x3a, 0x2f, 0x3b, 0x31, 0x15, 0x21,
+    0x75, 0x03, 0x57, 0xd4, 0x01, 0xd3, 0xe6, 0x88, 0x6d, 0x84, 0x95, 0xd0, 0x30, 0xc6, 0x70, 0x63,
+    0xa5, 0x9d, 0xab, 0x4f, 0xe3, 0x8f, 0x0d, 0x17, 0x61, 0x35, 0x81, 0xcf, 0xfc, 0xcc, 0x6d, 0x92,
+    0xb9, 0x14, 0x83, 0x1b, 0xe4, 0x87, 0xb4, 0xfd, 0x5a, 0x34, 0x2d, 0xc5, 0x17, 0x7e, 0xf8, 0x15,
+    0x84, 0x22, 0x23, 0xfb, 0xaa, 0x98, 0xba, 0x4f, 0x63, 0x9a, 0xe2, 0x97, 0x0a, 0x11, 0xd6, 0xc9,
+    0x29, 0xc3, 0x3f, 0x1d, 0x30, 0xbf, 0x57, 0xe0, 0x0b, 0x0a, 0xc0, 0x34, 0x23, 0xa1, 0x9f, 0x65,
+    0xcc, 0xdb, 0xae, 0x19, 0xc8, 0x16, 0x56, 0x91, 0xbb, 0x41, 0x35, 0xdf, 0x63, 0x99, 0x4f, 0xdc,
+    0x25, 0x50, 0xe1, 0x06, 0x41, 0xd6, 0x7f, 0xb8, 0x00, 0x68, 0x8e, 0xca, 0x7a, 0xf7, 0x07, 0xb8,
+    0x91, 0x22, 0xf1, 0x83, 0x92, 0xf4, 0xbf, 0xd1, 0xb3, 0x2d, 0x46, 0x7f, 0x54, 0xb1, 0xd9, 0x52,
+    0x39, 0x46, 0x21, 0x38, 0x12, 0x46, 0x0a, 0x26, 0xb9, 0x97, 0xef, 0x34, 0x54, 0xa3, 0x01, 0x60,
+    0xb1, 0x21, 0xa3, 0x5b, 0x0c, 0xf8, 0x9a, 0x96, 0x3a, 0x0b, 0x4f, 0x92, 0x50, 0xfc, 0xf5, 0xc3,
+    0x56, 0xf9, 0x04, 0xd4, 0x56, 0x09, 0xd7, 0xea, 0x56, 0x32, 0xa9, 0x74, 0x1c, 0x4a, 0xf6, 0x6f,
+    0x4d, 0xf4, 0x67, 0x21, 0x02, 0x36, 0xff, 0xd0, 0x42, 0x32, 0x16, 0x2d, 0x04, 0x39, 0x21, 0x07,
+    0xf6, 0x89, 0xec, 0x16, 0x1c, 0x9b, 0x53, 0x61, 0xf3, 0x67, 0x18, 0x47, 0xc5, 0x67, 0x18, 0xcf,
+    0xd4, 0x91, 0xf8, 0xa4, 0x64, 0xbd, 0x8a, 0xf2, 0x4e, 0x4e, 0x5d, 0x3b, 0xcf, 0xb6, 0x1b, 0xfd,
+    0xe5, 0xc7, 0x06, 0xb6, 0xf9, 0x17, 0x11, 0xb5, 0x9d, 0x78, 0x9a, 0x01, 0x88, 0x3a, 0xe3, 0x39,
+    0x27, 0x46, 0x61, 0x96, 0x3f, 0x18, 0x92, 0xc2, 0x34, 0xca, 0x52, 0xca, 0x8d, 0xcc, 0xe1, 0x7e,
+    0x57, 0x7f, 0x60, 0xd5, 0xef, 0xca, 0x3f, 0xae, 0xfa, 0x3f, 0x9d, 0xe8, 0xa6, 0xb5, 0x73, 0x35,
+    0x00, 0x00,
+};
+
+#endif
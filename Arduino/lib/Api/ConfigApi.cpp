@@ -0,0 +1,37 @@
+#include "ConfigApi.h"
+#include <stdio.h>
+#include "JsonReader.h"
+
+bool applyConfig(const char* body, size_t length, Parameters& params, char* error, size_t errorSize) {
+    // Validate into a copy, the live settings only change once the whole body checked out
+    Parameters candidate = params;
+
+    JsonReader reader(body, length);
+    JsonMember member;
+    while (reader.next(member)) {
+        const ParameterField* field = findParameter(member.key, member.keyLength);
+        if (field == NULL) {
+            snprintf(error, errorSize, "unknown setting %.*s", (int) member.keyLength, member.key);
+            return false;
+        }
+        if (member.type != JSON_NUMBER) {
+            snprintf(error, errorSize, "%s must be a number", field->name);
+            return false;
+        }
+        if (!candidate.set(*field, member.number)) {
+            snprintf(error, errorSize, "%s must be between %d and %d", field->name, field->min, field->max);
+            return false;
+        }
+    }
+    if (reader.error() != NULL) {
+        snprintf(error, errorSize, "invalid JSON: %s", reader.error());
+        return false;
+    }
+    if (candidate.minLapTime >= candidate.maxLapTime) {
+        snprintf(error, errorSize, "minLapTime must be below maxLapTime");
+        return false;
+    }
+
+    params = candidate;
+    return true;
+}
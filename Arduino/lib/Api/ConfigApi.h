@@ -0,0 +1,41 @@
+#ifndef ConfigApi_H
+#define ConfigApi_H
+
+#include <stddef.h>
+#include "JsonWriter.h"
+#include "Parameters.h"
+
+/// @brief Write the settings and their schema:
+/// {"delay":100,...,"limits":{"delay":{"type":"number","min":50,"max":500,"step":10,"default":100,"restart":false},...}}
+template <typename Output>
+void writeConfig(JsonWriter<Output>& json, const Parameters& params) {
+    json.beginObject();
+    for (int i = 0; i < PARAMETER_FIELD_COUNT; i++) {
+        json.field(PARAMETER_FIELDS[i].name, params.*PARAMETER_FIELDS[i].value);
+    }
+
+    json.key("limits").beginObject();
+    for (int i = 0; i < PARAMETER_FIELD_COUNT; i++) {
+        const ParameterField& field = PARAMETER_FIELDS[i];
+        json.key(field.name).beginObject()
+            .field("min", field.min)
+            .field("max", field.max)
+            .field("step", field.step)
+            .field("type", field.type == PARAMETER_CHOICE ? "choice" : "number")
+            .field("default", field.defaultValue)
+            .field("restart", field.restartsDetector)
+            .endObject();
+    }
+    json.endObject();
+
+    json.endObject();
+}
+
+/// @brief Apply a settings update such as {"windowSize":30,"logLevel":0}.
+/// Every member is validated before anything changes, so an invalid update leaves params untouched.
+/// Members that are left out keep their value.
+/// @param error Receives the reason when the update is rejected
+/// @return Whether the update was applied
+bool applyConfig(const char* body, size_t length, Parameters& params, char* error, size_t errorSize);
+
+#endif
@@ -0,0 +1,319 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "EventBroadcaster.h"
+#include "Log.h"
+
+const char* const BROADCAST_PRIORITY_NAMES[PRIORITY_COUNT] = { "debug", "telemetry", "log", "state", "critical" };
+
+BroadcastPriority EventBroadcaster::priority(const char* event) {
+    if (strcmp(event, "trigger") == 0 || strcmp(event, "split") == 0)
+        return PRIORITY_CRITICAL;
+    if (strcmp(event, "runs") == 0 || strcmp(event, "status") == 0)
+        return PRIORITY_STATE;
+    if (strcmp(event, "telemetry") == 0)
+        return PRIORITY_TELEMETRY;
+    return PRIORITY_LOG;
+}
+
+bool EventBroadcaster::parseId(const char* text, uint32_t& id) const {
+    char* end;
+    if (strtoul(text, &end, 10) != bootId || end == text || *end != '-')
+        return false;
+    const char* sequence = end + 1;
+    id = strtoul(sequence, &end, 10);
+    return end != sequence && *end == '\0';
+}
+
+bool EventBroadcaster::connect(EventConnection& connection, const char* lastEventId) {
+    Client* client = NULL;
+    for (Client& slot : clientSlots) {
+        if (slot.connection == NULL) {
+            client = &slot;
+            break;
+        }
+    }
+    if (client == NULL)
+        return false;
+
+    client->connection = &connection;
+    client->length = 0;
+    client->offset = 0;
+    clientCount++;
+
+    // A new page loads the current state through the API
+    if (lastEventId == NULL || *lastEventId == '\0')
+        return true;
+
+    // Ids from before a reboot, or a gap the journal cannot fill
+    uint32_t id = 0;
+    if (!parseId(lastEventId, id) || id > nextId || id < journalLostId) {
+        const int index = allocate(PRIORITY_CRITICAL);
+        if (index < 0)
+            return true;
+        Message& message = pool[index];
+        message.id = nextId;
+        message.priority = PRIORITY_CRITICAL;
+        snprintf(message.event, sizeof(message.event), "%s", "resync");
+        message.length = format(message.text, message.id, message.event, "{}");
+        enqueue(*client, index);
+        return true;
+    }
+
+    for (int i = 0; i < journalLength; i++) {
+        if (pool[journal[i]].id > id)
+            enqueue(*client, journal[i]);
+    }
+    return true;
+}
+
+void EventBroadcaster::disconnect(EventConnection& connection) {
+    for (Client& client : clientSlots) {
+        if (client.connection == &connection)
+            clear(client);
+    }
+}
+
+void EventBroadcaster::send(const char* message, const char* event, uint32_t id) {
+    publish(message, event, priority(event));
+}
+
+void EventBroadcaster::sendLog(const char* message, int level, uint32_t id) {
+    publish(message, "log", level <= DEBUG ? PRIORITY_DEBUG : PRIORITY_LOG);
+}
+
+size_t EventBroadcaster::backlog() {
+    if (clientCount == 0)
+        return 0;
+
+    size_t queued = 0;
+    for (const Client& client : clientSlots)
+        queued += client.length;
+    return queued / clientCount;
+}
+
+void EventBroadcaster::pump() {
+    for (Client& client : clientSlots) {
+        EventConnection* connection = client.connection;
+        if (connection == NULL)
+            continue;
+        if (!connection->connected()) {
+            clear(client);
+            continue;
+        }
+
+        while (client.length > 0) {
+            const Message& message = pool[client.queue[0]];
+            const size_t space = connection->space();
+            if (space == 0)
+                break;
+
+            size_t length = message.length - client.offset;
+            if (length > space)
+                length = space;
+            connection->write(message.text + client.offset, length);
+            // A failed write may have closed the connection and freed the slot
+            if (client.connection != connection)
+                break;
+
+            client.offset += length;
+            if (client.offset == message.length) {
+                removeAt(client, 0);
+                client.offset = 0;
+            }
+        }
+    }
+}
+
+void EventBroadcaster::publish(const char* text, const char* event, BroadcastPriority priority) {
+    LatencyTimer timer(clock, latency);
+    const uint32_t id = ++nextId;
+
+    // Nobody to deliver it to, and reconnecting clients do not need it
+    if (clientCount == 0 && priority < PRIORITY_STATE)
+        return;
+
+    const int index = allocate(priority);
+    if (index < 0) {
+        dropCounts[priority]++;
+        return;
+    }
+
+    Message& message = pool[index];
+    message.id = id;
+    message.priority = priority;
+    snprintf(message.event, sizeof(message.event), "%s", event);
+    message.length = format(message.text, id, message.event, text);
+
+    if (priority >= PRIORITY_STATE)
+        addToJournal(index);
+    for (Client& client : clientSlots) {
+        if (client.connection != NULL)
+            enqueue(client, index);
+    }
+}
+
+int EventBroadcaster::allocate(BroadcastPriority priority) {
+    for (;;) {
+        for (int i = 0; i < BROADCAST_POOL_SIZE; i++) {
+            if (pool[i].references == 0)
+                return i;
+        }
+
+        // Take from the client furthest behind, so clients that keep up do not lose anything
+        Client* victim = NULL;
+        int position = -1;
+        for (Client& client : clientSlots) {
+            if (client.connection == NULL || (victim != NULL && client.length <= victim->length))
+                continue;
+            const int droppable = dropCandidate(client, priority);
+            if (droppable >= 0) {
+                victim = &client;
+                position = droppable;
+            }
+        }
+        if (victim != NULL) {
+            dropCounts[pool[victim->queue[position]].priority]++;
+            removeAt(*victim, position);
+            continue;
+        }
+
+        if (priority < PRIORITY_CRITICAL)
+            return -1;
+
+        // The pool is full of triggers and state queued for slow clients. The one furthest behind
+        // catches up from the journal after it reconnects.
+        Client* slowest = NULL;
+        for (Client& client : clientSlots) {
+            if (client.connection != NULL && (slowest == NULL || client.length > slowest->length))
+                slowest = &client;
+        }
+        if (slowest == NULL)
+            return -1;
+        closeClient(*slowest);
+    }
+}
+
+int EventBroadcaster::dropCandidate(const Client& client, uint8_t priority) const {
+    int candidate = -1;
+    // The message being written has to go out whole
+    for (int i = client.offset > 0 ? 1 : 0; i < client.length; i++) {
+        const uint8_t queued = pool[client.queue[i]].priority;
+        if (queued >= PRIORITY_STATE || queued > priority)
+            continue;
+        if (candidate < 0 || queued < pool[client.queue[candidate]].priority)
+            candidate = i;
+    }
+    return candidate;
+}
+
+void EventBroadcaster::addToJournal(int index) {
+    const Message& message = pool[index];
+    int replace = -1;
+    if (message.priority == PRIORITY_STATE) {
+        for (int i = 0; i < journalLength; i++) {
+            const Message& entry = pool[journal[i]];
+            if (entry.priority == PRIORITY_STATE && strcmp(entry.event, message.event) == 0)
+                replace = i;
+        }
+    }
+    if (replace < 0 && journalLength == BROADCAST_JOURNAL_LENGTH) {
+        // Keep the latest state of every name, the oldest trigger goes
+        replace = 0;
+        for (int i = 0; i < journalLength; i++) {
+            if (pool[journal[i]].priority == PRIORITY_CRITICAL) {
+                replace = i;
+                break;
+            }
+        }
+        if (pool[journal[replace]].priority == PRIORITY_CRITICAL)
+            journalLostId = pool[journal[replace]].id;
+    }
+
+    if (replace >= 0) {
+        release(journal[replace]);
+        memmove(journal + replace, journal + replace + 1, journalLength - replace - 1);
+        journalLength--;
+    }
+    journal[journalLength++] = (uint8_t) index;
+    pool[index].references++;
+}
+
+void EventBroadcaster::enqueue(Client& client, int index) {
+    const Message& message = pool[index];
+    // The message being written has to go out whole
+    const int first = client.offset > 0 ? 1 : 0;
+
+    if (message.priority == PRIORITY_STATE) {
+        for (int i = first; i < client.length; i++) {
+            const Message& queued = pool[client.queue[i]];
+            if (queued.priority == PRIORITY_STATE && strcmp(queued.event, message.event) == 0) {
+                removeAt(client, i);
+                coalescedCount++;
+                break;
+            }
+        }
+    }
+
+    if (client.length == BROADCAST_QUEUE_LENGTH) {
+        const int victim = dropCandidate(client, message.priority);
+        if (victim < 0) {
+            if (message.priority == PRIORITY_CRITICAL) {
+                closeClient(client);
+            } else {
+                dropCounts[message.priority]++;
+            }
+            return;
+        }
+        dropCounts[pool[client.queue[victim]].priority]++;
+        removeAt(client, victim);
+    }
+
+    client.queue[client.length++] = (uint8_t) index;
+    pool[index].references++;
+}
+
+void EventBroadcaster::removeAt(Client& client, int position) {
+    release(client.queue[position]);
+    memmove(client.queue + position, client.queue + position + 1, client.length - position - 1);
+    client.length--;
+}
+
+void EventBroadcaster::closeClient(Client& client) {
+    EventConnection* connection = client.connection;
+    slowClosedCount++;
+    // Free the slot first, close() may report the disconnect right away
+    clear(client);
+    connection->close();
+}
+
+void EventBroadcaster::clear(Client& client) {
+    while (client.length > 0)
+        removeAt(client, client.length - 1);
+    client.offset = 0;
+    client.connection = NULL;
+    clientCount--;
+}
+
+uint16_t EventBroadcaster::format(char* out, uint32_t id, const char* event, const char* text) const {
+    // Leaves room for the blank line that ends the message
+    const size_t end = BROADCAST_MESSAGE_SIZE - 2;
+    size_t length = snprintf(out, end, "id: %u-%u\nevent: %s\ndata: ", (unsigned) bootId,
+                             (unsigned) id, event);
+    if (length >= end)
+        length = end - 1;   // snprintf returns what it would have written
+    for (const char* c = text; *c != '\0' && length < end; c++) {
+        if (*c != '\n') {
+            out[length++] = *c;
+        } else if (length + 7 <= end) {
+            // Every line of the payload needs its own data field
+            memcpy(out + length, "\ndata: ", 7);
+            length += 7;
+        } else {
+            break;
+        }
+    }
+    out[length++] = '\n';
+    out[length++] = '\n';
+    return (uint16_t) length;
+}
@@ -0,0 +1,130 @@
+#ifndef EventBroadcaster_H
+#define EventBroadcaster_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Clock.h"
+#include "EventConnection.h"
+#include "EventSink.h"
+#include "Metrics.h"
+
+const int BROADCAST_MAX_CLIENTS = 4;
+const int BROADCAST_MESSAGE_SIZE = 288;         // Wire format including id and event name, a telemetry frame fits
+const int BROADCAST_POOL_SIZE = 16;             // Messages in RAM, shared by all clients
+const int BROADCAST_QUEUE_LENGTH = 12;          // Messages waiting per client
+const int BROADCAST_JOURNAL_LENGTH = 8;         // Triggers and the latest state, replayed to reconnecting clients
+const int BROADCAST_EVENT_NAME_SIZE = 12;
+
+/// @brief Delivery classes, from the first to be dropped to never dropped
+enum BroadcastPriority: uint8_t {
+    PRIORITY_DEBUG = 0,         // DEBUG log messages
+    PRIORITY_TELEMETRY = 1,     // Chart frames
+    PRIORITY_LOG = 2,           // Other log messages
+    PRIORITY_STATE = 3,         // "runs" and "status": a newer one replaces a queued one
+    PRIORITY_CRITICAL = 4,      // "trigger" and "split"
+    PRIORITY_COUNT = 5
+};
+
+/// @brief Lower case class names for metrics, by BroadcastPriority
+extern const char* const BROADCAST_PRIORITY_NAMES[PRIORITY_COUNT];
+
+/// @brief EventSource fan-out with a bounded queue per client.
+///
+/// send() formats a message once into a shared pool and queues a reference to it for every client;
+/// pump() later writes each client's queue as far as its connection takes it. Sending never waits for
+/// a client, so a slow phone only falls behind on its own queue.
+///
+/// A full queue or pool drops the oldest message of the lowest class, DEBUG logs first. A newer state
+/// event replaces a queued one with the same name. Triggers and splits are never dropped: a client
+/// that has a queue full of them is closed instead, and when the browser reconnects with
+/// Last-Event-ID the journal replays what it missed. A client that is too far behind for the journal
+/// gets a "resync" event and reloads the state through the API.
+///
+/// Event ids are "<boot>-<sequence>", numbered by the broadcaster; the id given to send() is ignored.
+/// The boot part tells ids a browser kept from before a reboot apart from this boot's, whose
+/// sequence starts over.
+class EventBroadcaster : public EventSink {
+    public:
+        explicit EventBroadcaster(Clock& clock) : clock(clock) {}
+
+        /// @brief Set the boot part of the event ids, e.g. a random number. Call before the first event.
+        void begin(uint32_t bootId) { this->bootId = bootId; }
+
+        /// @brief Add a client
+        /// @param lastEventId Last-Event-ID of a reconnecting EventSource, NULL or empty for a new one.
+        /// An id of another boot gets a "resync" like one too old for the journal.
+        /// @return false if all client slots are taken
+        bool connect(EventConnection& connection, const char* lastEventId);
+        /// @brief Forget a client, e.g. once its connection closed. Unknown connections are ignored.
+        void disconnect(EventConnection& connection);
+
+        void send(const char* message, const char* event, uint32_t id) override;
+        void sendLog(const char* message, int level, uint32_t id) override;
+        size_t clients() override { return clientCount; }
+        size_t backlog() override;
+
+        /// @brief Write queued messages as far as the connections take them. Call often, e.g. from loop().
+        void pump();
+
+        static BroadcastPriority priority(const char* event);
+
+        /// @return Messages of the class a client did not get
+        uint32_t dropped(BroadcastPriority priority) const { return dropCounts[priority]; }
+        /// @return State events replaced by a newer one before they were sent
+        uint32_t coalesced() const { return coalescedCount; }
+        /// @return Clients closed because they fell behind on triggers
+        uint32_t slowClientsClosed() const { return slowClosedCount; }
+        /// @brief Sequence part of the newest event id
+        uint32_t lastId() const { return nextId; }
+        uint32_t boot() const { return bootId; }
+        /// @brief Time spent queueing messages for the clients
+        const LatencyHistogram& sendLatency() const { return latency; }
+
+    private:
+        struct Message {
+            char text[BROADCAST_MESSAGE_SIZE];      // "id: ...\nevent: ...\ndata: ...\n\n"
+            char event[BROADCAST_EVENT_NAME_SIZE];
+            uint32_t id;
+            uint16_t length;
+            uint8_t priority;
+            uint8_t references;                     // Client queues and the journal holding it, free at 0
+        };
+
+        struct Client {
+            EventConnection* connection = NULL;     // NULL for a free slot
+            uint8_t queue[BROADCAST_QUEUE_LENGTH];  // Pool indices, oldest first
+            int length = 0;
+            size_t offset = 0;                      // Bytes of the first message already written
+        };
+
+        Clock& clock;
+        Message pool[BROADCAST_POOL_SIZE] = {};
+        Client clientSlots[BROADCAST_MAX_CLIENTS];
+        int clientCount = 0;
+        uint8_t journal[BROADCAST_JOURNAL_LENGTH];
+        int journalLength = 0;
+        uint32_t journalLostId = 0;                 // Newest trigger that fell out of the journal
+        uint32_t nextId = 0;
+        uint32_t bootId = 0;
+
+        uint32_t dropCounts[PRIORITY_COUNT] = {};
+        uint32_t coalescedCount = 0;
+        uint32_t slowClosedCount = 0;
+        LatencyHistogram latency;
+
+        void publish(const char* text, const char* event, BroadcastPriority priority);
+        int allocate(BroadcastPriority priority);
+        void addToJournal(int index);
+        void enqueue(Client& client, int index);
+        void removeAt(Client& client, int position);
+        void release(int index) { pool[index].references--; }
+        void closeClient(Client& client);
+        void clear(Client& client);
+        // Queue position of the oldest message of the lowest droppable class up to priority, -1 if none
+        int dropCandidate(const Client& client, uint8_t priority) const;
+        uint16_t format(char* out, uint32_t id, const char* event, const char* text) const;
+        // Sequence of an id of this boot, false for other boots and malformed ids
+        bool parseId(const char* text, uint32_t& id) const;
+};
+
+#endif
@@ -0,0 +1,159 @@
+#include <string.h>
+#include "ConfigStore.h"
+#include "LapStore.h"
+
+static const uint32_t CONFIG_MAGIC = 0x4C544346;   // "LTCF"
+
+struct ConfigHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t length;            // Payload bytes after the header
+    uint32_t crc;               // CRC-32 of the payload
+};
+
+/// @brief Bounds checked cursor over the payload
+class ConfigCursor {
+    public:
+        ConfigCursor(uint8_t* data, size_t size) : data(data), size(size) {}
+
+        bool put(const void* value, size_t length) {
+            if (failed || position + length > size) {
+                failed = true;
+                return false;
+            }
+            memcpy(data + position, value, length);
+            position += length;
+            return true;
+        }
+
+        bool get(void* value, size_t length) {
+            if (failed || position + length > size) {
+                failed = true;
+                return false;
+            }
+            memcpy(value, data + position, length);
+            position += length;
+            return true;
+        }
+
+        const char* text(size_t length) {
+            if (failed || position + length > size) {
+                failed = true;
+                return NULL;
+            }
+            const char* start = (const char*) data + position;
+            position += length;
+            return start;
+        }
+
+        size_t length() const { return position; }
+        bool ok() const { return !failed; }
+
+    private:
+        uint8_t* data;
+        size_t size;
+        size_t position = 0;
+        bool failed = false;
+};
+
+ConfigStore::ConfigStore(Storage& storage, const char* path) : storage(storage), path(path) {}
+
+bool ConfigStore::save(const Parameters& params, const Calibration* calibrations, const bool* valid, int count) {
+    uint8_t buffer[CONFIG_MAX_SIZE];
+    ConfigCursor payload(buffer + sizeof(ConfigHeader), sizeof(buffer) - sizeof(ConfigHeader));
+
+    const uint8_t fields = (uint8_t) PARAMETER_FIELD_COUNT;
+    payload.put(&fields, 1);
+    for (int i = 0; i < PARAMETER_FIELD_COUNT; i++) {
+        const ParameterField& field = PARAMETER_FIELDS[i];
+        const uint8_t nameLength = (uint8_t) strlen(field.name);
+        const int32_t value = params.*field.value;
+        payload.put(&nameLength, 1);
+        payload.put(field.name, nameLength);
+        payload.put(&value, sizeof(value));
+    }
+
+    if (count > CONFIG_MAX_CALIBRATIONS)
+        count = CONFIG_MAX_CALIBRATIONS;
+    const uint8_t gates = (uint8_t) count;
+    payload.put(&gates, 1);
+    for (int i = 0; i < count; i++) {
+        const uint8_t present = valid == NULL || valid[i];
+        payload.put(&present, 1);
+        payload.put(&calibrations[i].meanFixed, sizeof(calibrations[i].meanFixed));
+        payload.put(&calibrations[i].sigmaFixed, sizeof(calibrations[i].sigmaFixed));
+    }
+    if (!payload.ok())
+        return false;
+
+    ConfigHeader header;
+    header.magic = CONFIG_MAGIC;
+    header.version = CONFIG_VERSION;
+    header.length = (uint16_t) payload.length();
+    header.crc = crc32(buffer + sizeof(ConfigHeader), payload.length());
+    memcpy(buffer, &header, sizeof(header));
+
+    return storage.write(path, buffer, sizeof(ConfigHeader) + payload.length());
+}
+
+bool ConfigStore::load(Parameters& params, Calibration* calibrations, bool* valid, int count) {
+    uint8_t buffer[CONFIG_MAX_SIZE];
+    const size_t size = storage.read(path, 0, buffer, sizeof(buffer));
+
+    ConfigHeader header;
+    if (size < sizeof(header))
+        return false;
+    memcpy(&header, buffer, sizeof(header));
+    if (header.magic != CONFIG_MAGIC || header.version != CONFIG_VERSION ||
+        sizeof(header) + header.length > size ||
+        header.crc != crc32(buffer + sizeof(header), header.length)) {
+        return false;
+    }
+
+    // Parse into copies, so a file that turns out malformed changes nothing
+    Parameters loaded = params;
+    ConfigCursor payload(buffer + sizeof(header), header.length);
+
+    uint8_t fields = 0;
+    payload.get(&fields, 1);
+    for (int i = 0; i < fields && payload.ok(); i++) {
+        uint8_t nameLength = 0;
+        int32_t value = 0;
+        payload.get(&nameLength, 1);
+        const char* name = payload.text(nameLength);
+        payload.get(&value, sizeof(value));
+        if (!payload.ok())
+            break;
+
+        // Unknown and out of range settings keep their defaults
+        const ParameterField* field = findParameter(name, nameLength);
+        if (field != NULL)
+            loaded.set(*field, value);
+    }
+    if (loaded.minLapTime >= loaded.maxLapTime) {
+        loaded.minLapTime = params.minLapTime;
+        loaded.maxLapTime = params.maxLapTime;
+    }
+
+    uint8_t gates = 0;
+    payload.get(&gates, 1);
+    Calibration stored[CONFIG_MAX_CALIBRATIONS];
+    bool present[CONFIG_MAX_CALIBRATIONS] = {};
+    for (int i = 0; i < gates && i < CONFIG_MAX_CALIBRATIONS; i++) {
+        uint8_t flag = 0;
+        payload.get(&flag, 1);
+        payload.get(&stored[i].meanFixed, sizeof(stored[i].meanFixed));
+        payload.get(&stored[i].sigmaFixed, sizeof(stored[i].sigmaFixed));
+        present[i] = flag != 0;
+    }
+    if (!payload.ok())
+        return false;
+
+    params = loaded;
+    for (int i = 0; i < count; i++) {
+        valid[i] = i < CONFIG_MAX_CALIBRATIONS && present[i];
+        if (valid[i])
+            calibrations[i] = stored[i];
+    }
+    return true;
+}
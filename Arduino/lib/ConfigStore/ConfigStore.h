@@ -0,0 +1,40 @@
+#ifndef ConfigStore_H
+#define ConfigStore_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Detector.h"
+#include "Parameters.h"
+#include "Storage.h"
+
+const uint16_t CONFIG_VERSION = 1;
+const size_t CONFIG_MAX_SIZE = 512;
+const int CONFIG_MAX_CALIBRATIONS = 8;
+
+/// @brief Settings and gate calibrations as one small file on flash.
+///
+/// Layout: a header with magic, format version, payload length and the CRC-32 of the payload, then
+/// the payload. Settings are stored by name with their value and applied through the Parameters
+/// setters on load, so a firmware with added, removed or re-bounded settings still takes what it
+/// can from an older file. After the settings come one Calibration per gate, with a flag for gates
+/// that had none. A file with a wrong magic, version or CRC, e.g. torn by a power cut, is ignored.
+class ConfigStore {
+    public:
+        ConfigStore(Storage& storage, const char* path);
+
+        /// @brief Load the stored settings into params and the calibrations into calibrations
+        /// @param valid Set for every gate that has a stored calibration
+        /// @param count Gates to load calibrations for, at most CONFIG_MAX_CALIBRATIONS
+        /// @return false if there is no usable file. params and calibrations are untouched then.
+        bool load(Parameters& params, Calibration* calibrations, bool* valid, int count);
+
+        /// @brief Replace the stored file
+        /// @param valid Whether calibration i is set, may be NULL if all are
+        bool save(const Parameters& params, const Calibration* calibrations, const bool* valid, int count);
+
+    private:
+        Storage& storage;
+        const char* path;
+};
+
+#endif
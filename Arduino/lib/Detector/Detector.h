@@ -0,0 +1,23 @@
+#ifndef Detector_H
+#define Detector_H
+
+#include "LapDetector.h"
+
+/// @brief The gate crossing detector of the firmware and every host tool.
+///
+/// Follows the settings, so they can change at runtime; restart() applies window size changes.
+/// Two methods, Parameters::detectionMethod:
+///
+/// - DETECTION_PERCENT: a reading deviates by percentDiffTrigger percent from the rolling window baseline.
+///   A trigger is confirmed when the detection window average deviates as well. The baseline is the
+///   window mean, the window median, or the mean of Hampel filtered readings (baselineEstimator). The
+///   latter two judge the detection window by its median as well, so neither is pulled off by a few
+///   missed echoes.
+/// - DETECTION_STATISTICAL: the baseline is a RunningStats mean and standard deviation, so thresholds
+///   follow the measured noise. Something that stays in the beam for several detections in a row
+///   becomes the new baseline. See ZScoreTrigger.
+///
+/// Integer only, constant time and memory per reading. See LapDetector for the rest.
+typedef LapDetector<ConfiguredBaseline, ConfiguredTrigger, MicrosClock> Detector;
+
+#endif
@@ -0,0 +1,255 @@
+#ifndef DetectorBaselines_H
+#define DetectorBaselines_H
+
+#include <stdint.h>
+#include "DetectorTypes.h"
+#include "HampelFilter.h"
+#include "Parameters.h"
+#include "RollingMedian.h"
+#include "RollingWindow.h"
+#include "RunningStats.h"
+
+// Baseline policies of LapDetector. A baseline keeps the readings: the baseline window, calibrated
+// from the first readings and following the empty beam afterwards, and the detection window that
+// fills while something may be crossing. Every policy is constructed from the Parameters and has
+//
+//     void restart();                     Drop all readings, apply window size changes
+//     void add(int reading);              Reading of the empty beam
+//     bool calibrated() const;            Whether the baseline window is full
+//     int fill() const;
+//     int average() const;                Baseline in cm
+//     uint32_t sigmaFixed() const;        Baseline noise in 1/STATS_ONE cm, 0 if not measured
+//     void seed(const Calibration&);      Fill the baseline from a stored calibration
+//     void addDetection(int reading);
+//     void clearDetection();
+//     int detectionFill() const;
+//     bool detectionFull() const;
+//     int detectionAverage() const;
+//
+// Baselines that measure the noise, as ZScoreTrigger needs, also have int32_t meanFixed().
+
+/// @brief Level of a stored calibration in whole cm
+inline int calibrationLevel(const Calibration& stored) {
+    return (int) ((stored.meanFixed + STATS_ONE / 2) >> STATS_FRACTION_BITS);
+}
+
+/// @brief Rolling window baseline with compile-time window sizes, for the percent method.
+///
+/// BASELINE_MEAN averages the window. BASELINE_MEDIAN takes the median of the raw readings and
+/// BASELINE_HAMPEL the mean of Hampel filtered ones; both judge the detection window by its median,
+/// so neither is pulled off by a few missed echoes. The median storage is only sized for those two.
+/// @tparam WINDOW Baseline window size
+/// @tparam DETECTION Detection window size
+/// @tparam ESTIMATOR A BaselineEstimator
+template <int WINDOW, int DETECTION, int ESTIMATOR>
+class WindowBaseline {
+    static_assert(WINDOW > 0 && WINDOW <= MAX_WINDOW_SIZE, "Baseline window size out of range");
+    static_assert(DETECTION > 0 && DETECTION <= MAX_DETECTION_SIZE, "Detection window size out of range");
+
+    private:
+        static const bool MEDIANS = ESTIMATOR != BASELINE_MEAN;
+
+        RollingWindow<int, WINDOW> window;
+        RollingWindow<int, DETECTION> detection;
+        HampelFilter<int16_t, MEDIANS ? WINDOW : 1> hampel;
+        RollingMedian<int16_t, MEDIANS ? DETECTION : 1> detectionMedian;
+
+    public:
+        explicit WindowBaseline(const Parameters&) {}
+
+        void restart() {
+            window.clear();
+            detection.clear();
+            hampel.clear();
+            detectionMedian.clear();
+        }
+
+        void add(int reading) {
+            if (!MEDIANS) {
+                window.append(reading);
+                return;
+            }
+
+            // The median window sees every raw reading, the mean one only what the Hampel filter let through
+            const int filtered = hampel.filter((int16_t) reading);
+            window.append(ESTIMATOR == BASELINE_HAMPEL ? filtered : reading);
+        }
+
+        bool calibrated() const { return window.isFull(); }
+        int fill() const { return (int) window.size(); }
+
+        int average() const {
+            if (ESTIMATOR == BASELINE_MEDIAN)
+                return hampel.median();
+            // Once calibrated, a division by a constant
+            return window.isFull() ? window.sum() / WINDOW : window.average();
+        }
+
+        uint32_t sigmaFixed() const { return 0; }
+
+        void seed(const Calibration& stored) {
+            window.clear();
+            hampel.clear();
+            while (!window.isFull())
+                add(calibrationLevel(stored));
+        }
+
+        void addDetection(int reading) {
+            detection.append(reading);
+            if (MEDIANS)
+                detectionMedian.append((int16_t) reading);
+        }
+
+        void clearDetection() {
+            detection.clear();
+            detectionMedian.clear();
+        }
+
+        int detectionFill() const { return (int) detection.size(); }
+        bool detectionFull() const { return detection.isFull(); }
+
+        int detectionAverage() const {
+            if (MEDIANS)
+                return detectionMedian.median();
+            return detection.isFull() ? detection.sum() / DETECTION : detection.average();
+        }
+};
+
+template <int WINDOW, int DETECTION>
+using MeanBaseline = WindowBaseline<WINDOW, DETECTION, BASELINE_MEAN>;
+template <int WINDOW, int DETECTION>
+using MedianBaseline = WindowBaseline<WINDOW, DETECTION, BASELINE_MEDIAN>;
+template <int WINDOW, int DETECTION>
+using HampelBaseline = WindowBaseline<WINDOW, DETECTION, BASELINE_HAMPEL>;
+
+/// @brief RunningStats mean and standard deviation with compile-time window sizes, for the
+/// statistical method. The detection window is judged by its mean.
+/// @tparam WINDOW Readings to calibrate from, also the averaging length afterwards
+/// @tparam DETECTION Detection window size
+template <int WINDOW, int DETECTION>
+class StatsBaseline {
+    static_assert(WINDOW > 0 && WINDOW <= MAX_WINDOW_SIZE, "Baseline window size out of range");
+    static_assert(DETECTION > 0 && DETECTION <= MAX_DETECTION_SIZE, "Detection window size out of range");
+
+    private:
+        RunningStats stats;
+        RollingWindow<int, DETECTION> detection;
+
+    public:
+        explicit StatsBaseline(const Parameters&) : stats(WINDOW) {}
+
+        void restart() {
+            stats.clear();
+            detection.clear();
+        }
+
+        void add(int reading) { stats.add(reading); }
+        bool calibrated() const { return stats.isFull(); }
+        int fill() const { return stats.fill(); }
+        int average() const { return stats.average(); }
+        int32_t meanFixed() const { return stats.meanFixed(); }
+        uint32_t sigmaFixed() const { return stats.sigmaFixed(); }
+        void seed(const Calibration& stored) { stats.seed(stored.meanFixed, stored.sigmaFixed); }
+
+        void addDetection(int reading) { detection.append(reading); }
+        void clearDetection() { detection.clear(); }
+        int detectionFill() const { return (int) detection.size(); }
+        bool detectionFull() const { return detection.isFull(); }
+        int detectionAverage() const { return detection.isFull() ? detection.sum() / DETECTION : detection.average(); }
+};
+
+/// @brief The baseline chosen by the settings: windowSize, detectionSize, baselineEstimator and
+/// detectionMethod, the statistical method using RunningStats. Storage for every estimator at the
+/// maximum window sizes, so the settings can change at runtime; restart() applies them.
+class ConfiguredBaseline {
+    private:
+        const Parameters& params;
+        RollingWindow<int, MAX_WINDOW_SIZE> window;
+        RollingWindow<int, MAX_DETECTION_SIZE> detection;
+        // Only fed for the median and Hampel estimators
+        HampelFilter<int16_t, MAX_WINDOW_SIZE> hampel;
+        RollingMedian<int16_t, MAX_DETECTION_SIZE> detectionMedian;
+        RunningStats stats;
+
+        bool statistical() const { return params.detectionMethod == DETECTION_STATISTICAL; }
+
+        void addToWindow(int reading) {
+            if (params.baselineEstimator == BASELINE_MEAN) {
+                window.append(reading);
+                return;
+            }
+
+            // The median window sees every raw reading, the mean one only what the Hampel filter let through
+            const int filtered = hampel.filter((int16_t) reading);
+            window.append(params.baselineEstimator == BASELINE_HAMPEL ? filtered : reading);
+        }
+
+    public:
+        explicit ConfiguredBaseline(const Parameters& params) :
+            params(params),
+            window(params.windowSize),
+            detection(params.detectionSize),
+            hampel(params.windowSize),
+            stats(params.windowSize) {}
+
+        void restart() {
+            detection.clear();
+            detection.resize(params.detectionSize);
+            detectionMedian.resize(params.detectionSize);
+            window.clear();
+            window.resize(params.windowSize);
+            hampel.resize(params.windowSize);
+            stats.resize(params.windowSize);
+            stats.clear();
+        }
+
+        void add(int reading) {
+            if (statistical())
+                stats.add(reading);
+            else
+                addToWindow(reading);
+        }
+
+        bool calibrated() const { return statistical() ? stats.isFull() : window.isFull(); }
+        int fill() const { return statistical() ? stats.fill() : (int) window.size(); }
+
+        int average() const {
+            if (statistical())
+                return stats.average();
+            return params.baselineEstimator == BASELINE_MEDIAN ? hampel.median() : window.average();
+        }
+
+        int32_t meanFixed() const { return stats.meanFixed(); }
+        uint32_t sigmaFixed() const { return statistical() ? stats.sigmaFixed() : 0; }
+
+        void seed(const Calibration& stored) {
+            if (statistical()) {
+                stats.seed(stored.meanFixed, stored.sigmaFixed);
+                return;
+            }
+            window.clear();
+            hampel.clear();
+            while (!window.isFull())
+                addToWindow(calibrationLevel(stored));
+        }
+
+        void addDetection(int reading) {
+            detection.append(reading);
+            if (params.baselineEstimator != BASELINE_MEAN)
+                detectionMedian.append((int16_t) reading);
+        }
+
+        void clearDetection() {
+            detection.clear();
+            detectionMedian.clear();
+        }
+
+        int detectionFill() const { return (int) detection.size(); }
+        bool detectionFull() const { return detection.isFull(); }
+
+        int detectionAverage() const {
+            return params.baselineEstimator == BASELINE_MEAN ? detection.average() : detectionMedian.median();
+        }
+};
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef DetectorTriggers_H
+#define DetectorTriggers_H
+
+#include <stdint.h>
+#include "DetectorTypes.h"
+#include "Parameters.h"
+
+// Trigger policies of LapDetector decide which readings deviate from the baseline and which
+// detections are crossings. Scores are in the units of the method, e.g. percent. Every policy is
+// constructed from the Parameters and has
+//
+//     void restart();
+//     int threshold() const;                          A score at least this high deviates
+//     bool learnsDeviating() const;                   Whether deviating readings go into the baseline
+//     bool accepts(const Calibration&) const;         Whether a stored calibration can be warm started
+//     bool agrees(const Calibration&, int reading) const;
+//     void rate(const Baseline&, Result&) const;      Score result.reading against the baseline
+//     int score(const Result&) const;                 The score rate() stored
+//     bool deviates(int score, bool detecting);
+//     void startDetection();
+//     void addDetection(int score);
+//     bool confirm(const Baseline&, Result&);         Judge a full detection window
+
+/// @brief How clearly the detection cleared the threshold: 500 right at it, 1000 at twice of it
+inline uint16_t triggerConfidence(long value, long threshold) {
+    const long confidence = 500L * value / threshold;
+    return confidence > 1000 ? 1000 : (uint16_t) confidence;
+}
+
+/// @brief A reading deviates by percentDiffTrigger percent from the baseline. A trigger is confirmed
+/// when the detection window average deviates as well. Deviating readings go into the baseline window.
+class PercentTrigger {
+    private:
+        const Parameters& params;
+
+    public:
+        explicit PercentTrigger(const Parameters& params) : params(params) {}
+
+        void restart() {}
+        int threshold() const { return params.percentDiffTrigger; }
+        bool learnsDeviating() const { return true; }
+        bool accepts(const Calibration&) const { return true; }
+
+        /// @brief Within half the threshold of the stored baseline, the same margin that starts burst ranging
+        bool agrees(const Calibration& stored, int reading) const {
+            return percentDifference((int32_t) reading * STATS_ONE, stored.meanFixed) * 2 < threshold();
+        }
+
+        template <class Baseline>
+        void rate(const Baseline&, DetectorTypes::Result& result) const {
+            result.percentDiff = percentDifference(result.reading, result.average);
+        }
+
+        int score(const DetectorTypes::Result& result) const { return result.percentDiff; }
+        bool deviates(int score, bool) const { return score >= threshold(); }
+        void startDetection() {}
+        void addDetection(int) {}
+
+        template <class Baseline>
+        bool confirm(const Baseline& baseline, DetectorTypes::Result& result) const {
+            result.percentDiff = percentDifference(result.detectionAverage, baseline.average());
+            result.confidence = triggerConfidence(result.percentDiff, threshold());
+            return result.percentDiff > threshold();
+        }
+};
+
+/// @brief Thresholds follow the measured noise of the baseline. A reading deviates at zScoreTrigger
+/// standard deviations, or when a CUSUM of the z-scores reaches that much. Each z-score is clipped
+/// to zScoreTrigger, so a single wild reading counts like any other deviating one. A trigger is
+/// confirmed when the clipped CUSUM over the detection window reaches half of its maximum, i.e.
+/// about half the window deviated. Deviating readings stay out of the baseline, a single bike would
+/// inflate the noise estimate for a long time. Needs a baseline with meanFixed().
+class ZScoreTrigger {
+    private:
+        const Parameters& params;
+        int32_t cusum = 0;          // Hundredths of a standard deviation
+
+        int32_t clipped(int score) const {
+            return (score < threshold() ? score : threshold()) - DETECTOR_CUSUM_SLACK;
+        }
+
+        void accumulate(int score) {
+            const int32_t sum = cusum + clipped(score);
+            cusum = sum > 0 ? sum : 0;
+        }
+
+        // Readings are whole cm, a perfectly steady baseline must not make every 1 cm step a deviation
+        static uint32_t floored(uint32_t sigma) {
+            return sigma < (uint32_t) STATS_ONE ? STATS_ONE : sigma;
+        }
+
+        static int zScore(int32_t meanFixed, uint32_t sigmaFixed, int value) {
+            const int32_t deviation = (int32_t) value * STATS_ONE - meanFixed;
+            const uint32_t magnitude = (uint32_t) (deviation < 0 ? -deviation : deviation);
+            return (int) ((uint64_t) magnitude * 100 / floored(sigmaFixed));
+        }
+
+    public:
+        explicit ZScoreTrigger(const Parameters& params) : params(params) {}
+
+        void restart() { cusum = 0; }
+        int threshold() const { return params.zScoreTrigger * 100; }
+        bool learnsDeviating() const { return false; }
+        /// @brief The thresholds need the noise level as well
+        bool accepts(const Calibration& stored) const { return stored.sigmaFixed != 0; }
+
+        bool agrees(const Calibration& stored, int reading) const {
+            return zScore(stored.meanFixed, stored.sigmaFixed, reading) * 2 < threshold();
+        }
+
+        template <class Baseline>
+        void rate(const Baseline& baseline, DetectorTypes::Result& result) const {
+            result.zScore = zScore(baseline.meanFixed(), baseline.sigmaFixed(), result.reading);
+        }
+
+        int score(const DetectorTypes::Result& result) const { return result.zScore; }
+
+        bool deviates(int score, bool detecting) {
+            if (!detecting)
+                accumulate(score);
+            return score >= threshold() || cusum >= threshold();
+        }
+
+        void startDetection() { cusum = 0; }
+        void addDetection(int score) { accumulate(score); }
+
+        template <class Baseline>
+        bool confirm(const Baseline& baseline, DetectorTypes::Result& result) {
+            // Half the window at full strength
+            const long required = (long) baseline.detectionFill() * (threshold() - DETECTOR_CUSUM_SLACK) / 2;
+            const bool isTrigger = cusum >= required;
+            result.confidence = triggerConfidence(cusum, required);
+            result.zScore = zScore(baseline.meanFixed(), baseline.sigmaFixed(), result.detectionAverage);
+            cusum = 0;
+            return isTrigger;
+        }
+};
+
+/// @brief PercentTrigger or ZScoreTrigger, as Parameters::detectionMethod says at the time
+class ConfiguredTrigger {
+    private:
+        const Parameters& params;
+        PercentTrigger percent;
+        ZScoreTrigger statistical;
+
+        bool isStatistical() const { return params.detectionMethod == DETECTION_STATISTICAL; }
+
+    public:
+        explicit ConfiguredTrigger(const Parameters& params) : params(params), percent(params), statistical(params) {}
+
+        void restart() { statistical.restart(); }
+        int threshold() const { return isStatistical() ? statistical.threshold() : percent.threshold(); }
+        bool learnsDeviating() const { return !isStatistical(); }
+        bool accepts(const Calibration& stored) const { return isStatistical() ? statistical.accepts(stored) : true; }
+
+        bool agrees(const Calibration& stored, int reading) const {
+            return isStatistical() ? statistical.agrees(stored, reading) : percent.agrees(stored, reading);
+        }
+
+        template <class Baseline>
+        void rate(const Baseline& baseline, DetectorTypes::Result& result) const {
+            if (isStatistical())
+                statistical.rate(baseline, result);
+            else
+                percent.rate(baseline, result);
+        }
+
+        int score(const DetectorTypes::Result& result) const { return isStatistical() ? result.zScore : result.percentDiff; }
+
+        bool deviates(int score, bool detecting) {
+            return isStatistical() ? statistical.deviates(score, detecting) : percent.deviates(score, detecting);
+        }
+
+        void startDetection() { statistical.startDetection(); }
+
+        void addDetection(int score) {
+            if (isStatistical())
+                statistical.addDetection(score);
+        }
+
+        template <class Baseline>
+        bool confirm(const Baseline& baseline, DetectorTypes::Result& result) {
+            return isStatistical() ? statistical.confirm(baseline, result) : percent.confirm(baseline, result);
+        }
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef DetectorTypes_H
+#define DetectorTypes_H
+
+#include <stdint.h>
+#include "RunningStats.h"
+
+// Statistical method: CUSUM slack, deviations up to this many hundredths of a standard deviation count as noise
+const int DETECTOR_CUSUM_SLACK = 100;
+// Statistical method: detections without a baseline reading in between before the baseline is calibrated anew
+const int DETECTOR_MAX_DETECTIONS_IN_A_ROW = 3;
+
+// Fresh readings that have to agree with a stored calibration before it is used
+const int DETECTOR_WARM_START_READINGS = 3;
+// Weight of each baseline reading in the slowly tracked calibration, 1 / 2^DETECTOR_DRIFT_SHIFT
+const int DETECTOR_DRIFT_SHIFT = 8;
+
+/// @brief Baseline of a calibrated detector, kept across restarts and reboots
+struct Calibration {
+    int32_t meanFixed;          // 1/STATS_ONE cm
+    uint32_t sigmaFixed;        // 1/STATS_ONE cm, 0 unless measured by the statistical method
+};
+
+/// @brief Symmetric percent difference between two values, 0 if both are 0. Integer only, both
+/// values just need the same unit, e.g. cm or 1/STATS_ONE cm.
+inline int percentDifference(int32_t lhs, int32_t rhs) {
+    const int64_t sum = (int64_t) lhs + rhs;
+    if (sum == 0)
+        return 0;
+
+    const int64_t difference = (int64_t) lhs - rhs;
+    return (int) ((difference < 0 ? -difference : difference) * 200 / sum);
+}
+
+/// @brief Events and results shared by every LapDetector instantiation
+struct DetectorTypes {
+    enum Event {
+        NONE,               // Reading went into the baseline window
+        CALIBRATING,        // Baseline window not full yet
+        POTENTIAL_TRIGGER,  // Reading deviated, detection phase started
+        DETECTING,          // Filling the detection window
+        FLUKE,              // Detection window did not confirm the trigger
+        TRIGGER,            // Confirmed gate crossing
+        TIMEOUT             // No echo. Kept out of both windows, a running detection waits for the next reading.
+    };
+
+    struct Result {
+        Event event;
+        int reading;
+        int average;            // Baseline average
+        int percentDiff;        // Percent method: reading vs. baseline, or detection average vs. baseline once detection completes
+        int zScore;             // Statistical method: the same in hundredths of a standard deviation
+        int detectionAverage;   // Only set when detection completes. The median with the median and Hampel estimators.
+        uint32_t crossingMicros;    // Only set for TRIGGER, gate entry
+        uint16_t confidence;        // Only set for TRIGGER, 0-1000. 500 is a detection right at the threshold.
+    };
+};
+
+#endif
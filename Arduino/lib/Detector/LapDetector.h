@@ -0,0 +1,334 @@
+#ifndef LapDetector_H
+#define LapDetector_H
+
+#include <stdint.h>
+#include "DetectorBaselines.h"
+#include "DetectorTriggers.h"
+#include "DetectorTypes.h"
+#include "Parameters.h"
+#include "Ranger.h"
+
+/// @brief Sample timestamps in usec, wrapping like micros() on the board
+struct MicrosClock {
+    typedef uint32_t Time;
+    static uint32_t micros(Time time) { return time; }
+};
+
+/// @brief Sample timestamps in msec, e.g. millis(). Crossings are still reported in usec.
+struct MillisClock {
+    typedef uint32_t Time;
+    static uint32_t micros(Time time) { return time * 1000; }
+};
+
+/// @brief One ranging result
+/// @tparam Time Timestamp type of the clock policy
+template <typename Time>
+struct DetectorSample {
+    int distance;       // cm, or RANGER_TIMEOUT
+    Time time;          // When the reading was taken (the ping, not the echo)
+};
+
+/// @brief Gate crossing detector. Pairing crossings into laps is up to LapTimer.
+///
+/// Calibrates a baseline from the first readings, starts a detection phase when a reading deviates
+/// from the baseline and confirms or rejects a trigger once the detection window is full. The
+/// policies fill in the details:
+///
+/// - BaselinePolicy keeps the baseline and detection windows (DetectorBaselines.h). MeanBaseline,
+///   MedianBaseline, HampelBaseline and StatsBaseline take the window sizes as template arguments,
+///   so all buffers are static arrays of exactly that size. ConfiguredBaseline follows the settings.
+/// - TriggerPolicy scores readings against the baseline and judges the detection window
+///   (DetectorTriggers.h): PercentTrigger, ZScoreTrigger (needs StatsBaseline) or ConfiguredTrigger.
+/// - ClockPolicy converts sample timestamps to usec: MicrosClock or MillisClock.
+///
+/// The firmware and the host tools all use Detector, the configured instantiation. A build that
+/// never changes the detector settings can pick fixed policies instead, e.g.
+/// LapDetector<MeanBaseline<20, 5>, PercentTrigger, MicrosClock>, which leaves integer code with
+/// constant loop bounds and divisors.
+///
+/// Every trigger is stamped with the moment the bike entered the beam, linearly interpolated between
+/// the last reading below and the first reading above the threshold. Both ends of a lap are stamped
+/// the same way, so the lap time does not depend on the detection window length and resolves
+/// well below one ranging interval.
+///
+/// A calibration from before a restart or reboot can be handed to warmStart(). Once the first
+/// DETECTOR_WARM_START_READINGS readings agree with it, it replaces the calibration phase. Meanwhile
+/// the baseline is followed by a slow exponential average (DETECTOR_DRIFT_SHIFT), so a stored
+/// calibration keeps up with temperature drift over the day and stays independent of the window size.
+///
+/// Readings need not be evenly spaced: ranging speeds up while something is in the beam. The detector
+/// keeps a running average of the spacing, and only interpolates across gaps of at most twice the
+/// longer of that and the idle interval.
+///
+/// Pings without an echo (RANGER_TIMEOUT) come out as TIMEOUT and leave the windows alone; GateRanging
+/// counts them.
+///
+/// All state is in the object, policies included. Pure logic: no I/O, no allocation, time is passed
+/// in with the samples.
+template <class BaselinePolicy, class TriggerPolicy, class ClockPolicy>
+class LapDetector : public DetectorTypes {
+    public:
+        typedef typename ClockPolicy::Time Time;
+        typedef DetectorSample<Time> Sample;
+
+        explicit LapDetector(const Parameters& params) : params(params), baseline(params), trigger(params) {}
+
+        /// @brief Feed one reading
+        /// @return What the reading did, result() has the details
+        Event step(const Sample& sample) {
+            const int reading = sample.distance;
+            const uint32_t nowMicros = ClockPolicy::micros(sample.time);
+            trackInterval(nowMicros);
+
+            last = {};
+            last.event = NONE;
+            last.reading = reading;
+
+            // A missed echo says nothing about the distance, so it must not pull the baseline or decide a detection
+            if (reading == RANGER_TIMEOUT) {
+                last.event = TIMEOUT;
+                last.average = baseline.average();
+                return last.event;
+            }
+
+            // we must allow window to fill in order for our average calculation to be useful
+            if (!baseline.calibrated()) {
+                // Calibrate as usual meanwhile, in case the stored baseline does not hold
+                baseline.add(reading);
+                if (warmPending) {
+                    warmPending = trigger.agrees(warmCalibration, reading);
+                    if (warmPending && ++warmConfirmed == DETECTOR_WARM_START_READINGS) {
+                        warmPending = false;
+                        seedBaseline();
+                    }
+                }
+                last.event = CALIBRATING;
+                last.average = baseline.average();
+                // The slow baseline starts where the calibration ended
+                if (baseline.calibrated() && !hasDrift)
+                    trackDrift(last.average);
+                return last.event;
+            }
+
+            last.average = baseline.average();
+            trigger.rate(baseline, last);
+            const int score = trigger.score(last);
+            const bool deviates = trigger.deviates(score, runDetection);
+
+            const uint32_t entry = entryMicros(nowMicros, score);
+            hasPrevious = true;
+            previousMicros = nowMicros;
+            previousScore = score;
+
+            if (!runDetection) {
+                if (!deviates || trigger.learnsDeviating())
+                    baseline.add(reading);
+                if (!deviates) {
+                    detectionsInARow = 0;
+                    trackDrift(reading);
+                }
+            }
+
+            if (!runDetection && deviates) {
+                runDetection = true;
+                trigger.startDetection();
+                // Without a single baseline reading in between, something new is standing in the beam.
+                // A baseline that takes in deviating readings adapts by itself.
+                if (!trigger.learnsDeviating() && ++detectionsInARow > DETECTOR_MAX_DETECTIONS_IN_A_ROW) {
+                    baseline.restart();
+                    restartBaseline();
+                    last.event = CALIBRATING;
+                    return last.event;
+                }
+            }
+
+            if (!runDetection)
+                return last.event;
+
+            if (baseline.detectionFill() == 0) {
+                // Initial measurement. Start rolling window to see if we actually have a trigger
+                potentialTriggerMicros = entry;
+                addDetection(score);
+                last.event = POTENTIAL_TRIGGER;
+                return last.event;
+            } else if (!baseline.detectionFull()) {
+                // Still need to fill detection window...
+                addDetection(score);
+                last.event = DETECTING;
+                return last.event;
+            }
+
+            // Window is full...Check if conditions are right for a trigger
+            runDetection = false;
+            last.detectionAverage = baseline.detectionAverage();
+            const bool isTrigger = trigger.confirm(baseline, last);
+            // We must clear the detection window so we do not immediately register the next close reading as a trigger
+            baseline.clearDetection();
+
+            if (isTrigger) {
+                last.event = TRIGGER;
+                last.crossingMicros = potentialTriggerMicros;
+            } else {
+                // fluke, discard potential trigger
+                last.event = FLUKE;
+                last.confidence = 0;
+            }
+            potentialTriggerMicros = 0;
+            return last.event;
+        }
+
+        /// @brief Details of the last step()
+        const Result& result() const { return last; }
+
+        /// @brief step() for callers that want the details right away
+        Result update(int reading, Time time) {
+            step({ reading, time });
+            return last;
+        }
+
+        /// @brief Whether something is in or near the beam: a detection is running, or the reading
+        /// differed from the baseline by at least half of the threshold. Ranging should speed up.
+        bool deviating(const Result& result) const {
+            if (result.event == POTENTIAL_TRIGGER || result.event == DETECTING)
+                return true;
+            if (result.event == TIMEOUT)
+                return runDetection;
+            return result.event == NONE && trigger.score(result) * 2 >= trigger.threshold();
+        }
+
+        /// @brief Drop calibration and any detection in progress. Applies window size changes.
+        void restart() {
+            baseline.restart();
+            restartBaseline();
+            potentialTriggerMicros = 0;
+            hasLast = false;
+            intervalMicros = 0;
+        }
+
+        /// @brief Use a stored calibration if the next few readings confirm it. Call after restart().
+        void warmStart(const Calibration& stored) {
+            if (!trigger.accepts(stored))
+                return;
+
+            warmCalibration = stored;
+            warmPending = true;
+            warmConfirmed = 0;
+        }
+
+        /// @brief The slowly tracked baseline
+        /// @return false while not calibrated
+        bool calibration(Calibration& out) const {
+            if (!hasDrift)
+                return false;
+
+            out.meanFixed = driftMean;
+            out.sigmaFixed = baseline.sigmaFixed();
+            return true;
+        }
+
+        /// @brief Whether the current calibration came from warmStart()
+        bool warmStarted() const { return warm; }
+
+        int windowFill() const { return baseline.fill(); }
+        int detectionFill() const { return baseline.detectionFill(); }
+        /// @brief Average time between readings, 0 until there were two
+        uint32_t sampleIntervalMicros() const { return intervalMicros; }
+
+    private:
+        const Parameters& params;
+        BaselinePolicy baseline;
+        TriggerPolicy trigger;
+        Result last = {};
+        int detectionsInARow = 0;
+
+        bool hasDrift = false;
+        int32_t driftMean = 0;      // 1/STATS_ONE cm
+
+        bool warmPending = false;
+        bool warm = false;
+        int warmConfirmed = 0;
+        Calibration warmCalibration = {};
+
+        bool runDetection = false;
+        uint32_t potentialTriggerMicros = 0;
+
+        // Previous reading, for interpolating the threshold crossing
+        bool hasPrevious = false;
+        uint32_t previousMicros = 0;
+        int previousScore = 0;
+
+        // Spacing of the readings, a running average that skips holdoffs and pauses
+        bool hasLast = false;
+        uint32_t lastMicros = 0;
+        uint32_t intervalMicros = 0;
+
+        // Everything but the readings, which the caller drops from the baseline policy
+        void restartBaseline() {
+            runDetection = false;
+            trigger.restart();
+            detectionsInARow = 0;
+            hasPrevious = false;
+            hasDrift = false;
+            warmPending = false;
+            warm = false;
+        }
+
+        void addDetection(int score) {
+            baseline.addDetection(last.reading);
+            trigger.addDetection(score);
+        }
+
+        void trackDrift(int reading) {
+            const int32_t value = (int32_t) reading * STATS_ONE;
+            if (!hasDrift) {
+                driftMean = value;
+                hasDrift = true;
+                return;
+            }
+            driftMean += (value - driftMean) / (1 << DETECTOR_DRIFT_SHIFT);
+        }
+
+        void seedBaseline() {
+            baseline.seed(warmCalibration);
+            driftMean = warmCalibration.meanFixed;
+            hasDrift = true;
+            warm = true;
+        }
+
+        uint32_t maxGapMicros() const {
+            const uint32_t idle = (uint32_t) params.delay * 1000;
+            return 2 * (intervalMicros > idle ? intervalMicros : idle);
+        }
+
+        void trackInterval(uint32_t nowMicros) {
+            const uint32_t gap = nowMicros - lastMicros;
+            const bool consecutive = hasLast && gap <= maxGapMicros();
+            hasLast = true;
+            lastMicros = nowMicros;
+            if (!consecutive)
+                return;
+
+            // Moving average over ~8 readings
+            if (intervalMicros == 0)
+                intervalMicros = gap;
+            else
+                intervalMicros = (uint32_t) ((int32_t) intervalMicros + ((int32_t) gap - (int32_t) intervalMicros) / 8);
+        }
+
+        uint32_t entryMicros(uint32_t nowMicros, int score) const {
+            const uint32_t gap = nowMicros - previousMicros;
+            const int threshold = trigger.threshold();
+
+            // Only interpolate between consecutive readings, not across a holdoff or a pause in ranging.
+            // A detection started by the CUSUM alone has no single crossing to interpolate.
+            if (!hasPrevious || score < threshold || previousScore >= threshold || gap > maxGapMicros()) {
+                return nowMicros;
+            }
+
+            // score >= threshold > previousScore, so this is a fraction of the gap
+            const uint64_t numerator = (uint64_t) gap * (uint32_t) (threshold - previousScore);
+            return previousMicros + (uint32_t) (numerator / (uint32_t) (score - previousScore));
+        }
+};
+
+#endif
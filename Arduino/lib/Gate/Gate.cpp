@@ -0,0 +1,95 @@
+#include "Gate.h"
+
+GateRanging::GateRanging(Clock& clock, const Parameters& params, Gate* gates, int count) :
+    clock(clock),
+    params(params),
+    gates(gates),
+    count(count),
+    intervalMicros(idleIntervalMicros()) {
+    int splits = 0;
+    for (int i = 0; i < count; i++) {
+        if (gates[i].role == LapTimer::SPLIT)
+            gates[i].split = splits++;
+    }
+}
+
+uint32_t GateRanging::idleIntervalMicros() const {
+    const uint32_t interval = (uint32_t) params.delay * 1000;
+    return interval < burstIntervalMicros() ? burstIntervalMicros() : interval;
+}
+
+bool GateRanging::burst() {
+    if (params.burstHold == 0)
+        return false;
+
+    lastBurstMillis = clock.millis();
+    if (intervalMicros == burstIntervalMicros())
+        return false;
+    intervalMicros = burstIntervalMicros();
+    return true;
+}
+
+void GateRanging::decay() {
+    const uint32_t idle = idleIntervalMicros();
+    if (intervalMicros < idle && params.burstHold > 0 && clock.millis() - lastBurstMillis < (uint32_t) params.burstHold)
+        return;
+
+    // Also catches up with a changed idle interval, in either direction
+    const uint32_t grown = intervalMicros + intervalMicros / 4;
+    intervalMicros = grown < idle ? grown : idle;
+}
+
+bool GateRanging::ping() {
+    if (inFlight >= 0)
+        return false;
+
+    decay();
+
+    // Every gate keeps its slot even while it holds off, so the others stay evenly spaced
+    Gate& current = gates[next];
+    const int gate = next;
+    next = (next + 1) % count;
+
+    if (current.holdoff) {
+        if (clock.millis() - current.holdoffStartMillis < (uint32_t) params.afterDetectionDelay)
+            return true;
+        current.holdoff = false;
+    }
+
+    if (!current.ranger.startMeasurement())
+        return false;
+    inFlight = gate;
+    pingMicros = clock.micros();
+    return true;
+}
+
+bool GateRanging::poll(int& gate, long& reading, uint32_t& micros) {
+    if (inFlight < 0 || !gates[inFlight].ranger.pollMeasurement(reading))
+        return false;
+
+    gate = inFlight;
+    micros = pingMicros;
+    inFlight = -1;
+    if (reading == RANGER_TIMEOUT)
+        gates[gate].timeouts++;
+    return true;
+}
+
+void GateRanging::startHoldoff(int gate) {
+    gates[gate].holdoff = true;
+    gates[gate].holdoffStartMillis = clock.millis();
+}
+
+bool GateRanging::holdingOff() const {
+    for (int i = 0; i < count; i++) {
+        if (gates[i].holdoff)
+            return true;
+    }
+    return false;
+}
+
+void GateRanging::restart() {
+    intervalMicros = idleIntervalMicros();
+    for (int i = 0; i < count; i++)
+        gates[i].restart();
+}
@@ -0,0 +1,101 @@
+#ifndef Gate_H
+#define Gate_H
+
+#include <stdint.h>
+#include "Clock.h"
+#include "Detector.h"
+#include "LapTimer.h"
+#include "Parameters.h"
+#include "Ranger.h"
+
+const int GATE_MAX = 4;
+// Longest echo (RANGER_MAX_CM at ~58 usec/cm) plus time for it to die down before the next sensor pings
+const uint32_t GATE_MIN_SLOT_MICROS = 30000;
+
+/// @brief One timing gate: a ranger with its own calibration, detector and holdoff
+struct Gate {
+    Gate(const char* name, LapTimer::Role role, Ranger& ranger, const Parameters& params) :
+        name(name), role(role), ranger(ranger), detector(params) {}
+
+    const char* name;
+    LapTimer::Role role;
+    int split = 0;                  // Number among the SPLIT gates, assigned by GateRanging
+    Ranger& ranger;
+    Detector detector;
+
+    bool holdoff = false;           // Pause after a crossing so the bike is not counted twice
+    uint32_t holdoffStartMillis = 0;
+    uint32_t timeouts = 0;
+    uint32_t triggers = 0;          // Confirmed crossings
+    uint32_t flukes = 0;            // Potential triggers the detection window rejected
+
+    void restart() {
+        detector.restart();
+        holdoff = false;
+    }
+};
+
+/// @brief Pings the gates one after another so no two sensors are ever in flight at once, an echo
+/// from one sensor can not be mistaken for another sensor's.
+///
+/// Each gate is pinged once per ranging interval and the pings are spread evenly over it, so adding
+/// gates does not lower any gate's sample rate. Only when a slot would get shorter than
+/// GATE_MIN_SLOT_MICROS the interval is stretched.
+///
+/// The interval adapts: while nothing happens it is the idle interval (Parameters::delay). A deviating
+/// reading switches to burst mode, GATE_MIN_SLOT_MICROS per slot, the fastest the sensors allow. After
+/// burstHold msec without deviations the interval grows back to idle by a quarter per ping.
+///
+/// Drive ping() from a scheduler task with a period of slotMicros() and call poll() from the loop.
+/// The slot changes from ping to ping, so update the task period after each one.
+class GateRanging {
+    public:
+        GateRanging(Clock& clock, const Parameters& params, Gate* gates, int count);
+
+        /// @brief Period for the task calling ping()
+        uint32_t slotMicros() const { return intervalMicros / count; }
+        /// @brief Current time between two readings of the same gate
+        uint32_t gateIntervalMicros() const { return intervalMicros; }
+        uint32_t idleIntervalMicros() const;
+        uint32_t burstIntervalMicros() const { return GATE_MIN_SLOT_MICROS * count; }
+
+        /// @brief A gate saw a deviating reading: range at the maximum rate for the next burstHold msec
+        /// @return true if the rate went up, the next ping should then come one burst slot after the last one
+        bool burst();
+        /// @brief Whether ranging runs faster than idle
+        bool bursting() const { return intervalMicros < idleIntervalMicros(); }
+
+        /// @brief Ping the next gate, unless it is in holdoff
+        /// @return false if the previous measurement is still in flight
+        bool ping();
+        /// @brief Pick up a completed measurement
+        /// @param pingMicros Time of the ping, which is when the reading was taken
+        /// @return true if there was one
+        bool poll(int& gate, long& reading, uint32_t& pingMicros);
+        bool measuring() const { return inFlight >= 0; }
+
+        /// @brief Start a holdoff on a gate after it saw a crossing
+        void startHoldoff(int gate);
+        /// @brief Whether any gate is in holdoff
+        bool holdingOff() const;
+        void restart();
+
+        int size() const { return count; }
+        Gate& gate(int i) { return gates[i]; }
+
+    private:
+        Clock& clock;
+        const Parameters& params;
+        Gate* gates;
+        int count;
+        int next = 0;
+        int inFlight = -1;          // Gate being measured
+        uint32_t pingMicros = 0;
+
+        uint32_t intervalMicros;
+        uint32_t lastBurstMillis = 0;
+
+        void decay();
+};
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef Clock_H
+#define Clock_H
+
+#include <stdint.h>
+
+/// @brief Time source. On the board this wraps millis()/micros()/delay(), on the host it is a VirtualClock.
+class Clock {
+    public:
+        virtual ~Clock() {}
+        /// @brief msec since boot
+        virtual uint32_t millis() = 0;
+        /// @brief usec since boot. Wraps after ~71 minutes, only ever use differences.
+        virtual uint32_t micros() = 0;
+        virtual void delay(uint32_t ms) = 0;
+};
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef EventConnection_H
+#define EventConnection_H
+
+#include <stddef.h>
+
+/// @brief Write side of one open EventSource connection, e.g. a TCP connection on the board or a
+/// simulated phone on the host.
+class EventConnection {
+    public:
+        virtual ~EventConnection() {}
+        virtual bool connected() = 0;
+        /// @brief Bytes write() takes right now without queueing, 0 while the peer is behind
+        virtual size_t space() = 0;
+        /// @brief Write at most space() bytes. Messages may be split across writes.
+        virtual void write(const char* data, size_t length) = 0;
+        /// @brief Drop the connection. May call back into the owner before returning.
+        virtual void close() = 0;
+};
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef EventSink_H
+#define EventSink_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// @brief Destination for named text events, e.g. the /events EventSource on the board.
+class EventSink {
+    public:
+        virtual ~EventSink() {}
+        /// @param message Event payload
+        /// @param event Event name, e.g. "log" or "trigger"
+        /// @param id Event id
+        virtual void send(const char* message, const char* event, uint32_t id) = 0;
+        /// @brief Send a "log" event. Sinks that queue can drop low levels first.
+        /// @param level A LogLevel
+        virtual void sendLog(const char* message, int level, uint32_t id) { send(message, "log", id); }
+        /// @brief Whether a message of the given length can be sent right now without blocking
+        virtual bool canSend(size_t length) { return true; }
+        /// @brief Number of connected clients. Work for a sink without clients can be skipped.
+        virtual size_t clients() { return 1; }
+        /// @brief Messages queued but not yet delivered, averaged over the clients. Grows when clients fall behind.
+        virtual size_t backlog() { return 0; }
+};
+
+#endif
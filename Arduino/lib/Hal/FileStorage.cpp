@@ -0,0 +1,98 @@
+#ifndef ARDUINO
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "FileStorage.h"
+
+FileStorage::FileStorage(const char* rootDirectory) {
+    snprintf(root, sizeof(root), "%s", rootDirectory);
+}
+
+void FileStorage::resolve(const char* path, char* out, size_t size) const {
+    if (root[0] == '\0') {
+        snprintf(out, size, "%s", path);
+        return;
+    }
+
+    // Board paths are absolute ("/laps.bin"), keep them below our root
+    while (*path == '/')
+        path++;
+    snprintf(out, size, "%s/%s", root, path);
+}
+
+size_t FileStorage::read(const char* path, size_t offset, void* data, size_t size) {
+    char fullPath[512];
+    resolve(path, fullPath, sizeof(fullPath));
+
+    FILE* file = fopen(fullPath, "rb");
+    if (file == NULL)
+        return 0;
+
+    size_t read = 0;
+    if (fseek(file, (long) offset, SEEK_SET) == 0)
+        read = fread(data, 1, size, file);
+
+    fclose(file);
+    return read;
+}
+
+bool FileStorage::write(const char* path, const void* data, size_t size) {
+    char fullPath[512];
+    resolve(path, fullPath, sizeof(fullPath));
+
+    FILE* file = fopen(fullPath, "wb");
+    if (file == NULL)
+        return false;
+
+    bool ok = fwrite(data, 1, size, file) == size;
+    return fclose(file) == 0 && ok;
+}
+
+bool FileStorage::append(const char* path, const void* data, size_t size) {
+    char fullPath[512];
+    resolve(path, fullPath, sizeof(fullPath));
+
+    FILE* file = fopen(fullPath, "ab");
+    if (file == NULL)
+        return false;
+
+    bool ok = fwrite(data, 1, size, file) == size;
+    return fclose(file) == 0 && ok;
+}
+
+size_t FileStorage::size(const char* path) {
+    char fullPath[512];
+    resolve(path, fullPath, sizeof(fullPath));
+
+    FILE* file = fopen(fullPath, "rb");
+    if (file == NULL)
+        return 0;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+
+    return size < 0 ? 0 : (size_t) size;
+}
+
+bool FileStorage::remove(const char* path) {
+    char fullPath[512];
+    resolve(path, fullPath, sizeof(fullPath));
+
+    return ::remove(fullPath) == 0;
+}
+
+bool FileStorage::truncate(const char* path, size_t size) {
+    char fullPath[512];
+    resolve(path, fullPath, sizeof(fullPath));
+
+    if (size == 0) {
+        ::remove(fullPath);
+        return true;
+    }
+
+    return ::truncate(fullPath, (off_t) size) == 0;
+}
+
+#endif
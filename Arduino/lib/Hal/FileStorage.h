@@ -0,0 +1,27 @@
+#ifndef FileStorage_H
+#define FileStorage_H
+
+#ifndef ARDUINO
+
+#include "Storage.h"
+
+/// @brief Storage backed by regular files below a root directory. Host builds only.
+class FileStorage : public Storage {
+    private:
+        char root[256];
+        void resolve(const char* path, char* out, size_t size) const;
+
+    public:
+        /// @param rootDirectory Directory board paths are resolved against. Empty to use paths as given.
+        explicit FileStorage(const char* rootDirectory = ".");
+        size_t read(const char* path, size_t offset, void* data, size_t size) override;
+        bool write(const char* path, const void* data, size_t size) override;
+        bool append(const char* path, const void* data, size_t size) override;
+        size_t size(const char* path) override;
+        bool remove(const char* path) override;
+        bool truncate(const char* path, size_t size) override;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef Ranger_H
+#define Ranger_H
+
+// Reading reported when no echo came back within the maximum range
+const long RANGER_TIMEOUT = -1;
+// Maximum useful range of the ranger. Timeouts mean nothing is closer than this.
+const int RANGER_MAX_CM = 400;
+
+/// @brief Distance sensor
+class Ranger {
+    public:
+        virtual ~Ranger() {}
+        /// @brief Take one blocking measurement
+        /// @return Distance in cm, or RANGER_TIMEOUT
+        virtual long measureInCentimeters() = 0;
+
+        /// @brief Start a measurement without waiting for it.
+        /// The default implementation measures right away, sensors with interrupt support override this.
+        /// @return false if a measurement is still in flight
+        virtual bool startMeasurement() {
+            pending = measureInCentimeters();
+            hasPending = true;
+            return true;
+        }
+
+        /// @brief Check for the result of startMeasurement()
+        /// @param centimeters Distance in cm, or RANGER_TIMEOUT
+        /// @return true once the measurement is complete
+        virtual bool pollMeasurement(long& centimeters) {
+            if (!hasPending)
+                return false;
+
+            centimeters = pending;
+            hasPending = false;
+            return true;
+        }
+
+    private:
+        long pending = 0;
+        bool hasPending = false;
+};
+
+#endif
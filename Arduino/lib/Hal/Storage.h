@@ -0,0 +1,24 @@
+#ifndef Storage_H
+#define Storage_H
+
+#include <stddef.h>
+
+/// @brief Minimal persistent file storage. LittleFS on the board, a directory on the host.
+class Storage {
+    public:
+        virtual ~Storage() {}
+        /// @brief Read up to size bytes starting at offset
+        /// @return Number of bytes read, 0 if the file does not exist
+        virtual size_t read(const char* path, size_t offset, void* data, size_t size) = 0;
+        /// @brief Replace the contents of a file
+        virtual bool write(const char* path, const void* data, size_t size) = 0;
+        /// @brief Append to a file, creating it if needed
+        virtual bool append(const char* path, const void* data, size_t size) = 0;
+        /// @return File size in bytes, 0 if the file does not exist
+        virtual size_t size(const char* path) = 0;
+        virtual bool remove(const char* path) = 0;
+        /// @brief Cut a file down to size bytes. Truncating to 0 removes the file.
+        virtual bool truncate(const char* path, size_t size) = 0;
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef VirtualClock_H
+#define VirtualClock_H
+
+#include <stdint.h>
+#include "Clock.h"
+
+/// @brief Clock that only moves when told to. delay() returns immediately and advances time,
+/// which lets host builds run simulated hours in milliseconds.
+class VirtualClock : public Clock {
+    private:
+        uint64_t now = 0;   // usec
+
+    public:
+        uint32_t millis() override {
+            return (uint32_t) (now / 1000);
+        }
+
+        uint32_t micros() override {
+            return (uint32_t) now;
+        }
+
+        void delay(uint32_t ms) override {
+            now += (uint64_t) ms * 1000;
+        }
+
+        void advanceMicros(uint32_t us) {
+            now += us;
+        }
+
+        uint64_t micros64() const {
+            return now;
+        }
+};
+
+#endif
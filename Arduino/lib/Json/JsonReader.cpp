@@ -0,0 +1,140 @@
+#include "JsonReader.h"
+#include <limits.h>
+#include <string.h>
+
+bool JsonMember::is(const char* name) const {
+    return strlen(name) == keyLength && strncmp(name, key, keyLength) == 0;
+}
+
+JsonReader::JsonReader(const char* text, size_t length) : text(text), length(length) {}
+
+void JsonReader::skipWhitespace() {
+    while (position < length && (text[position] == ' ' || text[position] == '\t' || text[position] == '\r' || text[position] == '\n'))
+        position++;
+}
+
+bool JsonReader::fail(const char* message) {
+    if (failure == NULL)
+        failure = message;
+    stage = 2;
+    return false;
+}
+
+bool JsonReader::consume(char expected) {
+    skipWhitespace();
+    if (position >= length || text[position] != expected)
+        return false;
+
+    position++;
+    return true;
+}
+
+bool JsonReader::consumeWord(const char* word) {
+    const size_t wordLength = strlen(word);
+    if (length - position < wordLength || strncmp(text + position, word, wordLength) != 0)
+        return false;
+
+    position += wordLength;
+    return true;
+}
+
+bool JsonReader::readString(const char*& start, size_t& stringLength) {
+    if (!consume('"'))
+        return fail("expected a string");
+
+    start = text + position;
+    while (position < length && text[position] != '"') {
+        if ((unsigned char) text[position] < 0x20)
+            return fail("control character in string");
+        // Skip the escaped character, so an escaped quote does not end the string
+        if (text[position] == '\\')
+            position++;
+        position++;
+    }
+    if (position >= length)
+        return fail("unterminated string");
+
+    stringLength = text + position - start;
+    position++;
+    return true;
+}
+
+bool JsonReader::readNumber(long& number) {
+    bool negative = false;
+    if (position < length && text[position] == '-') {
+        negative = true;
+        position++;
+    }
+    if (position >= length || text[position] < '0' || text[position] > '9')
+        return fail("invalid value");
+
+    unsigned long magnitude = 0;
+    while (position < length && text[position] >= '0' && text[position] <= '9') {
+        const unsigned long digit = text[position] - '0';
+        if (magnitude > (LONG_MAX - digit) / 10)
+            return fail("number out of range");
+        magnitude = magnitude * 10 + digit;
+        position++;
+    }
+    if (position < length && (text[position] == '.' || text[position] == 'e' || text[position] == 'E'))
+        return fail("numbers must be integers");
+
+    number = negative ? -(long) magnitude : (long) magnitude;
+    return true;
+}
+
+bool JsonReader::next(JsonMember& member) {
+    if (stage == 2)
+        return false;
+
+    if (stage == 0) {
+        if (!consume('{'))
+            return fail("expected an object");
+        stage = 1;
+        if (consume('}')) {
+            stage = 2;
+            return false;
+        }
+    } else if (!consume(',')) {
+        if (!consume('}'))
+            return fail("expected ',' or '}'");
+        stage = 2;
+        skipWhitespace();
+        if (position != length)
+            return fail("trailing characters after object");
+        return false;
+    }
+
+    if (!readString(member.key, member.keyLength))
+        return false;
+    if (!consume(':'))
+        return fail("expected ':'");
+
+    skipWhitespace();
+    if (position >= length)
+        return fail("unexpected end of input");
+
+    member.number = 0;
+    member.flag = false;
+    member.text = NULL;
+    member.textLength = 0;
+
+    const char c = text[position];
+    if (c == '"') {
+        member.type = JSON_STRING;
+        return readString(member.text, member.textLength);
+    } else if (c == '{' || c == '[') {
+        return fail("nested values are not supported");
+    } else if (consumeWord("true")) {
+        member.type = JSON_BOOL;
+        member.flag = true;
+    } else if (consumeWord("false")) {
+        member.type = JSON_BOOL;
+    } else if (consumeWord("null")) {
+        member.type = JSON_NULL;
+    } else {
+        member.type = JSON_NUMBER;
+        return readNumber(member.number);
+    }
+    return true;
+}
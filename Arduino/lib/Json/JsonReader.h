@@ -0,0 +1,59 @@
+#ifndef JsonReader_H
+#define JsonReader_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+enum JsonType {
+    JSON_NULL,
+    JSON_BOOL,
+    JSON_NUMBER,
+    JSON_STRING
+};
+
+/// @brief One member of a flat JSON object. Pointers refer into the parsed text.
+struct JsonMember {
+    const char* key;
+    size_t keyLength;
+    JsonType type;
+    long number;            // JSON_NUMBER, integers only
+    bool flag;              // JSON_BOOL
+    const char* text;       // JSON_STRING, escapes are left as they are
+    size_t textLength;
+
+    /// @brief Whether the key equals name
+    bool is(const char* name) const;
+};
+
+/// @brief Single pass reader for the flat objects the API accepts, e.g. {"delay":100,"running":true}.
+/// Nothing is copied or allocated. Nested objects, arrays and fractional numbers are rejected.
+///
+///     JsonReader reader(body, length);
+///     JsonMember member;
+///     while (reader.next(member)) { ... }
+///     if (reader.error() != NULL) { ... }
+class JsonReader {
+    public:
+        JsonReader(const char* text, size_t length);
+
+        /// @return false at the end of the object or on a syntax error
+        bool next(JsonMember& member);
+        /// @return NULL if everything parsed so far is valid
+        const char* error() const { return failure; }
+
+    private:
+        const char* text;
+        size_t length;
+        size_t position = 0;
+        int stage = 0;              // 0 before '{', 1 inside, 2 done
+        const char* failure = NULL;
+
+        void skipWhitespace();
+        bool fail(const char* message);
+        bool consume(char expected);
+        bool consumeWord(const char* word);
+        bool readString(const char*& start, size_t& stringLength);
+        bool readNumber(long& number);
+};
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef JsonWriter_H
+#define JsonWriter_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+const int JSON_MAX_DEPTH = 31;
+
+/// @brief JsonWriter output into a fixed char buffer, always zero terminated. Refuses what does not fit.
+class JsonBuffer {
+    public:
+        JsonBuffer(char* data, size_t capacity) : data(data), capacity(capacity) { data[0] = '\0'; }
+
+        size_t write(const uint8_t* text, size_t length) {
+            if (used + length >= capacity)
+                return 0;
+            memcpy(data + used, text, length);
+            used += length;
+            data[used] = '\0';
+            return length;
+        }
+
+        const char* c_str() const { return data; }
+        size_t length() const { return used; }
+
+    private:
+        char* data;
+        size_t capacity;
+        size_t used = 0;
+};
+
+/// @brief Streaming JSON serializer. Everything goes straight to the output, nothing is buffered.
+///
+/// Output is anything with `size_t write(const uint8_t* data, size_t length)`, e.g. an Arduino Print
+/// such as AsyncResponseStream. Commas are inserted automatically:
+///
+///     json.beginObject().field("delay", 100).key("laps").beginArray().value(1).value(2).endArray().endObject();
+template <typename Output>
+class JsonWriter {
+    public:
+        explicit JsonWriter(Output& out) : out(out) {}
+
+        JsonWriter& beginObject() { return open('{'); }
+        JsonWriter& endObject() { return close('}'); }
+        JsonWriter& beginArray() { return open('['); }
+        JsonWriter& endArray() { return close(']'); }
+
+        /// @brief Member name, the next value or container belongs to it
+        JsonWriter& key(const char* name) {
+            separate();
+            string(name);
+            raw(":", 1);
+            afterKey = true;
+            return *this;
+        }
+
+        JsonWriter& value(int number) { return value((long) number); }
+        JsonWriter& value(unsigned int number) { return value((unsigned long) number); }
+        JsonWriter& value(long number) {
+            char text[21];      // Fits a 64 bit long on the host as well
+            return literal(text, snprintf(text, sizeof(text), "%ld", number));
+        }
+        JsonWriter& value(unsigned long number) {
+            char text[21];
+            return literal(text, snprintf(text, sizeof(text), "%lu", number));
+        }
+        JsonWriter& value(bool flag) { return flag ? literal("true", 4) : literal("false", 5); }
+        /// @brief String value, NULL is written as null
+        JsonWriter& value(const char* text) {
+            if (text == NULL)
+                return null();
+            separate();
+            string(text);
+            return *this;
+        }
+        JsonWriter& null() { return literal("null", 4); }
+
+        template <typename T>
+        JsonWriter& field(const char* name, T v) {
+            key(name);
+            return value(v);
+        }
+
+        /// @brief Whether the output refused some of the data
+        bool failed() const { return !ok; }
+
+    private:
+        Output& out;
+        uint32_t hasMembers = 0;    // Bit n: the container at depth n already has an element
+        uint8_t depth = 0;
+        bool afterKey = false;
+        bool ok = true;
+
+        void raw(const char* text, size_t length) {
+            if (out.write((const uint8_t*) text, length) != length)
+                ok = false;
+        }
+
+        // Comma before every element but the first of a container
+        void separate() {
+            if (afterKey) {
+                afterKey = false;
+                return;
+            }
+            if (hasMembers & (1UL << depth))
+                raw(",", 1);
+            hasMembers |= 1UL << depth;
+        }
+
+        JsonWriter& literal(const char* text, int length) {
+            separate();
+            raw(text, length);
+            return *this;
+        }
+
+        JsonWriter& open(char bracket) {
+            separate();
+            raw(&bracket, 1);
+            if (depth < JSON_MAX_DEPTH)
+                depth++;
+            else
+                ok = false;
+            hasMembers &= ~(1UL << depth);
+            return *this;
+        }
+
+        JsonWriter& close(char bracket) {
+            if (depth > 0)
+                depth--;
+            raw(&bracket, 1);
+            return *this;
+        }
+
+        // Quoted and escaped, runs of plain characters are written in one go
+        void string(const char* text) {
+            raw("\"", 1);
+            const char* run = text;
+            for (const char* c = text; *c != '\0'; c++) {
+                const unsigned char ch = (unsigned char) *c;
+                if (ch >= 0x20 && ch != '"' && ch != '\\')
+                    continue;
+
+                raw(run, c - run);
+                run = c + 1;
+                if (ch == '"' || ch == '\\') {
+                    const char escaped[2] = {'\\', (char) ch};
+                    raw(escaped, 2);
+                } else {
+                    char escaped[7];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+                    raw(escaped, 6);
+                }
+            }
+            raw(run, strlen(run));
+            raw("\"", 1);
+        }
+};
+
+#endif
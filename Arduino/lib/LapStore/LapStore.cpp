@@ -0,0 +1,241 @@
+#include <stdio.h>
+#include <string.h>
+#include "LapStore.h"
+
+static const uint16_t LAP_MAGIC = 0x4C50;    // "LP"
+
+uint32_t crc32(const void* data, size_t length, uint32_t crc) {
+    const uint8_t* bytes = (const uint8_t*) data;
+    crc = ~crc;
+    while (length--) {
+        crc ^= *bytes++;
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+    }
+    return ~crc;
+}
+
+LapStore::LapStore(Storage& storage, const char* path) : storage(storage), path(path) {
+    memset(&lastRecord, 0, sizeof(lastRecord));
+}
+
+bool LapStore::valid(const LapRecord& record) {
+    return record.magic == LAP_MAGIC && record.crc == crc32(&record, offsetof(LapRecord, crc));
+}
+
+void LapStore::indexRecord(const LapRecord& record, uint32_t number) {
+    if (indexCount > 0 && index[indexCount - 1].session == record.session) {
+        index[indexCount - 1].records = number + 1 - index[indexCount - 1].firstRecord;
+        index[indexCount - 1].laps++;
+        return;
+    }
+
+    if (indexCount == LAPSTORE_MAX_SESSIONS) {
+        // Forget the oldest session, it stays on flash but is no longer listed
+        memmove(index, index + 1, sizeof(SessionIndex) * (LAPSTORE_MAX_SESSIONS - 1));
+        indexCount--;
+    }
+
+    index[indexCount].session = record.session;
+    index[indexCount].firstRecord = number;
+    index[indexCount].records = 1;
+    index[indexCount].laps = 1;
+    indexCount++;
+}
+
+uint32_t LapStore::begin() {
+    records = 0;
+    damagedCount = 0;
+    indexCount = 0;
+
+    const size_t fileSize = storage.size(path);
+    const uint32_t slots = fileSize / sizeof(LapRecord);
+    // A block per read: every read opens the file, which costs more than the records themselves
+    LapRecord block[LAPSTORE_READ_BLOCK];
+    for (uint32_t first = 0; first < slots; first += LAPSTORE_READ_BLOCK) {
+        const uint32_t wanted = slots - first < LAPSTORE_READ_BLOCK ? slots - first : LAPSTORE_READ_BLOCK;
+        const uint32_t count = storage.read(path, first * sizeof(LapRecord), block, wanted * sizeof(LapRecord)) / sizeof(LapRecord);
+        for (uint32_t i = 0; i < count; i++) {
+            if (!valid(block[i]))
+                continue;
+
+            // Everything since the previous valid record is damaged
+            const uint32_t number = first + i;
+            damagedCount += number - records;
+            indexRecord(block[i], number);
+            lastRecord = block[i];
+            records = number + 1;
+        }
+    }
+
+    // Only a torn tail goes: a partial record, or damaged ones after the last valid record
+    if (records * sizeof(LapRecord) != fileSize)
+        storage.truncate(path, records * sizeof(LapRecord));
+
+    session = records > 0 ? lastRecord.session : 0;
+    lapInSession = records > 0 ? lastRecord.lap : 0;
+    return records;
+}
+
+uint16_t LapStore::beginSession() {
+    session++;
+    if (session == 0)
+        session = 1;
+    lapInSession = 0;
+    return session;
+}
+
+bool LapStore::append(uint32_t startMicros, uint32_t endMicros, uint32_t durationMicros, uint16_t confidence) {
+    if (records >= LAPSTORE_MAX_RECORDS)
+        return false;
+
+    if (session == 0)
+        beginSession();
+
+    LapRecord record;
+    record.magic = LAP_MAGIC;
+    record.session = session;
+    record.lap = lapInSession + 1;
+    record.confidence = confidence;
+    record.startMicros = startMicros;
+    record.endMicros = endMicros;
+    record.durationMicros = durationMicros;
+    record.crc = crc32(&record, offsetof(LapRecord, crc));
+
+    if (!storage.append(path, &record, sizeof(record))) {
+        // A partial write would misalign everything after it
+        storage.truncate(path, records * sizeof(LapRecord));
+        return false;
+    }
+
+    indexRecord(record, records);
+    lastRecord = record;
+    lapInSession++;
+    records++;
+    return true;
+}
+
+bool LapStore::read(uint32_t record, LapRecord& out) {
+    if (record >= records)
+        return false;
+
+    return storage.read(path, record * sizeof(LapRecord), &out, sizeof(out)) == sizeof(out) && valid(out);
+}
+
+uint32_t LapStore::readBlock(uint32_t firstRecord, LapRecord* out, uint32_t count) {
+    if (firstRecord >= records)
+        return 0;
+    if (count > records - firstRecord)
+        count = records - firstRecord;
+
+    return storage.read(path, firstRecord * sizeof(LapRecord), out, count * sizeof(LapRecord)) / sizeof(LapRecord);
+}
+
+bool LapStore::findSession(uint16_t session, uint32_t& firstRecord, uint32_t& records) const {
+    for (int i = 0; i < indexCount; i++) {
+        if (index[i].session == session) {
+            firstRecord = index[i].firstRecord;
+            records = index[i].records;
+            return true;
+        }
+    }
+    return false;
+}
+
+void LapStore::sessionAt(int i, uint16_t& session, uint32_t& firstRecord, uint32_t& laps) const {
+    session = index[i].session;
+    firstRecord = index[i].firstRecord;
+    laps = index[i].laps;
+}
+
+bool LapStore::clear() {
+    records = 0;
+    damagedCount = 0;
+    indexCount = 0;
+    lapInSession = 0;
+    memset(&lastRecord, 0, sizeof(lastRecord));
+    return storage.truncate(path, 0);
+}
+
+LapJsonStream::LapJsonStream(LapStore& store, uint16_t session, uint32_t offset, uint32_t limit) :
+    store(&store), session(session), offset(offset) {
+    uint32_t first = 0;
+    total = store.size();
+    if (session != 0 && !store.findSession(session, first, total))
+        total = 0;
+
+    next = first + (offset < total ? offset : total);
+    const uint32_t available = first + total - next;
+    end = next + (limit < available ? limit : available);
+}
+
+bool LapJsonStream::fillPending() {
+    int length = 0;
+
+    if (stage == 0) {
+        length = snprintf(pending, sizeof(pending), "{\"session\":%u,\"offset\":%u,\"total\":%u,\"laps\":[",
+                          (unsigned) session, (unsigned) offset, (unsigned) total);
+        stage = next < end ? 1 : 2;
+    } else if (stage == 1) {
+        // Skip damaged records. Past the end of the log, e.g. cleared underneath us, ends the list cleanly.
+        const LapRecord* record = NULL;
+        while (next < end && (record = recordAt(next)) == NULL)
+            next++;
+        if (next == end) {
+            stage = 2;
+            return fillPending();
+        }
+        length = snprintf(pending, sizeof(pending),
+                          "%s{\"session\":%u,\"lap\":%u,\"start\":%u,\"end\":%u,\"duration\":%u,\"confidence\":%u}",
+                          listed > 0 ? "," : "", (unsigned) record->session, (unsigned) record->lap, (unsigned) record->startMicros,
+                          (unsigned) record->endMicros, (unsigned) record->durationMicros, (unsigned) record->confidence);
+        listed++;
+        next++;
+        if (next == end)
+            stage = 2;
+    } else if (stage == 2) {
+        length = snprintf(pending, sizeof(pending), "]}");
+        stage = 3;
+    } else {
+        return false;
+    }
+
+    pendingLength = (size_t) length;
+    pendingPosition = 0;
+    return true;
+}
+
+const LapRecord* LapJsonStream::recordAt(uint32_t number) {
+    if (number >= store->size())
+        return NULL;
+
+    if (number < blockFirst || number >= blockFirst + blockCount) {
+        const uint32_t wanted = end - number < LAPSTORE_READ_BLOCK ? end - number : LAPSTORE_READ_BLOCK;
+        blockFirst = number;
+        blockCount = store->readBlock(number, block, wanted);
+        if (blockCount == 0)
+            return NULL;
+    }
+
+    const LapRecord& record = block[number - blockFirst];
+    return LapStore::valid(record) ? &record : NULL;
+}
+
+size_t LapJsonStream::read(uint8_t* buffer, size_t maxLen) {
+    size_t written = 0;
+
+    while (written < maxLen) {
+        if (pendingPosition == pendingLength && !fillPending())
+            break;
+
+        size_t chunk = pendingLength - pendingPosition;
+        if (chunk > maxLen - written)
+            chunk = maxLen - written;
+
+        memcpy(buffer + written, pending + pendingPosition, chunk);
+        pendingPosition += chunk;
+        written += chunk;
+    }
+
+    return written;
+}
@@ -0,0 +1,134 @@
+#ifndef LapStore_H
+#define LapStore_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Storage.h"
+
+/// @brief One lap as stored on flash. Fixed size, so record n lives at n * sizeof(LapRecord).
+struct LapRecord {
+    uint16_t magic;
+    uint16_t session;
+    uint16_t lap;               // 1-based within the session
+    uint16_t confidence;        // Detector confidence, 0-1000
+    uint32_t startMicros;       // Gate entry, usec since boot (wraps)
+    uint32_t endMicros;
+    uint32_t durationMicros;
+    uint32_t crc;               // CRC-32 of all preceding fields
+};
+
+static_assert(sizeof(LapRecord) == 24, "LapRecord layout must not change, it is the on-flash format");
+
+const int LAPSTORE_MAX_SESSIONS = 32;       // Sessions kept in the RAM index, older ones are still on flash
+const uint32_t LAPSTORE_MAX_RECORDS = 4096; // ~96 KB of flash
+const uint32_t LAPSTORE_READ_BLOCK = 16;    // Records per flash read, each read opens the file
+
+/// @brief CRC-32 (IEEE), bitwise. Small and fast enough for a few records.
+uint32_t crc32(const void* data, size_t length, uint32_t crc = 0);
+
+/// @brief Append-only lap log on flash with a small RAM index of sessions.
+///
+/// Records carry a magic and a CRC. On begin() the log is scanned once and anything after the
+/// last valid record, e.g. a write torn by a power cut, is truncated away. A damaged record with
+/// valid ones after it stays in place as a hole: it is counted and skipped, the laps after it are kept.
+/// Sessions are appended contiguously, so a session is just a range of record numbers.
+/// Once LAPSTORE_MAX_RECORDS are stored, append() fails until the log is cleared; full() tells.
+class LapStore {
+    public:
+        LapStore(Storage& storage, const char* path);
+
+        /// @brief Scan the log and build the index
+        /// @return Number of valid records
+        uint32_t begin();
+
+        /// @brief Start a new session. Its id is one above the last one on flash.
+        uint16_t beginSession();
+        uint16_t currentSession() const { return session; }
+
+        bool append(uint32_t startMicros, uint32_t endMicros, uint32_t durationMicros, uint16_t confidence);
+
+        /// @brief Read record n of the whole log
+        /// @return false past the end and for damaged records
+        bool read(uint32_t record, LapRecord& out);
+        /// @brief Read up to count records from firstRecord on with a single flash read. Damaged
+        /// records are returned as they are, check them with valid().
+        /// @return Number of records read, less than count at the end of the log
+        uint32_t readBlock(uint32_t firstRecord, LapRecord* out, uint32_t count);
+        /// @brief Magic and CRC match
+        static bool valid(const LapRecord& record);
+        /// @brief Find the record range of a session
+        /// @param records Number of records from firstRecord on, damaged ones included
+        /// @return false if the session is not in the index
+        bool findSession(uint16_t session, uint32_t& firstRecord, uint32_t& records) const;
+
+        /// @brief Number of records, damaged ones included
+        uint32_t size() const { return records; }
+        bool full() const { return records >= LAPSTORE_MAX_RECORDS; }
+        /// @brief Damaged records begin() found between valid ones
+        uint32_t damaged() const { return damagedCount; }
+        bool hasLast() const { return records > 0; }
+        const LapRecord& last() const { return lastRecord; }
+
+        int sessionCount() const { return indexCount; }
+        /// @brief Index entry i, oldest first. laps only counts valid records.
+        void sessionAt(int i, uint16_t& session, uint32_t& firstRecord, uint32_t& laps) const;
+
+        /// @brief Delete all laps. Session ids keep counting up.
+        bool clear();
+
+    private:
+        struct SessionIndex {
+            uint16_t session;
+            uint32_t firstRecord;
+            uint32_t records;       // Up to the last lap, holes included
+            uint32_t laps;
+        };
+
+        Storage& storage;
+        const char* path;
+        uint32_t records = 0;
+        uint32_t damagedCount = 0;
+        uint16_t session = 0;
+        uint16_t lapInSession = 0;
+        LapRecord lastRecord;
+
+        SessionIndex index[LAPSTORE_MAX_SESSIONS];
+        int indexCount = 0;
+
+        void indexRecord(const LapRecord& record, uint32_t number);
+};
+
+/// @brief Streams a page of laps as JSON without holding more than LAPSTORE_READ_BLOCK records in RAM.
+/// Meant to be the filler of a chunked HTTP response.
+class LapJsonStream {
+    public:
+        /// @param session Session to list, 0 for all laps
+        LapJsonStream(LapStore& store, uint16_t session, uint32_t offset, uint32_t limit);
+
+        /// @brief Write the next part of the response
+        /// @return Bytes written, 0 when done
+        size_t read(uint8_t* buffer, size_t maxLen);
+
+    private:
+        LapStore* store;
+        uint16_t session;
+        uint32_t offset;
+        uint32_t total;         // Records in the selection
+        uint32_t next;          // Next record number
+        uint32_t end;           // One past the last record number of the page
+        uint32_t listed = 0;    // Laps written so far
+        int stage = 0;          // 0 header, 1 laps, 2 footer, 3 done
+
+        char pending[192];      // Formatted text not yet handed out
+        size_t pendingLength = 0;
+        size_t pendingPosition = 0;
+
+        LapRecord block[LAPSTORE_READ_BLOCK];   // Records blockFirst to blockFirst + blockCount - 1
+        uint32_t blockFirst = 0;
+        uint32_t blockCount = 0;
+
+        bool fillPending();
+        const LapRecord* recordAt(uint32_t number);
+};
+
+#endif
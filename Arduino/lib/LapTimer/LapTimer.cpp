@@ -0,0 +1,99 @@
+#include "LapTimer.h"
+
+LapTimer::LapTimer(const Parameters& params) : params(params) {}
+
+void LapTimer::pop() {
+    head = (head + 1) % LAPTIMER_MAX_RUNS;
+    count--;
+}
+
+void LapTimer::clear() {
+    head = 0;
+    count = 0;
+}
+
+int LapTimer::expire(uint32_t nowMicros) {
+    const uint32_t maxMicros = (uint32_t) params.maxLapTime * 1000;
+    int dropped = 0;
+    while (count > 0 && nowMicros - run(0).startMicros > maxMicros) {
+        pop();
+        dropped++;
+    }
+    abandoned += dropped;
+    return dropped;
+}
+
+LapTimer::Result LapTimer::crossing(uint32_t micros, uint16_t confidence, Role role, int split) {
+    Result result = {};
+    result.abandoned = expire(micros);
+
+    if (role == SPLIT)
+        return splitCrossing(micros, split, result);
+
+    // A crossing at the only gate finishes the oldest run, unless that run is too young for a lap.
+    // Younger runs are younger still, so then it can only be a new start.
+    const bool oldEnough = count > 0 && micros - run(0).startMicros >= (uint32_t) params.minLapTime * 1000;
+    if (role == FINISH || (role == START_FINISH && oldEnough)) {
+        if (!oldEnough) {
+            result.event = IGNORED;
+            return result;
+        }
+
+        const Run& oldest = run(0);
+        result.event = FINISHED;
+        result.runId = oldest.id;
+        result.startMicros = oldest.startMicros;
+        result.endMicros = micros;
+        result.lapMicros = micros - oldest.startMicros;
+        result.confidence = confidence < oldest.confidence ? confidence : oldest.confidence;
+        pop();
+
+        lastLapRun = result.runId;
+        lastLap = result.lapMicros;
+        return result;
+    }
+
+    if (count == LAPTIMER_MAX_RUNS) {
+        result.event = IGNORED;
+        return result;
+    }
+
+    Run& started = runs[(head + count) % LAPTIMER_MAX_RUNS];
+    started.id = nextId++;
+    started.startMicros = micros;
+    started.confidence = confidence;
+    started.splitsPassed = 0;
+    count++;
+
+    result.event = STARTED;
+    result.runId = started.id;
+    result.startMicros = micros;
+    result.confidence = confidence;
+    return result;
+}
+
+LapTimer::Result LapTimer::splitCrossing(uint32_t micros, int split, Result& result) {
+    if (split < 0 || split >= LAPTIMER_MAX_SPLITS) {
+        result.event = IGNORED;
+        return result;
+    }
+
+    const uint8_t bit = 1 << split;
+    for (int i = 0; i < count; i++) {
+        Run& candidate = runs[(head + i) % LAPTIMER_MAX_RUNS];
+        if (candidate.splitsPassed & bit)
+            continue;
+
+        candidate.splitsPassed |= bit;
+        result.event = SPLIT_TIME;
+        result.runId = candidate.id;
+        result.split = split;
+        result.startMicros = candidate.startMicros;
+        result.endMicros = micros;
+        result.lapMicros = micros - candidate.startMicros;
+        return result;
+    }
+
+    result.event = IGNORED;
+    return result;
+}
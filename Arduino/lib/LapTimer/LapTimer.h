@@ -0,0 +1,91 @@
+#ifndef LapTimer_H
+#define LapTimer_H
+
+#include <stdint.h>
+#include "Parameters.h"
+
+const int LAPTIMER_MAX_RUNS = 8;    // Bikes on the course at once
+const int LAPTIMER_MAX_SPLITS = 8;  // Split gates
+
+/// @brief Pairs gate crossings into laps, for several bikes on the course at the same time.
+///
+/// Open runs wait in a FIFO. Bikes are assumed not to overtake each other, so a finish always
+/// closes the oldest open run, and a split gate stamps the oldest run that has not passed it yet.
+/// With a single start/finish gate a crossing finishes the oldest run once that run is at least
+/// minLapTime old, and starts a new run otherwise. With separate gates a finish sooner than
+/// minLapTime is ignored as a false trigger. Runs older than maxLapTime are dropped as abandoned.
+/// Pure logic: no I/O, time is passed in by the caller.
+class LapTimer {
+    public:
+        enum Role {
+            START_FINISH,       // The only gate, bikes start and finish through it
+            START,
+            SPLIT,
+            FINISH
+        };
+
+        enum Event {
+            STARTED,            // A new run is on the course
+            SPLIT_TIME,         // A run passed a split gate
+            FINISHED,           // The oldest run completed a lap
+            IGNORED             // No run to finish or split, or too many runs on the course
+        };
+
+        struct Run {
+            uint32_t id;
+            uint32_t startMicros;
+            uint16_t confidence;
+            uint8_t splitsPassed;   // Bit n: passed split gate n
+        };
+
+        struct Result {
+            Event event;
+            uint32_t runId;
+            uint32_t startMicros;
+            uint32_t endMicros;     // Set for SPLIT_TIME and FINISHED
+            uint32_t lapMicros;     // Set for SPLIT_TIME (time since the start) and FINISHED
+            int split;              // Only set for SPLIT_TIME
+            uint16_t confidence;    // Lower of both crossings for FINISHED
+            int abandoned;          // Runs dropped for exceeding maxLapTime before this crossing
+        };
+
+        explicit LapTimer(const Parameters& params);
+
+        /// @brief Feed one confirmed gate crossing
+        /// @param micros Gate entry time
+        /// @param confidence Detector confidence of the crossing, 0-1000
+        /// @param split Number of the split gate, 0 to LAPTIMER_MAX_SPLITS - 1, only for SPLIT
+        Result crossing(uint32_t micros, uint16_t confidence, Role role = START_FINISH, int split = 0);
+
+        /// @brief Drop runs older than maxLapTime
+        /// @return Number of dropped runs
+        int expire(uint32_t nowMicros);
+
+        /// @brief Forget all open runs. Run ids keep counting up.
+        void clear();
+
+        int inFlight() const { return count; }
+        /// @brief Open run i, oldest first
+        const Run& run(int i) const { return runs[(head + i) % LAPTIMER_MAX_RUNS]; }
+
+        bool hasLastLap() const { return lastLapRun != 0; }
+        uint32_t lastLapRunId() const { return lastLapRun; }
+        uint32_t lastLapMicros() const { return lastLap; }
+        uint32_t abandonedRuns() const { return abandoned; }
+
+    private:
+        const Parameters& params;
+        Run runs[LAPTIMER_MAX_RUNS];
+        int head = 0;
+        int count = 0;
+        uint32_t nextId = 1;
+
+        uint32_t lastLapRun = 0;
+        uint32_t lastLap = 0;
+        uint32_t abandoned = 0;
+
+        void pop();
+        Result splitCrossing(uint32_t micros, int split, Result& result);
+};
+
+#endif
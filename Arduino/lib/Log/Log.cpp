@@ -0,0 +1,88 @@
+#include <stdio.h>
+#include <string.h>
+#include "Log.h"
+
+Logger logger;
+
+void Logger::begin(Clock& clock) {
+    this->clock = &clock;
+}
+
+bool Logger::addSink(EventSink& sink) {
+    if (sinkCount == LOG_MAX_SINKS)
+        return false;
+
+    sinks[sinkCount++] = &sink;
+    return true;
+}
+
+void Logger::write(LogLevel level, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    writev(level, format, args);
+    va_end(args);
+}
+
+void Logger::writev(LogLevel level, const char* format, va_list args) {
+    if (count == LOG_SLOTS) {
+        droppedTotal++;
+        droppedSinceFlush++;
+        return;
+    }
+
+    int index = head + count;
+    if (index >= LOG_SLOTS)
+        index -= LOG_SLOTS;
+
+    const uint32_t startMicros = clock != NULL ? clock->micros() : 0;
+    Slot& slot = slots[index];
+    slot.level = (uint8_t) level;
+    slot.millis = clock != NULL ? clock->millis() : 0;
+
+    const int length = vsnprintf(slot.text, sizeof(slot.text), format, args);
+    if (length >= (int) sizeof(slot.text))
+        truncatedTotal++;
+    if (clock != NULL)
+        formatLatency.record(clock->micros() - startMicros);
+
+    count++;
+    writtenTotal++;
+}
+
+bool Logger::sinksReady(size_t length) {
+    for (int i = 0; i < sinkCount; i++) {
+        if (!sinks[i] -> canSend(length))
+            return false;
+    }
+    return true;
+}
+
+int Logger::flush(int maxMessages) {
+    int sent = 0;
+
+    if (droppedSinceFlush > 0) {
+        char text[48];
+        snprintf(text, sizeof(text), "%u log messages dropped", (unsigned) droppedSinceFlush);
+        if (!sinksReady(strlen(text)))
+            return 0;
+
+        for (int i = 0; i < sinkCount; i++)
+            sinks[i] -> sendLog(text, WARNING, clock != NULL ? clock->millis() : 0);
+        droppedSinceFlush = 0;
+    }
+
+    while (count > 0 && sent < maxMessages) {
+        const Slot& slot = slots[head];
+        if (!sinksReady(strlen(slot.text)))
+            break;
+
+        for (int i = 0; i < sinkCount; i++)
+            sinks[i] -> sendLog(slot.text, slot.level, slot.millis);
+
+        head = head + 1 == LOG_SLOTS ? 0 : head + 1;
+        count--;
+        sent++;
+    }
+
+    return sent;
+}
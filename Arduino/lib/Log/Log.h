@@ -0,0 +1,98 @@
+#ifndef Log_H
+#define Log_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "Clock.h"
+#include "EventSink.h"
+#include "Metrics.h"
+
+enum LogLevel: int {
+    DEBUG = 0,
+    INFO = 1,
+    WARNING = 2,
+    ERROR = 3
+};
+
+// Messages below this level are compiled out entirely, e.g. -DLOG_COMPILE_LEVEL=1 drops all DEBUG logging
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL 0
+#endif
+
+const int LOG_SLOTS = 16;           // Messages waiting for the flush
+const int LOG_MESSAGE_SIZE = 96;    // Longer messages are truncated
+const int LOG_MAX_SINKS = 2;
+
+/// @brief Deferred logger.
+///
+/// Level checks happen before any formatting, so disabled messages cost a comparison. Enabled
+/// messages are formatted printf-style straight into a preallocated ring of fixed size slots and
+/// written to the sinks later by flush(), which is meant to run as a scheduler task. When the ring
+/// is full new messages are dropped and counted rather than blocking the caller.
+///
+/// Not thread safe. On the ESP8266 web server callbacks run between loop() iterations, not concurrently.
+class Logger {
+    public:
+        void begin(Clock& clock);
+        /// @return false if all sink slots are taken
+        bool addSink(EventSink& sink);
+
+        void setLevel(int level) { runtimeLevel = level; }
+        int level() const { return runtimeLevel; }
+        bool enabled(int level) const { return level >= runtimeLevel; }
+
+        /// @brief Format and queue a message. Use the LOG_* macros instead, they skip formatting for disabled levels.
+        void write(LogLevel level, const char* format, ...) __attribute__((format(printf, 3, 4)));
+        void writev(LogLevel level, const char* format, va_list args);
+
+        /// @brief Send up to maxMessages queued messages to the sinks. Stops early if a sink is busy.
+        /// @return Number of messages sent
+        int flush(int maxMessages = LOG_SLOTS);
+
+        int pending() const { return count; }
+        uint32_t dropped() const { return droppedTotal; }
+        uint32_t truncated() const { return truncatedTotal; }
+        uint32_t written() const { return writtenTotal; }
+        /// @brief Time to format messages into the ring, the part logging costs the caller
+        const LatencyHistogram& writeLatency() const { return formatLatency; }
+
+    private:
+        struct Slot {
+            uint32_t millis;
+            uint8_t level;
+            char text[LOG_MESSAGE_SIZE];
+        };
+
+        Clock* clock = NULL;
+        EventSink* sinks[LOG_MAX_SINKS];
+        int sinkCount = 0;
+        int runtimeLevel = INFO;
+
+        Slot slots[LOG_SLOTS];
+        int head = 0;       // oldest queued message
+        int count = 0;
+
+        uint32_t droppedTotal = 0;
+        uint32_t droppedSinceFlush = 0;
+        uint32_t truncatedTotal = 0;
+        uint32_t writtenTotal = 0;
+        LatencyHistogram formatLatency;
+
+        bool sinksReady(size_t length);
+};
+
+extern Logger logger;
+
+#define LOG_AT(level, ...) \
+    do { \
+        if ((level) >= LOG_COMPILE_LEVEL && logger.enabled(level)) \
+            logger.write(level, __VA_ARGS__); \
+    } while (0)
+
+#define LOG_DEBUG(...) LOG_AT(DEBUG, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(INFO, __VA_ARGS__)
+#define LOG_WARNING(...) LOG_AT(WARNING, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(ERROR, __VA_ARGS__)
+
+#endif
@@ -0,0 +1,24 @@
+#include "Metrics.h"
+
+const uint32_t LATENCY_BUCKET_MICROS[LATENCY_BUCKETS] = {
+    10, 25, 50, 100, 250, 500, 1000, 2500, 10000, 50000
+};
+
+void LatencyHistogram::record(uint32_t micros) {
+    int bucket = 0;
+    while (bucket < LATENCY_BUCKETS && micros > LATENCY_BUCKET_MICROS[bucket])
+        bucket++;
+
+    counts[bucket]++;
+    total++;
+    sum += micros;
+    if (micros > longest)
+        longest = micros;
+}
+
+uint32_t LatencyHistogram::cumulative(int bucket) const {
+    uint32_t result = 0;
+    for (int i = 0; i <= bucket; i++)
+        result += counts[i];
+    return result;
+}
@@ -0,0 +1,49 @@
+#ifndef Metrics_H
+#define Metrics_H
+
+#include <stdint.h>
+#include "Clock.h"
+
+const int LATENCY_BUCKETS = 10;
+
+/// @brief Upper bounds of the histogram buckets in usec, from a fast detector step to a flash write
+extern const uint32_t LATENCY_BUCKET_MICROS[LATENCY_BUCKETS];
+
+/// @brief Fixed bucket latency histogram. Recording is a few compares and adds, cheap enough to
+/// leave on in the hot path. Counts wrap at 2^32.
+class LatencyHistogram {
+    public:
+        void record(uint32_t micros);
+
+        /// @return Durations up to LATENCY_BUCKET_MICROS[bucket], cumulative as Prometheus expects
+        uint32_t cumulative(int bucket) const;
+        uint32_t count() const { return total; }
+        uint64_t sumMicros() const { return sum; }
+        uint32_t maxMicros() const { return longest; }
+
+    private:
+        uint32_t counts[LATENCY_BUCKETS + 1] = {};   // The last one is above all bounds
+        uint32_t total = 0;
+        uint64_t sum = 0;
+        uint32_t longest = 0;
+};
+
+/// @brief Records the time from construction to the end of the scope
+///
+///     {
+///         LatencyTimer timer(clock, detectionLatency);
+///         detector.update(reading, now);
+///     }
+class LatencyTimer {
+    public:
+        LatencyTimer(Clock& clock, LatencyHistogram& histogram) :
+            clock(clock), histogram(histogram), startMicros(clock.micros()) {}
+        ~LatencyTimer() { histogram.record(clock.micros() - startMicros); }
+
+    private:
+        Clock& clock;
+        LatencyHistogram& histogram;
+        uint32_t startMicros;
+};
+
+#endif
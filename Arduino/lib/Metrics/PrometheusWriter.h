@@ -0,0 +1,97 @@
+#ifndef PrometheusWriter_H
+#define PrometheusWriter_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "Metrics.h"
+
+/// @brief Streams metrics in the Prometheus text exposition format (version 0.0.4).
+/// Output is anything with `size_t write(const uint8_t* data, size_t length)`, like for JsonWriter.
+/// Durations are written in seconds, the Prometheus base unit, without floating point.
+///
+///     metrics.family("laptimer_triggers_total", "counter", "Confirmed gate crossings")
+///         .sample("laptimer_triggers_total", "gate", "start", 12);
+template <typename Output>
+class PrometheusWriter {
+    public:
+        explicit PrometheusWriter(Output& out) : out(out) {}
+
+        /// @brief HELP and TYPE lines, write them once before the samples of a metric
+        /// @param type "counter", "gauge" or "histogram"
+        PrometheusWriter& family(const char* name, const char* type, const char* help) {
+            text("# HELP "); text(name); text(" "); text(help); text("\n");
+            text("# TYPE "); text(name); text(" "); text(type); text("\n");
+            return *this;
+        }
+
+        PrometheusWriter& sample(const char* name, uint32_t value) {
+            return sample(name, NULL, NULL, value);
+        }
+
+        /// @param label Label name, NULL for none
+        PrometheusWriter& sample(const char* name, const char* label, const char* labelValue, uint32_t value) {
+            text(name);
+            labels(label, labelValue, NULL);
+            char number[16];
+            snprintf(number, sizeof(number), " %lu\n", (unsigned long) value);
+            return text(number);
+        }
+
+        /// @brief The _bucket, _sum and _count samples of a histogram, after family(name, "histogram", ...)
+        PrometheusWriter& histogram(const char* name, const char* label, const char* labelValue, const LatencyHistogram& histogram) {
+            char bound[16];
+            for (int i = 0; i <= LATENCY_BUCKETS; i++) {
+                if (i < LATENCY_BUCKETS)
+                    seconds(bound, sizeof(bound), LATENCY_BUCKET_MICROS[i]);
+                else
+                    strcpy(bound, "+Inf");
+                text(name); text("_bucket");
+                labels(label, labelValue, bound);
+                char number[16];
+                snprintf(number, sizeof(number), " %lu\n", (unsigned long) histogram.cumulative(i));
+                text(number);
+            }
+
+            char sum[24];
+            seconds(sum, sizeof(sum), histogram.sumMicros());
+            text(name); text("_sum");
+            labels(label, labelValue, NULL);
+            text(" "); text(sum); text("\n");
+
+            text(name); text("_count");
+            labels(label, labelValue, NULL);
+            char number[16];
+            snprintf(number, sizeof(number), " %lu\n", (unsigned long) histogram.count());
+            return text(number);
+        }
+
+    private:
+        Output& out;
+
+        PrometheusWriter& text(const char* value) {
+            out.write((const uint8_t*) value, strlen(value));
+            return *this;
+        }
+
+        /// @brief {label="value",le="bound"}, whichever are given
+        void labels(const char* label, const char* labelValue, const char* le) {
+            if (label == NULL && le == NULL)
+                return;
+            text("{");
+            if (label != NULL) {
+                text(label); text("=\""); text(labelValue); text("\"");
+            }
+            if (le != NULL) {
+                text(label != NULL ? ",le=\"" : "le=\""); text(le); text("\"");
+            }
+            text("}");
+        }
+
+        static void seconds(char* out, size_t size, uint64_t micros) {
+            // No 64 bit printf on every libc of the board, the seconds fit into 32 bits for 136 years
+            snprintf(out, size, "%lu.%06lu", (unsigned long) (micros / 1000000), (unsigned long) (micros % 1000000));
+        }
+};
+
+#endif
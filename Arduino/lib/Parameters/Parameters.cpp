@@ -0,0 +1,102 @@
+#include "Parameters.h"
+#include <string.h>
+
+constexpr ParameterField PARAMETER_FIELDS[] = {
+    {"afterDetectionDelay", &Parameters::afterDetectionDelay, PARAMETER_NUMBER, MIN_AFTER_DETECTION_DELAY, MAX_AFTER_DETECTION_DELAY, 1, 2000, true},
+    {"baselineEstimator", &Parameters::baselineEstimator, PARAMETER_CHOICE, BASELINE_MEAN, BASELINE_HAMPEL, 1, BASELINE_MEAN, true},
+    {"batteryCapacity", &Parameters::batteryCapacity, PARAMETER_NUMBER, 0, MAX_BATTERY_CAPACITY, 100, 10000, false},
+    {"burstHold", &Parameters::burstHold, PARAMETER_NUMBER, 0, MAX_BURST_HOLD, 100, 1000, false},
+    {"delay", &Parameters::delay, PARAMETER_NUMBER, MIN_DELAY, MAX_DELAY, STEP, 100, false},
+    {"detectionMethod", &Parameters::detectionMethod, PARAMETER_CHOICE, DETECTION_PERCENT, DETECTION_STATISTICAL, 1, DETECTION_PERCENT, true},
+    {"detectionSize", &Parameters::detectionSize, PARAMETER_NUMBER, 1, MAX_DETECTION_SIZE, 1, 5, true},
+    {"logLevel", &Parameters::logLevel, PARAMETER_CHOICE, MIN_LOG_LEVEL, MAX_LOG_LEVEL, 1, 1, false},
+    {"maxLapTime", &Parameters::maxLapTime, PARAMETER_NUMBER, MIN_LAP_TIME, MAX_LAP_TIME, 100, 300000, false},
+    {"minLapTime", &Parameters::minLapTime, PARAMETER_NUMBER, MIN_LAP_TIME, MAX_LAP_TIME, 100, 10000, false},
+    {"percentDiffTrigger", &Parameters::percentDiffTrigger, PARAMETER_NUMBER, MIN_PERCENT_DIFF_TRIGGER, MAX_PERCENT_DIFF_TRIGGER, 1, 30, true},
+    {"powerMode", &Parameters::powerMode, PARAMETER_CHOICE, POWER_PERFORMANCE, POWER_SAVING, 1, POWER_PERFORMANCE, false},
+    {"windowSize", &Parameters::windowSize, PARAMETER_NUMBER, 1, MAX_WINDOW_SIZE, 1, 20, true},
+    {"zScoreTrigger", &Parameters::zScoreTrigger, PARAMETER_NUMBER, MIN_Z_SCORE_TRIGGER, MAX_Z_SCORE_TRIGGER, 1, 5, true},
+};
+
+const int PARAMETER_FIELD_COUNT = sizeof(PARAMETER_FIELDS) / sizeof(PARAMETER_FIELDS[0]);
+
+/// @brief strncmp of a terminated name against a key of the given length, usable at compile time
+static constexpr int compareName(const char* name, const char* key, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (name[i] != key[i])
+            return name[i] == '\0' || (unsigned char) name[i] < (unsigned char) key[i] ? -1 : 1;
+    }
+    return name[length] == '\0' ? 0 : 1;
+}
+
+static constexpr size_t nameLength(const char* name) {
+    size_t length = 0;
+    while (name[length] != '\0')
+        length++;
+    return length;
+}
+
+static constexpr bool tableIsValid() {
+    for (const ParameterField& field : PARAMETER_FIELDS) {
+        if (field.min > field.max || field.step < 1)
+            return false;
+        if (field.defaultValue < field.min || field.defaultValue > field.max)
+            return false;
+    }
+    for (int i = 1; i < PARAMETER_FIELD_COUNT; i++) {
+        const char* previous = PARAMETER_FIELDS[i - 1].name;
+        const char* name = PARAMETER_FIELDS[i].name;
+        if (compareName(previous, name, nameLength(name)) >= 0)
+            return false;
+    }
+    // Together with the count below, every member has exactly one entry
+    for (int i = 0; i < PARAMETER_FIELD_COUNT; i++) {
+        for (int j = i + 1; j < PARAMETER_FIELD_COUNT; j++) {
+            if (PARAMETER_FIELDS[i].value == PARAMETER_FIELDS[j].value)
+                return false;
+        }
+    }
+    return true;
+}
+
+static_assert(tableIsValid(), "PARAMETER_FIELDS must be sorted by name, with defaults within the bounds and one entry per member");
+static_assert(sizeof(PARAMETER_FIELDS) / sizeof(PARAMETER_FIELDS[0]) == sizeof(Parameters) / sizeof(int),
+              "Every member of Parameters needs a PARAMETER_FIELDS entry");
+
+Parameters::Parameters() {
+    for (const ParameterField& field : PARAMETER_FIELDS)
+        this->*field.value = field.defaultValue;
+}
+
+bool Parameters::set(const ParameterField& field, long value) {
+    if (value < field.min || value > field.max)
+        return false;
+
+    this->*field.value = (int) value;
+    return true;
+}
+
+bool Parameters::set(const char* name, long value) {
+    const ParameterField* field = findParameter(name);
+    return field != NULL && set(*field, value);
+}
+
+const ParameterField* findParameter(const char* name, size_t length) {
+    int low = 0;
+    int high = PARAMETER_FIELD_COUNT - 1;
+    while (low <= high) {
+        const int middle = (low + high) / 2;
+        const int order = compareName(PARAMETER_FIELDS[middle].name, name, length);
+        if (order == 0)
+            return &PARAMETER_FIELDS[middle];
+        if (order < 0)
+            low = middle + 1;
+        else
+            high = middle - 1;
+    }
+    return NULL;
+}
+
+const ParameterField* findParameter(const char* name) {
+    return findParameter(name, strlen(name));
+}
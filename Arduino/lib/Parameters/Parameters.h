@@ -0,0 +1,102 @@
+#ifndef Parameters_H
+#define Parameters_H
+
+#include <stddef.h>
+
+// Bounds for the tunables. Window storage is preallocated, so the window sizes are capped.
+const int MIN_DELAY = 50;               // Minimum ranging delay
+const int MAX_DELAY = 500;              // Max ranging delay
+const int STEP = 10;                    // valid stepping interval in msec
+const int MAX_WINDOW_SIZE = 100;        // Upper bound for WINDOW_SIZE
+const int MAX_DETECTION_SIZE = 20;      // Upper bound for DETECTION_SIZE
+const int MIN_PERCENT_DIFF_TRIGGER = 1;
+const int MAX_PERCENT_DIFF_TRIGGER = 99;
+const int MIN_AFTER_DETECTION_DELAY = 500;
+const int MAX_AFTER_DETECTION_DELAY = 3000;
+const int MAX_BURST_HOLD = 10000;
+const int MIN_Z_SCORE_TRIGGER = 3;      // Standard deviations
+const int MAX_Z_SCORE_TRIGGER = 50;
+const int MIN_LAP_TIME = 1000;
+const int MAX_LAP_TIME = 600000;
+const int MIN_LOG_LEVEL = 0;            // DEBUG
+const int MAX_LOG_LEVEL = 3;            // ERROR
+const int MAX_BATTERY_CAPACITY = 100000; // mAh
+
+/// @brief How the detector decides a reading deviates from the baseline
+enum DetectionMethod {
+    DETECTION_PERCENT,                  // Fixed percentage, percentDiffTrigger
+    DETECTION_STATISTICAL               // Multiple of the measured noise, zScoreTrigger
+};
+
+/// @brief Baseline of the percent detection method
+enum BaselineEstimator {
+    BASELINE_MEAN,                      // Rolling window average
+    BASELINE_MEDIAN,                    // Rolling window median
+    BASELINE_HAMPEL                     // Rolling window average of Hampel filtered readings
+};
+
+/// @brief Radio and idle behaviour
+enum PowerMode {
+    POWER_PERFORMANCE,                  // Full transmit power, everything keeps running while stopped
+    POWER_SAVING                        // Lower transmit power and longer beacon interval, deep idle while stopped
+};
+
+enum ParameterType {
+    PARAMETER_NUMBER,
+    PARAMETER_CHOICE                    // One of an enum's values, min to max
+};
+
+struct ParameterField;
+
+/// @brief All user tunable settings. PARAMETER_FIELDS describes each of them, with its default and
+/// bounds. set() validates against those and leaves the value untouched on invalid input.
+struct Parameters {
+    int delay;                          // msec to delay between readings while nothing is happening
+    int burstHold;                      // msec to keep ranging at the maximum rate after a deviating reading, 0 = off
+    int windowSize;
+    int detectionSize;
+    int percentDiffTrigger;             // If a reading is this % different from before, treat this as a potential trigger
+    int baselineEstimator;              // BaselineEstimator
+    int detectionMethod;                // DetectionMethod
+    int zScoreTrigger;                  // Statistical method: standard deviations of the baseline noise that count as a deviation
+    int afterDetectionDelay;            // Delay after detecting something moving across barrier
+    int minLapTime;                     // msec, a crossing earlier than this after a start is another bike starting
+    int maxLapTime;                     // msec, runs still open after this are dropped
+    int logLevel;
+    int powerMode;                      // PowerMode
+    int batteryCapacity;                // mAh of the power bank for the runtime estimate, 0 = unknown
+
+    /// @brief All settings at their defaults
+    Parameters();
+
+    /// @return false if value is out of the field's bounds
+    bool set(const ParameterField& field, long value);
+    /// @return false for unknown names and out of range values
+    bool set(const char* name, long value);
+};
+
+/// @brief Describes one tunable: JSON name, storage, bounds and default. Validation, the config API
+/// and its schema, and the settings file are all generated from PARAMETER_FIELDS, so a new setting
+/// is a member above plus one line in the table.
+struct ParameterField {
+    const char* name;
+    int Parameters::* value;
+    ParameterType type;
+    int min;
+    int max;
+    int step;                           // Input granularity for the web page, not enforced
+    int defaultValue;
+    bool restartsDetector;              // Changing it invalidates the detector's windows
+};
+
+/// @brief Sorted by name, checked at compile time
+extern const ParameterField PARAMETER_FIELDS[];
+extern const int PARAMETER_FIELD_COUNT;
+
+/// @brief Binary search of PARAMETER_FIELDS
+/// @param length Length of name, which need not be terminated
+/// @return NULL for unknown names
+const ParameterField* findParameter(const char* name, size_t length);
+const ParameterField* findParameter(const char* name);
+
+#endif
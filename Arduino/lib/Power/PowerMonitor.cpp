@@ -0,0 +1,34 @@
+#include "PowerMonitor.h"
+
+PowerMonitor::PowerMonitor(Clock& clock) : clock(clock) {
+    periodStartMicros = clock.micros();
+}
+
+void PowerMonitor::sleep(uint32_t ms) {
+    const uint32_t startMicros = clock.micros();
+    clock.delay(ms);
+    sleptMicros += clock.micros() - startMicros;
+}
+
+void PowerMonitor::update() {
+    const uint32_t elapsedMicros = clock.micros() - periodStartMicros;
+    if (elapsedMicros < POWER_PERIOD_MICROS)
+        return;
+
+    const uint32_t slept = sleptMicros < elapsedMicros ? sleptMicros : elapsedMicros;
+    dutyPermille = (int) ((uint64_t) (elapsedMicros - slept) * 1000 / elapsedMicros);
+    periodStartMicros += elapsedMicros;
+    sleptMicros = 0;
+}
+
+int PowerMonitor::estimatedMilliamps(bool saving) const {
+    return POWER_BOARD_MA + (saving ? POWER_RADIO_SAVING_MA : POWER_RADIO_MA) + POWER_CPU_MA * dutyPermille / 1000;
+}
+
+uint32_t PowerMonitor::batteryMinutes(int capacityMah, bool saving) const {
+    if (capacityMah <= 0)
+        return 0;
+
+    const uint32_t cellMilliamps = (uint32_t) estimatedMilliamps(saving) * POWER_BANK_FACTOR_PERCENT / 100;
+    return (uint32_t) capacityMah * 60 / cellMilliamps;
+}
@@ -0,0 +1,54 @@
+#ifndef PowerMonitor_H
+#define PowerMonitor_H
+
+#include <stdint.h>
+#include "Clock.h"
+
+const uint32_t POWER_PERIOD_MICROS = 10000000;  // Duty cycle measurement period
+
+// Rough NodeMCU figures, from the ESP8266 datasheet and typical boards. They only feed the estimate.
+const int POWER_BOARD_MA = 12;          // Regulator, USB serial chip and ultrasonic ranger
+const int POWER_RADIO_MA = 60;          // Soft-AP: the receiver never sleeps, beacons at 20.5 dBm every 100 msec
+const int POWER_RADIO_SAVING_MA = 56;   // The same at POWER_SAVING_TX_DBM with POWER_SAVING_BEACON_MILLIS
+const int POWER_CPU_MA = 15;            // CPU running instead of waiting in delay()
+// A power bank's mAh are at its 3.7 V cells. Its 5 V boost converter (~85%) feeds the board's linear
+// regulator, which draws the same current as the board: 5 / 3.7 / 0.85 = 1.59.
+const int POWER_BANK_FACTOR_PERCENT = 159;
+
+// Power saving settings of the soft-AP
+const float POWER_SAVING_TX_DBM = 10;            // Plenty for phones next to the course
+const float POWER_FULL_TX_DBM = 20.5;
+const int POWER_SAVING_BEACON_MILLIS = 300;
+const int POWER_FULL_BEACON_MILLIS = 100;
+
+/// @brief Measures how much of the time the CPU is awake and estimates the current draw.
+///
+/// loop() sleeps through sleep() instead of Clock::delay(), everything else counts as awake. The soft-AP
+/// keeps the receiver on, so the radio draws about the same whatever the CPU does; the CPU part of
+/// the estimate follows the measured duty cycle.
+class PowerMonitor {
+    public:
+        explicit PowerMonitor(Clock& clock);
+
+        /// @brief Clock::delay() that counts as idle time
+        void sleep(uint32_t ms);
+        /// @brief Close the measurement period once POWER_PERIOD_MICROS are over. Call from loop().
+        void update();
+
+        /// @return Share of the last period the CPU was awake, in permille
+        int dutyCyclePermille() const { return dutyPermille; }
+        /// @param saving Whether the soft-AP runs with the power saving settings
+        /// @return Estimated board current in mA
+        int estimatedMilliamps(bool saving) const;
+        /// @param capacityMah Power bank capacity, 0 if unknown
+        /// @return Estimated runtime on a full power bank in minutes, 0 if unknown
+        uint32_t batteryMinutes(int capacityMah, bool saving) const;
+
+    private:
+        Clock& clock;
+        uint32_t periodStartMicros;
+        uint32_t sleptMicros = 0;
+        int dutyPermille = 1000;
+};
+
+#endif
@@ -0,0 +1,137 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Replay.h"
+
+static long distance(uint32_t lhs, uint32_t rhs) {
+    return lhs > rhs ? (long) (lhs - rhs) : (long) (rhs - lhs);
+}
+
+Replayer::Replayer(const Parameters& params, const GroundTruthLap* truth, size_t truthCount,
+                   ReplayLapCallback onLap, void* context) :
+    params(params), detector(params), timer(params), truth(truth), truthCount(truthCount),
+    onLap(onLap), context(context) {}
+
+void Replayer::add(const TraceSample& sample) {
+    const uint32_t nowMillis = (uint32_t) (sample.micros / 1000);
+    report.samples++;
+    report.traceMicros = sample.micros;
+    if (sample.event == Detector::TRIGGER)
+        report.recordedTriggers++;
+
+    if (holdoff && nowMillis < holdoffUntil)
+        return;
+    holdoff = false;
+
+    const Detector::Result result = detector.update(sample.distance, (uint32_t) sample.micros);
+
+    if (result.event == Detector::FLUKE) {
+        report.flukes++;
+    } else if (result.event == Detector::TRIGGER) {
+        report.triggers++;
+        holdoff = true;
+        holdoffUntil = nowMillis + params.afterDetectionDelay;
+
+        const LapTimer::Result crossing = timer.crossing(result.crossingMicros, result.confidence);
+        report.abandoned += crossing.abandoned;
+        if (crossing.event == LapTimer::FINISHED)
+            lap(sample, crossing);
+    }
+}
+
+void Replayer::lap(const TraceSample& sample, const LapTimer::Result& crossing) {
+    report.detected++;
+
+    // The detector works on wrapping 32 bit usec, map its timestamps back onto the trace
+    ReplayLap lap = {};
+    const uint64_t endMicros = sample.micros - (uint32_t) ((uint32_t) sample.micros - crossing.endMicros);
+    lap.runId = crossing.runId;
+    lap.endMillis = (uint32_t) (endMicros / 1000);
+    lap.startMillis = (uint32_t) ((endMicros - crossing.lapMicros) / 1000);
+    lap.lapMicros = crossing.lapMicros;
+
+    // Annotated laps that ended well before this one can no longer be matched
+    while (nextTruth < truthCount && truth[nextTruth].endMillis + REPLAY_MATCH_TOLERANCE_MILLIS < lap.endMillis) {
+        report.missed++;
+        nextTruth++;
+    }
+
+    if (nextTruth < truthCount &&
+        distance(truth[nextTruth].startMillis, lap.startMillis) <= (long) REPLAY_MATCH_TOLERANCE_MILLIS &&
+        distance(truth[nextTruth].endMillis, lap.endMillis) <= (long) REPLAY_MATCH_TOLERANCE_MILLIS) {
+        lap.matched = true;
+        lap.errorMicros = (long) lap.lapMicros - (long) (truth[nextTruth].endMillis - truth[nextTruth].startMillis) * 1000;
+        report.matched++;
+        report.absErrorSum += labs(lap.errorMicros);
+        if (labs(lap.errorMicros) > report.maxAbsError)
+            report.maxAbsError = labs(lap.errorMicros);
+        nextTruth++;
+    } else {
+        report.falseLaps++;
+    }
+
+    if (onLap != NULL)
+        onLap(lap, context);
+}
+
+const ReplayReport& Replayer::finish() {
+    report.missed += truthCount - nextTruth;
+    nextTruth = truthCount;
+    return report;
+}
+
+ReplayReport replayTrace(TraceReader& trace, const Parameters& params,
+                         const GroundTruthLap* truth, size_t truthCount,
+                         ReplayLapCallback onLap, void* context) {
+    Replayer replayer(params, truth, truthCount, onLap, context);
+    TraceSample sample;
+    while (trace.next(sample))
+        replayer.add(sample);
+    return replayer.finish();
+}
+
+const ParameterField* parseParameterFlag(const char* arg, const char** value) {
+    const char* equals = strchr(arg, '=');
+    if (strncmp(arg, "--", 2) != 0 || equals == NULL)
+        return NULL;
+
+    // --kebab-case to camelCase
+    char name[32];
+    size_t length = 0;
+    for (const char* c = arg + 2; c < equals && length < sizeof(name) - 1; c++) {
+        if (*c == '-' && c + 1 < equals)
+            name[length++] = (char) toupper(*++c);
+        else
+            name[length++] = *c;
+    }
+    *value = equals + 1;
+    return findParameter(name, length);
+}
+
+size_t parseGroundTruth(const char* text, GroundTruthLap* out, size_t max) {
+    size_t count = 0;
+
+    while (*text != '\0' && count < max) {
+        char line[64];
+        size_t length = 0;
+        while (*text != '\0' && *text != '\n') {
+            if (length < sizeof(line) - 1)
+                line[length++] = *text;
+            text++;
+        }
+        line[length] = '\0';
+        if (*text == '\n')
+            text++;
+
+        unsigned long start;
+        unsigned long end;
+        if (line[0] != '#' && sscanf(line, "%lu %lu", &start, &end) == 2) {
+            out[count].startMillis = (uint32_t) start;
+            out[count].endMillis = (uint32_t) end;
+            count++;
+        }
+    }
+
+    return count;
+}
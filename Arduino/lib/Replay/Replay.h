@@ -0,0 +1,95 @@
+#ifndef Replay_H
+#define Replay_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Detector.h"
+#include "LapTimer.h"
+#include "Parameters.h"
+#include "Trace.h"
+
+/// @brief Annotated lap, msec since trace start. Both timestamps are the moment the bike enters the gate.
+struct GroundTruthLap {
+    uint32_t startMillis;
+    uint32_t endMillis;
+};
+
+/// @brief Detected laps further than this from a ground truth lap do not match it
+const uint32_t REPLAY_MATCH_TOLERANCE_MILLIS = 1500;
+
+struct ReplayLap {
+    uint32_t runId;
+    uint32_t startMillis;   // msec since trace start
+    uint32_t endMillis;
+    uint32_t lapMicros;
+    bool matched;           // Matched a ground truth lap
+    long errorMicros;       // Detected minus annotated lap time, only valid if matched
+};
+
+struct ReplayReport {
+    uint32_t samples = 0;
+    uint64_t traceMicros = 0;   // Time span covered by the trace
+    uint32_t triggers = 0;      // Confirmed triggers, i.e. gate crossings
+    uint32_t flukes = 0;        // Potential triggers the detection window rejected
+    uint32_t recordedTriggers = 0;  // Triggers the board detected, traces with TRACE_FLAG_STATE only
+    uint32_t detected = 0;      // Laps
+    uint32_t abandoned = 0;     // Runs without a finish within maxLapTime
+    uint32_t matched = 0;
+    uint32_t missed = 0;        // Annotated laps without a detected lap
+    uint32_t falseLaps = 0;     // Detected laps without an annotated lap
+    long long absErrorSum = 0;  // usec, over matched laps
+    long maxAbsError = 0;       // usec
+
+    double meanAbsErrorMillis() const { return matched > 0 ? (double) absErrorSum / matched / 1000 : 0; }
+    double maxAbsErrorMillis() const { return maxAbsError / 1000.0; }
+};
+
+typedef void (*ReplayLapCallback)(const ReplayLap& lap, void* context);
+
+/// @brief Drives the detector with trace samples one at a time, as fast as possible.
+///
+/// Crossings are paired into laps by a LapTimer, as on the board. Samples that fall into the holdoff
+/// after a crossing (afterDetectionDelay) are skipped, like the firmware would not have taken them.
+/// Detected laps are matched in order against the ground truth.
+class Replayer {
+    public:
+        /// @param truth Annotated laps sorted by end time, may be NULL. Must outlive the replayer.
+        /// @param onLap Called for every detected lap, may be NULL
+        Replayer(const Parameters& params, const GroundTruthLap* truth, size_t truthCount,
+                 ReplayLapCallback onLap = NULL, void* context = NULL);
+
+        void add(const TraceSample& sample);
+        /// @brief Count the annotated laps that were never detected. Call once, after the last sample.
+        const ReplayReport& finish();
+
+    private:
+        const Parameters& params;
+        Detector detector;
+        LapTimer timer;
+        const GroundTruthLap* truth;
+        size_t truthCount;
+        size_t nextTruth = 0;
+        ReplayLapCallback onLap;
+        void* context;
+        bool holdoff = false;
+        uint32_t holdoffUntil = 0;
+        ReplayReport report;
+
+        void lap(const TraceSample& sample, const LapTimer::Result& crossing);
+};
+
+/// @brief Replay every sample of a trace, see Replayer
+ReplayReport replayTrace(TraceReader& trace, const Parameters& params,
+                         const GroundTruthLap* truth, size_t truthCount,
+                         ReplayLapCallback onLap = NULL, void* context = NULL);
+
+/// @brief Find the setting of a command line flag, e.g. --window-size=30 for windowSize
+/// @param value Receives the text after '='
+/// @return NULL if arg is no --name=value flag of a known setting
+const ParameterField* parseParameterFlag(const char* arg, const char** value);
+
+/// @brief Parse ground truth annotations: one lap per line, "<start msec> <end msec>". '#' starts a comment.
+/// @return Number of laps parsed, at most max
+size_t parseGroundTruth(const char* text, GroundTruthLap* out, size_t max);
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef HampelFilter_H
+#define HampelFilter_H
+
+#include <stddef.h>
+#include "RollingMedian.h"
+
+/// @brief Sliding window Hampel outlier filter, O(log N) per value.
+///
+/// A value further than k scaled median absolute deviations (MAD) from the window median is an
+/// outlier and replaced by the median. The MAD is itself a sliding median, of each value's distance
+/// to the median at the time it arrived, so it lags the exact MAD a little but stays O(log N).
+/// The window sees every raw value, outliers included, so a lasting change is accepted once it
+/// fills half the window.
+/// @tparam T Element type, signed
+/// @tparam N Maximum window size
+template <typename T, size_t N>
+class HampelFilter {
+    private:
+        RollingMedian<T, N> values;
+        RollingMedian<T, N> deviations;
+        int k;
+        T minDeviation;
+
+    public:
+        /// @param size Window size, clamped to [1, N]
+        /// @param k Outlier threshold in scaled MADs, 3 is the usual choice
+        /// @param minDeviation Floor for the scaled MAD, so a window of equal values does not turn
+        /// every small step into an outlier. E.g. the sensor resolution.
+        explicit HampelFilter(size_t size = N, int k = 3, T minDeviation = 1) :
+            values(size), deviations(size), k(k), minDeviation(minDeviation) {}
+
+        /// @brief Add a value to the window
+        /// @return The value, or the window median if the value is an outlier
+        T filter(T value) {
+            const T median = values.size() > 0 ? values.median() : value;
+            const T deviation = value < median ? median - value : value - median;
+            values.append(value);
+            deviations.append(deviation);
+            return isOutlier(deviation) ? median : value;
+        }
+
+        /// @brief Whether a value this far from the median would be an outlier.
+        /// Needs a few values in the window before anything counts as one.
+        bool isOutlier(T deviation) const {
+            if (values.size() < 3)
+                return false;
+            // 1.4826 * MAD estimates the standard deviation of normally distributed values
+            T scaled = (T) (deviations.median() * 14826L / 10000);
+            if (scaled < minDeviation)
+                scaled = minDeviation;
+            return deviation > (T) (k * scaled);
+        }
+
+        T median() const { return values.median(); }
+
+        /// @brief Drop all values. The window size is kept.
+        void clear() {
+            values.clear();
+            deviations.clear();
+        }
+
+        /// @brief Change the window size. Drops all values.
+        size_t resize(size_t size) {
+            deviations.resize(size);
+            return values.resize(size);
+        }
+
+        size_t size() const { return values.size(); }
+        bool isFull() const { return values.isFull(); }
+};
+
+#endif
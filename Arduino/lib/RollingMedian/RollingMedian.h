@@ -0,0 +1,176 @@
+#ifndef RollingMedian_H
+#define RollingMedian_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// @brief Fixed-capacity sliding window median, O(log N) per append.
+///
+/// The window is a ring buffer, and a double heap is built over its slot indices: a max-heap of the
+/// lower half and a min-heap of the upper half, meeting at the median. Each slot knows its heap
+/// position, so the element evicted by an append is replaced in place and sifted up or down
+/// instead of being searched for. Storage is sized at compile time, nothing is allocated.
+/// @tparam T Element type, compared with <
+/// @tparam N Maximum window size, at most 32767
+template <typename T, size_t N>
+class RollingMedian {
+    static_assert(N > 0 && N <= 32767, "RollingMedian needs a capacity of 1 to 32767 elements");
+
+    private:
+        T data[N];
+        int16_t position[N];    // Heap position of each slot: < 0 lower half, 0 median, > 0 upper half
+        uint16_t heapStorage[N];
+        size_t center = 0;      // heapStorage index of heap position 0, the median
+        size_t next = 0;        // Slot the next append overwrites
+        size_t count = 0;
+        size_t maxSize = N;
+
+        // Elements in the upper (min) and lower (max) heap, not counting the median
+        int upperCount() const { return ((int) count - 1) / 2; }
+        int lowerCount() const { return (int) count / 2; }
+
+        // Slot at heap position i. An index rather than a pointer, so the window can be copied.
+        uint16_t& heap(int i) { return heapStorage[(int) center + i]; }
+        uint16_t heap(int i) const { return heapStorage[(int) center + i]; }
+
+        bool less(int i, int j) const {
+            return data[heap(i)] < data[heap(j)];
+        }
+
+        bool exchange(int i, int j) {
+            const uint16_t slot = heap(i);
+            heap(i) = heap(j);
+            heap(j) = slot;
+            position[heap(i)] = (int16_t) i;
+            position[heap(j)] = (int16_t) j;
+            return true;
+        }
+
+        // Swap if heap(i) < heap(j), returns whether it did
+        bool exchangeIfLess(int i, int j) {
+            return less(i, j) && exchange(i, j);
+        }
+
+        void upperSortDown(int i) {
+            for (; i <= upperCount(); i *= 2) {
+                if (i > 1 && i < upperCount() && less(i + 1, i))
+                    i++;
+                if (!exchangeIfLess(i, i / 2))
+                    break;
+            }
+        }
+
+        void lowerSortDown(int i) {
+            for (; i >= -lowerCount(); i *= 2) {
+                if (i < -1 && i > -lowerCount() && less(i, i - 1))
+                    i--;
+                if (!exchangeIfLess(i / 2, i))
+                    break;
+            }
+        }
+
+        // Returns true if the element reached the median position
+        bool upperSortUp(int i) {
+            while (i > 0 && exchangeIfLess(i, i / 2))
+                i /= 2;
+            return i == 0;
+        }
+
+        bool lowerSortUp(int i) {
+            while (i < 0 && exchangeIfLess(i / 2, i))
+                i /= 2;
+            return i == 0;
+        }
+
+    public:
+        /// @param size Initial window size, clamped to [1, N]
+        explicit RollingMedian(size_t size = N) {
+            resize(size);
+        }
+
+        /// @brief Append a value, evicting the oldest one if the window is full
+        /// @return The appended value
+        T append(T value) {
+            const bool grows = count < maxSize;
+            const int p = position[next];
+            const T old = data[next];
+            data[next] = value;
+            next = next + 1 == maxSize ? 0 : next + 1;
+            if (grows)
+                count++;
+
+            if (p > 0) {
+                // Slot is in the upper half
+                if (!grows && old < value)
+                    upperSortDown(p * 2);
+                else if (upperSortUp(p))
+                    lowerSortDown(-1);
+            } else if (p < 0) {
+                // Slot is in the lower half
+                if (!grows && value < old)
+                    lowerSortDown(p * 2);
+                else if (lowerSortUp(p))
+                    upperSortDown(1);
+            } else {
+                // Slot is the median
+                if (lowerCount() > 0)
+                    lowerSortDown(-1);
+                if (upperCount() > 0)
+                    upperSortDown(1);
+            }
+            return value;
+        }
+
+        /// @brief Median of the values in the window, 0 if empty. With an even count, the mean of
+        /// both middle values, truncated like RollingWindow::average().
+        T median() const {
+            if (count == 0)
+                return 0;
+            if (count % 2 == 1)
+                return data[heap(0)];
+            return (T) ((data[heap(0)] + data[heap(-1)]) / 2);
+        }
+
+        /// @brief Drop all values. The window size is kept.
+        void clear() {
+            // Slots fill up alternately below and above the median: 0, -1, 1, -2, 2, ...
+            center = maxSize / 2;
+            for (size_t i = 0; i < maxSize; i++) {
+                const int offset = (int) (i + 1) / 2;
+                position[i] = (int16_t) ((i & 1) ? -offset : offset);
+                heap(position[i]) = (uint16_t) i;
+            }
+            next = 0;
+            count = 0;
+        }
+
+        /// @brief Change the window size at runtime. Unlike RollingWindow this drops all values.
+        /// @param size New window size, clamped to [1, N]
+        /// @return The window size that was applied
+        size_t resize(size_t size) {
+            if (size < 1)
+                size = 1;
+            if (size > N)
+                size = N;
+
+            maxSize = size;
+            clear();
+            return maxSize;
+        }
+
+        /// @brief Number of values currently in the window
+        size_t size() const {
+            return count;
+        }
+
+        /// @brief Active window size, i.e. the number of values at which the window is full
+        size_t capacity() const {
+            return maxSize;
+        }
+
+        bool isFull() const {
+            return count == maxSize;
+        }
+};
+
+#endif
@@ -1,20 +1,110 @@
-#include "Arduino.h"
-#include "LinkedList.h"
-
 #ifndef RollingWindow_H
 #define RollingWindow_H
 
+#include <stddef.h>
+
+/// @brief Fixed-capacity rolling window backed by a ring buffer.
+///
+/// Storage is a plain array sized at compile time, so nothing is ever allocated on the heap.
+/// A running total is kept alongside the buffer which makes append, eviction and average O(1).
+/// The active size can be changed at runtime with resize(), bounded by the capacity N.
+/// @tparam T Element type. Also used for the running total.
+/// @tparam N Maximum number of elements the window can ever hold.
+template <typename T, size_t N>
 class RollingWindow {
+    static_assert(N > 0, "RollingWindow needs a capacity of at least one element");
+
     private:
-        int maxSize;
-        int total = 0;
-        SinglyLinkedList* storage;
+        T buffer[N];
+        size_t head = 0;        // index of the oldest element
+        size_t count = 0;
+        size_t maxSize = N;
+        T total = 0;
+
+        static size_t next(size_t index) {
+            return index + 1 == N ? 0 : index + 1;
+        }
+
+        T dropOldest() {
+            T value = buffer[head];
+            total -= value;
+            head = next(head);
+            count--;
+            return value;
+        }
+
     public:
-        int append(int value);
-        void clear();
-        int average();
-        int size();
-        RollingWindow(int size);
+        /// @param size Initial window size, clamped to [1, N]
+        explicit RollingWindow(size_t size = N) {
+            resize(size);
+        }
+
+        /// @brief Append a value, evicting the oldest one if the window is full
+        /// @return The appended value
+        T append(T value) {
+            if (count == maxSize)
+                dropOldest();
+
+            size_t tail = head + count;
+            if (tail >= N)
+                tail -= N;
+
+            buffer[tail] = value;
+            total += value;
+            count++;
+
+            return value;
+        }
+
+        /// @brief Average of the values currently in the window, 0 if empty.
+        /// Integral types truncate when dividing, which is fine for our use case.
+        T average() const {
+            if (count == 0)
+                return 0;
+
+            return total / (T) count;
+        }
+
+        /// @brief Drop all values. The window size is kept.
+        void clear() {
+            head = 0;
+            count = 0;
+            total = 0;
+        }
+
+        /// @brief Change the window size at runtime. Oldest values are evicted if the window shrinks.
+        /// @param size New window size, clamped to [1, N]
+        /// @return The window size that was applied
+        size_t resize(size_t size) {
+            if (size < 1)
+                size = 1;
+            if (size > N)
+                size = N;
+
+            maxSize = size;
+            while (count > maxSize)
+                dropOldest();
+
+            return maxSize;
+        }
+
+        /// @brief Number of values currently in the window
+        size_t size() const {
+            return count;
+        }
+
+        /// @brief Active window size, i.e. the number of values at which the window is full
+        size_t capacity() const {
+            return maxSize;
+        }
+
+        bool isFull() const {
+            return count == maxSize;
+        }
+
+        T sum() const {
+            return total;
+        }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,65 @@
+#include "RunningStats.h"
+
+uint32_t isqrt64(uint64_t value) {
+    // Bit by bit, at most 32 rounds
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t) 1 << 62;
+    while (bit > value)
+        bit >>= 2;
+
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t) root;
+}
+
+RunningStats::RunningStats(int size) {
+    resize(size);
+}
+
+void RunningStats::clear() {
+    count = 0;
+    mean = 0;
+    variance = 0;
+    sigma = 0;
+}
+
+void RunningStats::seed(int32_t meanFixed, uint32_t sigmaFixed) {
+    count = size;
+    mean = meanFixed;
+    variance = (uint64_t) sigmaFixed * sigmaFixed;
+    sigma = sigmaFixed;
+}
+
+void RunningStats::resize(int size) {
+    this->size = size < 1 ? 1 : size;
+}
+
+void RunningStats::add(int value) {
+    const int32_t x = (int32_t) value * STATS_ONE;
+    const int32_t delta = x - mean;
+
+    if (count < size) {
+        // Welford: exact mean and sum of squared differences
+        count++;
+        mean += delta / count;
+        const int64_t square = (int64_t) delta * (x - mean);
+        // Never negative in exact arithmetic, only through rounding of the mean
+        variance += square > 0 ? (uint64_t) square : 0;
+        if (count == size)
+            variance /= (uint64_t) size;
+    } else {
+        // Exponentially weighted, alpha = 1 / size: var = (1 - alpha) * (var + alpha * delta²)
+        mean += delta / size;
+        variance += (uint64_t) ((int64_t) delta * delta) / (uint64_t) size;
+        variance -= variance / (uint64_t) size;
+    }
+
+    sigma = isqrt64(count < size ? variance / (uint64_t) count : variance);
+}
@@ -0,0 +1,51 @@
+#ifndef RunningStats_H
+#define RunningStats_H
+
+#include <stdint.h>
+
+// Fixed point fraction bits of the mean and standard deviation (1/256 cm)
+const int STATS_FRACTION_BITS = 8;
+const int32_t STATS_ONE = 1 << STATS_FRACTION_BITS;
+
+/// @brief Running mean and variance of a stream of integer readings, in integer fixed point.
+///
+/// The first size readings are accumulated exactly with Welford's algorithm. After that the
+/// statistics track the stream with exponential weights of 1/size, so they follow slow drift
+/// with about the memory of a size long rolling window. Constant time and memory per reading,
+/// no floating point.
+class RunningStats {
+    public:
+        /// @param size Readings to calibrate from, also the averaging length afterwards. At least 1.
+        explicit RunningStats(int size);
+
+        void add(int value);
+        /// @brief Forget everything and start calibrating again
+        void clear();
+        /// @brief Start from known statistics instead of calibrating, e.g. stored before a reboot
+        void seed(int32_t meanFixed, uint32_t sigmaFixed);
+        /// @brief Change the calibration and averaging length. Call clear() before adding again.
+        void resize(int size);
+
+        /// @brief Whether size readings were added, the statistics are meaningful from then on
+        bool isFull() const { return count >= size; }
+        int fill() const { return count; }
+
+        /// @brief Mean in 1/STATS_ONE units
+        int32_t meanFixed() const { return mean; }
+        /// @brief Mean, rounded
+        int average() const { return (int) ((mean + STATS_ONE / 2) >> STATS_FRACTION_BITS); }
+        /// @brief Standard deviation in 1/STATS_ONE units
+        uint32_t sigmaFixed() const { return sigma; }
+
+    private:
+        int size;
+        int count = 0;
+        int32_t mean = 0;           // 1/STATS_ONE
+        uint64_t variance = 0;      // 1/STATS_ONE², the sum of squares while calibrating
+        uint32_t sigma = 0;         // 1/STATS_ONE, kept in step with variance
+};
+
+/// @brief Integer square root, rounded down
+uint32_t isqrt64(uint64_t value);
+
+#endif
@@ -0,0 +1,104 @@
+#include "Scheduler.h"
+
+// Deadline comparisons must survive the micros() wrap, so always compare differences
+static bool reached(uint32_t now, uint32_t deadline) {
+    return (int32_t) (now - deadline) >= 0;
+}
+
+Scheduler::Scheduler(Clock& clock) : clock(clock) {
+}
+
+int Scheduler::add(const char* name, TaskCallback callback, uint32_t periodMicros) {
+    if (count == SCHEDULER_MAX_TASKS)
+        return -1;
+
+    Task& task = tasks[count];
+    task.name = name;
+    task.callback = callback;
+    task.periodMicros = periodMicros;
+    task.nextMicros = clock.micros() + periodMicros;
+    task.enabled = true;
+    task.stats = JitterStats();
+
+    return count++;
+}
+
+void Scheduler::setPeriod(int task, uint32_t periodMicros) {
+    if (valid(task))
+        tasks[task].periodMicros = periodMicros;
+}
+
+void Scheduler::trigger(int task) {
+    if (valid(task))
+        tasks[task].nextMicros = clock.micros();
+}
+
+void Scheduler::reschedule(int task, uint32_t atMicros) {
+    if (valid(task))
+        tasks[task].nextMicros = atMicros;
+}
+
+void Scheduler::setEnabled(int task, bool enabled) {
+    if (!valid(task))
+        return;
+
+    if (enabled && !tasks[task].enabled)
+        tasks[task].nextMicros = clock.micros() + tasks[task].periodMicros;
+
+    tasks[task].enabled = enabled;
+}
+
+void Scheduler::run() {
+    for (int i = 0; i < count; i++) {
+        Task& task = tasks[i];
+        const uint32_t start = clock.micros();
+        if (!task.enabled || !reached(start, task.nextMicros))
+            continue;
+
+        const uint32_t late = start - task.nextMicros;
+        task.stats.runs++;
+        task.stats.totalLateMicros += late;
+        if (late > task.stats.maxLateMicros)
+            task.stats.maxLateMicros = late;
+
+        task.callback();
+
+        const uint32_t end = clock.micros();
+        if (end - start > task.stats.maxRunMicros)
+            task.stats.maxRunMicros = end - start;
+
+        task.nextMicros += task.periodMicros;
+        if (reached(end, task.nextMicros)) {
+            // More than a period behind, drop the missed ticks but keep the phase
+            const uint32_t missed = (end - task.nextMicros) / task.periodMicros + 1;
+            task.stats.skipped += missed;
+            task.nextMicros += missed * task.periodMicros;
+        }
+    }
+}
+
+uint32_t Scheduler::microsUntilNext() {
+    const uint32_t now = clock.micros();
+    uint32_t earliest = UINT32_MAX;
+
+    for (int i = 0; i < count; i++) {
+        if (!tasks[i].enabled)
+            continue;
+        if (reached(now, tasks[i].nextMicros))
+            return 0;
+        if (tasks[i].nextMicros - now < earliest)
+            earliest = tasks[i].nextMicros - now;
+    }
+
+    return earliest;
+}
+
+const JitterStats& Scheduler::stats(int task) const {
+    static const JitterStats none;
+    return valid(task) ? tasks[task].stats : none;
+}
+
+void Scheduler::resetStats() {
+    for (int i = 0; i < count; i++)
+        tasks[i].stats = JitterStats();
+}
@@ -0,0 +1,74 @@
+#ifndef Scheduler_H
+#define Scheduler_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Clock.h"
+
+const int SCHEDULER_MAX_TASKS = 10;
+
+/// @brief How far behind their deadline the runs of a task started
+struct JitterStats {
+    uint32_t runs = 0;
+    uint32_t skipped = 0;           // Ticks dropped because the task fell more than a period behind
+    uint32_t maxLateMicros = 0;
+    uint64_t totalLateMicros = 0;
+    uint32_t maxRunMicros = 0;      // Longest execution time
+
+    uint32_t meanLateMicros() const { return runs > 0 ? (uint32_t) (totalLateMicros / runs) : 0; }
+};
+
+/// @brief Cooperative fixed-rate scheduler, call run() from loop().
+///
+/// Task ids come from add(). Calls with an id add() did not hand out, e.g. its -1, are ignored.
+///
+/// Deadlines advance by exactly one period per run so the cadence does not drift by however long
+/// a task took. A task that falls more than one period behind skips the missed ticks instead of
+/// running back to back.
+class Scheduler {
+    public:
+        typedef void (*TaskCallback)();
+
+        explicit Scheduler(Clock& clock);
+
+        /// @brief Register a task. It first runs one period from now.
+        /// @return Task id, -1 if all slots are taken
+        int add(const char* name, TaskCallback callback, uint32_t periodMicros);
+        /// @brief Change the period. Takes effect after the next run.
+        void setPeriod(int task, uint32_t periodMicros);
+        /// @brief Run the task as soon as possible and continue the cadence from there
+        void trigger(int task);
+        /// @brief Move the next run to atMicros and continue the cadence from there
+        void reschedule(int task, uint32_t atMicros);
+        void setEnabled(int task, bool enabled);
+
+        /// @brief Run every task whose deadline has passed
+        void run();
+        /// @brief usec until the earliest deadline, 0 if a task is due
+        uint32_t microsUntilNext();
+
+        /// @brief Whether task is an id add() handed out
+        bool valid(int task) const { return task >= 0 && task < count; }
+        const char* name(int task) const { return valid(task) ? tasks[task].name : ""; }
+        uint32_t period(int task) const { return valid(task) ? tasks[task].periodMicros : 0; }
+        /// @return Empty statistics for an invalid id
+        const JitterStats& stats(int task) const;
+        void resetStats();
+        int size() const { return count; }
+
+    private:
+        struct Task {
+            const char* name;
+            TaskCallback callback;
+            uint32_t periodMicros;
+            uint32_t nextMicros;
+            bool enabled;
+            JitterStats stats;
+        };
+
+        Clock& clock;
+        Task tasks[SCHEDULER_MAX_TASKS];
+        int count = 0;
+};
+
+#endif
@@ -6,7 +6,7 @@
     Website    : www.seeed.cc
     Author     : LG, FrankieChu
     Create Time: Jan 17,2013
-    Change Log :
+    Change Log : Asynchronous, interrupt driven measurements with a range based timeout
 
     The MIT License (MIT)
 
@@ -65,11 +65,16 @@ static uint32_t pulseIn(uint32_t pin, uint32_t state, uint32_t timeout = 1000000
 
 #endif // ARDUINO_ARCH_STM32F4
 
-Ultrasonic::Ultrasonic(int pin) {
+// The echo pulse is 58 usec per cm (29 usec/cm, there and back), plus some time for the ranger to start it
+#define ECHO_MICROS_PER_CM 58
+#define ECHO_START_MICROS 2000
+
+Ultrasonic::Ultrasonic(int pin, uint16_t maxRangeCm) {
     _pin = pin;
+    _echoTimeout = (uint32_t) maxRangeCm * ECHO_MICROS_PER_CM + ECHO_START_MICROS;
 }
 
-long Ultrasonic::duration(uint32_t timeout) {
+void Ultrasonic::trigger() {
     pinMode(_pin, OUTPUT);
     digitalWrite(_pin, LOW);
     delayMicroseconds(2);
@@ -77,11 +82,68 @@ long Ultrasonic::duration(uint32_t timeout) {
     delayMicroseconds(5);
     digitalWrite(_pin, LOW);
     pinMode(_pin, INPUT);
+}
+
+long Ultrasonic::duration(uint32_t timeout) {
+    trigger();
     long duration;
     duration = pulseIn(_pin, HIGH, timeout);
     return duration;
 }
 
+#if ULTRASONIC_ASYNC
+
+void IRAM_ATTR Ultrasonic::_onEdge(void* arg) {
+    Ultrasonic* self = (Ultrasonic*) arg;
+    const uint32_t now = micros();
+
+    if (digitalRead(self->_pin) == HIGH) {
+        if (self->_state == WAITING) {
+            self->_echoStart = now;
+            self->_state = ECHO;
+        }
+    } else if (self->_state == ECHO) {
+        self->_echoEnd = now;
+        self->_state = DONE;
+    }
+}
+
+bool Ultrasonic::StartMeasurement() {
+    if (IsMeasuring()) {
+        return false;
+    }
+
+    trigger();
+    _state = WAITING;
+    _triggerMicros = micros();
+    attachInterruptArg(digitalPinToInterrupt(_pin), _onEdge, this, CHANGE);
+    return true;
+}
+
+bool Ultrasonic::PollInCentimeters(long& centimeters) {
+    if (_state == DONE) {
+        detachInterrupt(digitalPinToInterrupt(_pin));
+        centimeters = (long) (_echoEnd - _echoStart) / 29 / 2;
+        _state = IDLE;
+        return true;
+    }
+
+    if (IsMeasuring() && micros() - _triggerMicros > _echoTimeout) {
+        detachInterrupt(digitalPinToInterrupt(_pin));
+        centimeters = ULTRASONIC_TIMEOUT;
+        _state = IDLE;
+        return true;
+    }
+
+    return false;
+}
+
+bool Ultrasonic::IsMeasuring() const {
+    return _state == WAITING || _state == ECHO;
+}
+
+#endif // ULTRASONIC_ASYNC
+
 /*The measured distance from the range 0 to 400 Centimeters*/
 long Ultrasonic::MeasureInCentimeters(uint32_t timeout) {
     long RangeInCentimeters;
@@ -6,7 +6,7 @@
     Website    : www.seeed.cc
     Author     : LG, FrankieChu
     Create Time: Jan 17,2013
-    Change Log :
+    Change Log : Asynchronous, interrupt driven measurements with a range based timeout
 
     The MIT License (MIT)
 
@@ -33,15 +33,52 @@
 
 #include "Arduino.h"
 
+// Asynchronous ranging needs interrupts with an argument
+#if defined(ESP8266) || defined(ESP32)
+#define ULTRASONIC_ASYNC 1
+#else
+#define ULTRASONIC_ASYNC 0
+#endif
+
+// Result of an asynchronous measurement when no echo came back within the maximum range
+#define ULTRASONIC_TIMEOUT (-1L)
+
 class Ultrasonic {
   public:
-    Ultrasonic(int pin);
+    /// @param maxRangeCm Furthest distance worth waiting for. Sets the timeout of asynchronous measurements.
+    Ultrasonic(int pin, uint16_t maxRangeCm = 400);
     long MeasureInCentimeters(uint32_t timeout = 1000000L);
     long MeasureInMillimeters(uint32_t timeout = 1000000L);
     long MeasureInInches(uint32_t timeout = 1000000L);
+
+#if ULTRASONIC_ASYNC
+    /// @brief Send a ping and return immediately. The echo is timed by a pin change interrupt.
+    /// @return false if a measurement is still in flight
+    bool StartMeasurement();
+    /// @brief Check for the result of StartMeasurement()
+    /// @param centimeters Distance, or ULTRASONIC_TIMEOUT if nothing echoed within the maximum range
+    /// @return true once the measurement is complete, false while it is still in flight or none was started
+    bool PollInCentimeters(long& centimeters);
+    bool IsMeasuring() const;
+#endif
+
+    /// @brief usec an asynchronous measurement waits for its echo
+    uint32_t EchoTimeout() const { return _echoTimeout; }
+
   private:
     int _pin;//pin number of Arduino that is connected with SIG pin of Ultrasonic Ranger.
+    uint32_t _echoTimeout;
     long duration(uint32_t timeout = 1000000L);
+    void trigger();
+
+#if ULTRASONIC_ASYNC
+    enum : uint8_t { IDLE, WAITING, ECHO, DONE };
+    volatile uint8_t _state = IDLE;
+    volatile uint32_t _echoStart = 0;
+    volatile uint32_t _echoEnd = 0;
+    uint32_t _triggerMicros = 0;
+    static void _onEdge(void* arg);
+#endif
 };
 
 #endif
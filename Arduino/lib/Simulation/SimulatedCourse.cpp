@@ -0,0 +1,65 @@
+#include "SimulatedCourse.h"
+
+SimulatedCourse::SimulatedCourse(Clock& clock, const Config& config) :
+    clock(clock),
+    config(config),
+    random(config.seed == 0 ? 1 : config.seed) {
+    if (this->config.riders < 1)
+        this->config.riders = 1;
+    if (this->config.riders > SIMULATION_MAX_RIDERS)
+        this->config.riders = SIMULATION_MAX_RIDERS;
+
+    // Leave some time for the detector to calibrate before the first rider shows up
+    startWave(clock.millis() + config.pauseMillis);
+}
+
+uint32_t SimulatedCourse::nextRandom() {
+    // xorshift32
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    return random;
+}
+
+void SimulatedCourse::startWave(uint32_t waveStartMillis) {
+    for (int rider = 0; rider < config.riders; rider++) {
+        startMillis[rider] = waveStartMillis + rider * config.startGapMillis;
+        finishMillis[rider] = startMillis[rider] + config.minLapMillis + nextRandom() % (config.maxLapMillis - config.minLapMillis + 1);
+        // No overtaking, and keep finishes apart as far as the starts
+        if (rider > 0 && finishMillis[rider] < finishMillis[rider - 1] + config.startGapMillis)
+            finishMillis[rider] = finishMillis[rider - 1] + config.startGapMillis;
+    }
+    nextFinish = 0;
+}
+
+void SimulatedCourse::advanceTo(uint32_t nowMillis) {
+    while (nextFinish < config.riders && nowMillis >= finishMillis[nextFinish]) {
+        finished++;
+        lastLap = finishMillis[nextFinish] - startMillis[nextFinish];
+        lastLapStart = startMillis[nextFinish];
+        nextFinish++;
+    }
+
+    const uint32_t waveEndMillis = finishMillis[config.riders - 1] + config.passMillis + config.pauseMillis;
+    if (nextFinish == config.riders && nowMillis >= waveEndMillis)
+        startWave(waveEndMillis);
+}
+
+long SimulatedCourse::measureInCentimeters() {
+    const uint32_t now = clock.millis();
+    advanceTo(now);
+
+    if (config.dropoutPermille > 0 && (int) (nextRandom() % 1000) < config.dropoutPermille)
+        return 0;
+
+    bool inGate = false;
+    for (int rider = 0; rider < config.riders; rider++) {
+        inGate |= (now >= startMillis[rider] && now < startMillis[rider] + config.passMillis) ||
+                  (now >= finishMillis[rider] && now < finishMillis[rider] + config.passMillis);
+    }
+
+    const int distance = inGate ? config.bikeCm : config.baselineCm;
+    const int noise = config.noiseCm > 0 ? (int) (nextRandom() % (2 * config.noiseCm + 1)) - config.noiseCm : 0;
+
+    return distance + noise;
+}
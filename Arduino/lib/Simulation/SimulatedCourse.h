@@ -0,0 +1,62 @@
+#ifndef SimulatedCourse_H
+#define SimulatedCourse_H
+
+#include <stdint.h>
+#include "Clock.h"
+#include "Ranger.h"
+
+const int SIMULATION_MAX_RIDERS = 8;
+
+/// @brief Synthetic ranger for host builds.
+///
+/// Reports a noisy baseline distance and a closer distance whenever a simulated motorcycle is in the gate.
+/// Riders go in waves: each rider of a wave crosses the gate startGapMillis after the previous one,
+/// rides a lap of random duration and crosses again. Nobody overtakes, and everybody has started before
+/// the first one finishes. After the last finish and a pause the next wave starts.
+/// Lap durations are the ground truth the detector output can be compared against.
+class SimulatedCourse : public Ranger {
+    public:
+        struct Config {
+            int baselineCm = 300;           // Distance to whatever is across the gate
+            int noiseCm = 3;                // Peak noise amplitude
+            int bikeCm = 120;               // Distance to a passing motorcycle
+            uint32_t passMillis = 400;      // Time a motorcycle spends in the beam
+            uint32_t minLapMillis = 20000;
+            uint32_t maxLapMillis = 60000;
+            uint32_t pauseMillis = 5000;    // Between the last finish of a wave and the start of the next
+            int riders = 1;                 // Per wave, up to SIMULATION_MAX_RIDERS
+            uint32_t startGapMillis = 10000;// Between riders. minLapMillis must exceed riders * startGapMillis.
+            int dropoutPermille = 0;        // Chance of a 0 reading (missed echo)
+            uint32_t seed = 1;
+        };
+
+        SimulatedCourse(Clock& clock, const Config& config);
+
+        long measureInCentimeters() override;
+
+        /// @brief Number of laps whose finish crossing has started, over all riders
+        uint32_t finishedLaps() const { return finished; }
+        /// @brief True duration of the most recently finished lap, measured between the start of both crossings
+        uint32_t lastLapMillis() const { return lastLap; }
+        /// @brief Time the most recently finished lap started
+        uint32_t lastLapStartMillis() const { return lastLapStart; }
+
+    private:
+        Clock& clock;
+        Config config;
+        uint32_t random;
+
+        // Gate crossings of the current wave
+        uint32_t startMillis[SIMULATION_MAX_RIDERS];
+        uint32_t finishMillis[SIMULATION_MAX_RIDERS];
+        int nextFinish = 0;
+        uint32_t finished = 0;
+        uint32_t lastLap = 0;
+        uint32_t lastLapStart = 0;
+
+        uint32_t nextRandom();
+        void startWave(uint32_t waveStartMillis);
+        void advanceTo(uint32_t nowMillis);
+};
+
+#endif
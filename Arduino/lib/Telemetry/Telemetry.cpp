@@ -0,0 +1,101 @@
+#include "Telemetry.h"
+
+static const char BASE64_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+size_t base64Encode(const uint8_t* data, size_t length, char* out) {
+    size_t written = 0;
+    for (size_t i = 0; i < length; i += 3) {
+        const uint32_t remaining = length - i;
+        const uint32_t triple = (uint32_t) data[i] << 16
+            | (remaining > 1 ? (uint32_t) data[i + 1] << 8 : 0)
+            | (remaining > 2 ? data[i + 2] : 0);
+
+        out[written++] = BASE64_ALPHABET[(triple >> 18) & 0x3F];
+        out[written++] = BASE64_ALPHABET[(triple >> 12) & 0x3F];
+        out[written++] = remaining > 1 ? BASE64_ALPHABET[(triple >> 6) & 0x3F] : '=';
+        out[written++] = remaining > 2 ? BASE64_ALPHABET[triple & 0x3F] : '=';
+    }
+    out[written] = '\0';
+    return written;
+}
+
+static void putUint16(uint8_t* out, uint16_t value) {
+    out[0] = value & 0xFF;
+    out[1] = value >> 8;
+}
+
+TelemetryStream::TelemetryStream(EventSink& sink) : sink(sink) {}
+
+void TelemetryStream::add(uint32_t millis, int distance, int average, uint8_t event, bool alwaysInclude, uint8_t gate) {
+    // Nobody is watching, don't spend time on frames
+    if (sink.clients() == 0) {
+        clear();
+        return;
+    }
+
+    if (gate >= TELEMETRY_MAX_GATES)
+        return;
+
+    // Counted per gate, so downsampling never drops the same gate every time
+    skipped[gate]++;
+    if (!alwaysInclude && skipped[gate] < (uint32_t) keepEvery)
+        return;
+    skipped[gate] = 0;
+
+    if (samples == 0) {
+        firstMillis = millis;
+        lastMillis = millis;
+    }
+    const uint32_t delta = millis - lastMillis;
+    lastMillis = millis;
+
+    uint8_t* sample = frame + TELEMETRY_HEADER_SIZE + samples * TELEMETRY_SAMPLE_SIZE;
+    putUint16(sample, delta > 0xFFFF ? 0xFFFF : (uint16_t) delta);
+    putUint16(sample + 2, (uint16_t) (int16_t) distance);
+    putUint16(sample + 4, (uint16_t) (int16_t) average);
+    sample[6] = event;
+    sample[7] = gate;
+
+    if (++samples == TELEMETRY_FRAME_SAMPLES)
+        send();
+}
+
+void TelemetryStream::poll(uint32_t nowMillis) {
+    if (samples > 0 && nowMillis - firstMillis >= TELEMETRY_MAX_FRAME_AGE)
+        send();
+}
+
+void TelemetryStream::clear() {
+    samples = 0;
+    for (int gate = 0; gate < TELEMETRY_MAX_GATES; gate++)
+        skipped[gate] = 0;
+}
+
+void TelemetryStream::send() {
+    frame[0] = TELEMETRY_VERSION;
+    frame[1] = (uint8_t) samples;
+    frame[2] = (uint8_t) keepEvery;
+    frame[3] = 0;
+    frame[4] = firstMillis & 0xFF;
+    frame[5] = (firstMillis >> 8) & 0xFF;
+    frame[6] = (firstMillis >> 16) & 0xFF;
+    frame[7] = firstMillis >> 24;
+
+    char text[4 * ((TELEMETRY_FRAME_SIZE + 2) / 3) + 1];
+    base64Encode(frame, TELEMETRY_HEADER_SIZE + samples * TELEMETRY_SAMPLE_SIZE, text);
+    sink.send(text, "telemetry", firstMillis);
+
+    frames++;
+    samples = 0;
+    adapt();
+}
+
+// Halve the rate while clients queue up frames, double it again once they caught up
+void TelemetryStream::adapt() {
+    const size_t backlog = sink.backlog();
+    if (backlog > TELEMETRY_BACKLOG_HIGH && keepEvery < TELEMETRY_MAX_DECIMATION) {
+        keepEvery *= 2;
+    } else if (backlog == 0 && keepEvery > 1) {
+        keepEvery /= 2;
+    }
+}
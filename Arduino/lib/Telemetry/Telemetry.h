@@ -0,0 +1,73 @@
+#ifndef Telemetry_H
+#define Telemetry_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "EventSink.h"
+
+/*
+* Telemetry frame format, sent base64 encoded as "telemetry" events
+*
+* 8 byte header:
+*   uint8   format version
+*   uint8   number of samples
+*   uint8   decimation, only every n-th reading is included
+*   uint8   reserved
+*   uint32  time of the first sample, msec since boot
+* Followed by 8 bytes per sample:
+*   uint16  msec since the previous sample, 0 for the first one
+*   int16   distance in cm, -1 for no echo
+*   int16   window average in cm
+*   uint8   detector event (Detector::Event)
+*   uint8   gate the reading belongs to
+* All little endian. Samples of all gates are interleaved in time order.
+*/
+
+const uint8_t TELEMETRY_VERSION = 2;
+const size_t TELEMETRY_HEADER_SIZE = 8;
+const size_t TELEMETRY_SAMPLE_SIZE = 8;
+const int TELEMETRY_MAX_GATES = 4;
+const int TELEMETRY_FRAME_SAMPLES = 20;
+const size_t TELEMETRY_FRAME_SIZE = TELEMETRY_HEADER_SIZE + TELEMETRY_FRAME_SAMPLES * TELEMETRY_SAMPLE_SIZE;
+const uint32_t TELEMETRY_MAX_FRAME_AGE = 1000;   // msec, a partial frame is sent after this
+const int TELEMETRY_MAX_DECIMATION = 16;
+const size_t TELEMETRY_BACKLOG_HIGH = 4;        // Queued messages per client before downsampling
+
+/// @brief Base64 encode length bytes into out, which needs room for 4 * ((length + 2) / 3) + 1 chars
+/// @return Length of the encoded text
+size_t base64Encode(const uint8_t* data, size_t length, char* out);
+
+/// @brief Batches readings into telemetry frames and sends them to an EventSink.
+///
+/// When the sink reports a backlog, i.e. clients do not keep up, only every second, fourth, ...
+/// reading of each gate is included. Readings added with alwaysInclude, e.g. triggers, are kept at any rate.
+class TelemetryStream {
+    public:
+        explicit TelemetryStream(EventSink& sink);
+
+        /// @param event A Detector::Event
+        /// @param gate 0 to TELEMETRY_MAX_GATES - 1
+        void add(uint32_t millis, int distance, int average, uint8_t event, bool alwaysInclude, uint8_t gate = 0);
+        /// @brief Send a partial frame once it is TELEMETRY_MAX_FRAME_AGE old
+        void poll(uint32_t nowMillis);
+        /// @brief Drop the current frame, e.g. when timing stops
+        void clear();
+
+        int decimation() const { return keepEvery; }
+        uint32_t framesSent() const { return frames; }
+
+    private:
+        EventSink& sink;
+        uint8_t frame[TELEMETRY_FRAME_SIZE];
+        int samples = 0;
+        uint32_t firstMillis = 0;
+        uint32_t lastMillis = 0;
+        int keepEvery = 1;
+        uint32_t skipped[TELEMETRY_MAX_GATES] = {};    // Readings since the last included one
+        uint32_t frames = 0;
+
+        void send();
+        void adapt();
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include <string.h>
+#include "FlightRecorder.h"
+
+void FlightRecorder::add(uint32_t micros, int distance, uint8_t state) {
+    if (dumping && !dumpStalled) {
+        // A client that stopped reading must not keep the recorder off for good
+        if (++dumpDrops >= FLIGHT_RECORDER_MAX_DUMP_DROPS)
+            dumpStalled = true;
+        return;
+    }
+    if (stopped)
+        return;
+
+    // Rounded against the reconstructed time, so the dump does not drift away from the clock
+    uint32_t ticks = 0;
+    if (count > 0) {
+        ticks = (micros - lastMicros + FLIGHT_RECORDER_TICK_MICROS / 2) / FLIGHT_RECORDER_TICK_MICROS;
+        if (ticks > FLIGHT_RECORDER_MAX_TICKS)
+            ticks = FLIGHT_RECORDER_MAX_TICKS;
+    }
+    lastMicros = count > 0 ? lastMicros + ticks * FLIGHT_RECORDER_TICK_MICROS : micros;
+
+    if (count == FLIGHT_RECORDER_SAMPLES) {
+        // The second oldest sample becomes the oldest
+        oldestMicros += delta(sample(1)) * FLIGHT_RECORDER_TICK_MICROS;
+        count--;
+    } else if (count == 0) {
+        oldestMicros = micros;
+    }
+
+    if (distance > FLIGHT_RECORDER_MAX_DISTANCE)
+        distance = FLIGHT_RECORDER_MAX_DISTANCE;
+    else if (distance < FLIGHT_RECORDER_MIN_DISTANCE)
+        distance = FLIGHT_RECORDER_MIN_DISTANCE;
+
+    const uint32_t packed = ticks | (uint32_t) distance << 20;
+    uint8_t* out = ring + head * FLIGHT_RECORDER_SAMPLE_SIZE;
+    out[0] = (uint8_t) packed;
+    out[1] = (uint8_t) (packed >> 8);
+    out[2] = (uint8_t) (packed >> 16);
+    out[3] = (uint8_t) (packed >> 24);
+    out[4] = state;
+    head = (head + 1) % FLIGHT_RECORDER_SAMPLES;
+    count++;
+
+    if (remaining > 0 && --remaining == 0)
+        stopped = true;
+}
+
+void FlightRecorder::freeze(const char* reason) {
+    if (stopped || remaining > 0)
+        return;
+
+    freezeReason = reason;
+    remaining = FLIGHT_RECORDER_AFTER_FREEZE;
+}
+
+void FlightRecorder::release() {
+    stopped = false;
+    remaining = 0;
+    freezeReason = NULL;
+}
+
+uint32_t FlightRecorder::beginDump() {
+    // A stalled dump no longer holds the ring, a new one may take over its cursor
+    if (dumping && !dumpStalled)
+        return 0;
+
+    if (++dumpId == 0)
+        dumpId = 1;
+    dumping = true;
+    dumpStalled = false;
+    dumpDrops = 0;
+    dumpIndex = -1;
+    pendingLength = 0;
+    pendingOffset = 0;
+    return dumpId;
+}
+
+size_t FlightRecorder::readDump(uint32_t dump, uint8_t* out, size_t size) {
+    if (dump != dumpId)
+        return 0;
+
+    size_t written = 0;
+    while (dumping && written < size) {
+        if (pendingOffset < pendingLength) {
+            size_t length = pendingLength - pendingOffset;
+            if (length > size - written)
+                length = size - written;
+            memcpy(out + written, pending + pendingOffset, length);
+            pendingOffset += length;
+            written += length;
+            continue;
+        }
+
+        // On a record boundary. Past a stall the ring has changed under the dump, so it ends here.
+        if (dumpStalled) {
+            dumping = false;
+            break;
+        }
+
+        // Encode the next piece, records are at most TRACE_MAX_RECORD_SIZE bytes
+        pendingOffset = 0;
+        if (dumpIndex < 0) {
+            pendingLength = traceWriteHeader(pending, TRACE_FLAG_STATE);
+            encoder.begin(oldestMicros);
+            dumpMicros = oldestMicros;
+        } else if (dumpIndex < count) {
+            const uint8_t* in = sample(dumpIndex);
+            if (dumpIndex > 0)
+                dumpMicros += delta(in) * FLIGHT_RECORDER_TICK_MICROS;
+            pendingLength = encoder.encode(dumpMicros, distance(in), in[4], pending);
+        } else {
+            dumping = false;
+            break;
+        }
+        dumpIndex++;
+    }
+    return written;
+}
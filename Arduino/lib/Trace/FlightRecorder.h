@@ -0,0 +1,85 @@
+#ifndef FlightRecorder_H
+#define FlightRecorder_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Trace.h"
+
+const int FLIGHT_RECORDER_SAMPLES = 2048;           // 10 KB of RAM
+const int FLIGHT_RECORDER_SAMPLE_SIZE = 5;          // Packed bytes per sample
+const uint32_t FLIGHT_RECORDER_TICK_MICROS = 16;    // Timestamp resolution, about a quarter cm of echo time
+const uint32_t FLIGHT_RECORDER_MAX_TICKS = 0xFFFFF; // 20 bits, 16.7 sec
+const int FLIGHT_RECORDER_MIN_DISTANCE = -2048;     // 12 bits
+const int FLIGHT_RECORDER_MAX_DISTANCE = 2047;
+const int FLIGHT_RECORDER_AFTER_FREEZE = FLIGHT_RECORDER_SAMPLES / 4;   // Samples kept after a freeze request
+const int FLIGHT_RECORDER_MAX_DUMP_DROPS = 256;     // Samples dropped during a download before it counts as stalled
+
+/// @brief Always-on ring buffer of the last FLIGHT_RECORDER_SAMPLES raw readings of all gates.
+///
+/// Each sample is packed into 5 bytes: 20 bits of time since the previous sample in
+/// FLIGHT_RECORDER_TICK_MICROS (longer gaps, like while timing is stopped, are shortened), 12 bits of
+/// distance and a traceState() byte. freeze() keeps recording for another FLIGHT_RECORDER_AFTER_FREEZE
+/// samples and then stops, so the ring holds the readings around a suspicious event until release().
+///
+/// The dump is a trace with TRACE_FLAG_STATE that the replay tool reads like a recording. It is
+/// encoded straight from the ring into the caller's buffer, piece by piece, so it can feed a chunked
+/// HTTP response without a copy of the ring. New samples are dropped while a dump is in progress,
+/// and there is only one dump at a time. A dump whose reader stops for FLIGHT_RECORDER_MAX_DUMP_DROPS
+/// samples gives up the ring: recording resumes and the dump ends after the record it is in.
+class FlightRecorder {
+    public:
+        void add(uint32_t micros, int distance, uint8_t state);
+
+        /// @brief Stop recording FLIGHT_RECORDER_AFTER_FREEZE samples from now.
+        /// Ignored while already frozen or freezing, the first event is the interesting one.
+        /// @param reason Static text for the API
+        void freeze(const char* reason);
+        /// @brief Resume recording, keeping the samples
+        void release();
+
+        bool frozen() const { return stopped; }
+        bool freezing() const { return remaining > 0; }
+        /// @return The first freeze() reason since the last release(), NULL if none
+        const char* reason() const { return freezeReason; }
+        int samples() const { return count; }
+
+        /// @brief Start a dump of the current samples
+        /// @return Id to read the dump with, 0 while another dump is in progress
+        uint32_t beginDump();
+        /// @brief Write the next part of the dump
+        /// @param dump Id from beginDump()
+        /// @return Bytes written, 0 once the dump is complete, given up or replaced by a newer one
+        size_t readDump(uint32_t dump, uint8_t* out, size_t size);
+
+    private:
+        uint8_t ring[FLIGHT_RECORDER_SAMPLES * FLIGHT_RECORDER_SAMPLE_SIZE];
+        int head = 0;                   // Next sample to write
+        int count = 0;
+        uint32_t oldestMicros = 0;      // Timestamp of the oldest sample
+        uint32_t lastMicros = 0;        // Timestamp of the newest sample, as the deltas add up
+        bool stopped = false;
+        int remaining = 0;              // Samples until a requested freeze takes effect
+        const char* freezeReason = NULL;
+
+        // Dump progress
+        bool dumping = false;
+        bool dumpStalled = false;       // Recording again, the dump ends on the next record boundary
+        uint32_t dumpId = 0;
+        int dumpDrops = 0;
+        int dumpIndex = -1;             // -1 for the header
+        uint32_t dumpMicros = 0;
+        TraceEncoder encoder;
+        uint8_t pending[TRACE_MAX_RECORD_SIZE];
+        size_t pendingLength = 0;
+        size_t pendingOffset = 0;
+
+        uint8_t* sample(int index) { return ring + ((head - count + index + FLIGHT_RECORDER_SAMPLES) % FLIGHT_RECORDER_SAMPLES) * FLIGHT_RECORDER_SAMPLE_SIZE; }
+        static uint32_t packed(const uint8_t* sample) {
+            return (uint32_t) sample[0] | (uint32_t) sample[1] << 8 | (uint32_t) sample[2] << 16 | (uint32_t) sample[3] << 24;
+        }
+        static uint32_t delta(const uint8_t* sample) { return packed(sample) & FLIGHT_RECORDER_MAX_TICKS; }
+        // Sign extended from 12 bits
+        static int distance(const uint8_t* sample) { return (int32_t) packed(sample) >> 20; }
+};
+
+#endif
@@ -0,0 +1,177 @@
+#include <string.h>
+#include "Trace.h"
+
+static const uint8_t TRACE_MAGIC[4] = { 'M', 'G', 'T', 'R' };
+
+static size_t writeVarint(uint32_t value, uint8_t* out) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = (uint8_t) (value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (uint8_t) value;
+    return length;
+}
+
+static uint32_t zigzag(int value) {
+    return ((uint32_t) value << 1) ^ (uint32_t) (value >> 31);
+}
+
+static int unzigzag(uint32_t value) {
+    return (int) (value >> 1) ^ -(int) (value & 1);
+}
+
+size_t traceWriteHeader(uint8_t* out, uint8_t flags) {
+    memcpy(out, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    out[4] = TRACE_VERSION;
+    out[5] = flags;
+    out[6] = 0;
+    out[7] = 0;
+    return TRACE_HEADER_SIZE;
+}
+
+void TraceEncoder::begin(uint32_t startMicros) {
+    lastMicros = startMicros;
+}
+
+size_t TraceEncoder::encode(uint32_t micros, int distance, uint8_t* out) {
+    // unsigned subtraction keeps this correct across the micros() wrap
+    size_t length = writeVarint(micros - lastMicros, out);
+    length += writeVarint(zigzag(distance), out + length);
+    lastMicros = micros;
+    return length;
+}
+
+size_t TraceEncoder::encode(uint32_t micros, int distance, uint8_t state, uint8_t* out) {
+    const size_t length = encode(micros, distance, out);
+    out[length] = state;
+    return length + 1;
+}
+
+TraceReader::TraceReader(const uint8_t* data, size_t size) : data(data), size(size) {
+    ok = size >= TRACE_HEADER_SIZE && memcmp(data, TRACE_MAGIC, sizeof(TRACE_MAGIC)) == 0 && data[4] == TRACE_VERSION;
+    headerFlags = ok ? data[5] : 0;
+    rewind();
+}
+
+void TraceReader::rewind() {
+    position = TRACE_HEADER_SIZE;
+    micros = 0;
+}
+
+bool TraceReader::readVarint(uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35 && position < size; shift += 7) {
+        const uint8_t byte = data[position++];
+        value |= (uint32_t) (byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool TraceReader::next(TraceSample& sample) {
+    if (!ok)
+        return false;
+
+    do {
+        uint32_t delta;
+        uint32_t distance;
+        if (!readVarint(delta) || !readVarint(distance))
+            return false;
+
+        uint8_t state = 0;
+        if (headerFlags & TRACE_FLAG_STATE) {
+            if (position >= size)
+                return false;
+            state = data[position++];
+        }
+
+        micros += delta;
+        sample.micros = micros;
+        sample.distance = unzigzag(distance);
+        sample.gate = state >> 4;
+        sample.event = state & 0x0F;
+    } while (selectedGate >= 0 && sample.gate != selectedGate);
+    return true;
+}
+
+TraceRecorder::TraceRecorder(Storage& storage, const char* path) : storage(storage), path(path) {
+}
+
+bool TraceRecorder::start(uint32_t nowMicros) {
+    uint8_t header[TRACE_HEADER_SIZE];
+    traceWriteHeader(header);
+
+    current = 0;
+    fill = 0;
+    pending = 0;
+    sampleCount = 0;
+    droppedCount = 0;
+    written = 0;
+    active = storage.write(path, header, sizeof(header));
+    if (active)
+        written = sizeof(header);
+
+    encoder.begin(nowMicros);
+    return active;
+}
+
+void TraceRecorder::add(uint32_t micros, int distance) {
+    if (!active)
+        return;
+
+    if (fill + TRACE_MAX_RECORD_SIZE > sizeof(buffers[0])) {
+        // The flush task fell behind. The next record's delta spans the gap, so timing stays right.
+        if (pending > 0) {
+            droppedCount++;
+            return;
+        }
+        pending = fill;
+        current ^= 1;
+        fill = 0;
+    }
+
+    fill += encoder.encode(micros, distance, buffers[current] + fill);
+    sampleCount++;
+}
+
+bool TraceRecorder::append(const uint8_t* data, size_t length) {
+    if (!storage.append(path, data, length)) {
+        // Flash full or gone. Stop rather than record a trace with holes in it.
+        active = false;
+        return false;
+    }
+
+    written += length;
+    return true;
+}
+
+bool TraceRecorder::flushFull() {
+    if (pending == 0)
+        return true;
+
+    const bool ok = append(buffers[current ^ 1], pending);
+    pending = 0;
+    return ok;
+}
+
+bool TraceRecorder::flush() {
+    if (!flushFull())
+        return false;
+    if (fill == 0)
+        return true;
+
+    const bool ok = append(buffers[current], fill);
+    fill = 0;
+    return ok;
+}
+
+bool TraceRecorder::stop() {
+    if (!active)
+        return false;
+
+    bool ok = flush();
+    active = false;
+    return ok;
+}
@@ -0,0 +1,123 @@
+#ifndef Trace_H
+#define Trace_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Storage.h"
+
+/*
+* Binary sensor trace format
+*
+* 8 byte header: "MGTR", version, flags, 2 reserved bytes.
+* Followed by one record per sample:
+*   varint  usec since the previous sample (since recording start for the first one)
+*   varint  distance in cm, zigzag encoded so negative sentinel values survive
+*   uint8   only with TRACE_FLAG_STATE: gate index << 4 | detector event of the sample
+* Varints are LEB128, so a typical 100 msec / 300 cm sample takes 5 bytes.
+*/
+
+const uint8_t TRACE_VERSION = 1;
+const size_t TRACE_HEADER_SIZE = 8;
+const size_t TRACE_MAX_RECORD_SIZE = 11;
+
+// Header flags
+const uint8_t TRACE_FLAG_STATE = 0x01;     // Records carry a state byte, see traceState()
+
+struct TraceSample {
+    uint64_t micros;    // since recording start
+    int distance;       // cm
+    uint8_t gate;       // Gate index, 0 without TRACE_FLAG_STATE
+    uint8_t event;      // Detector::Event on the board, 0 without TRACE_FLAG_STATE
+};
+
+/// @brief Pack a gate index (0-15) and detector event (0-15) into a record state byte
+inline uint8_t traceState(int gate, int event) {
+    return (uint8_t) ((gate & 0x0F) << 4 | (event & 0x0F));
+}
+
+/// @brief Write a trace header
+/// @return Number of bytes written, always TRACE_HEADER_SIZE
+size_t traceWriteHeader(uint8_t* out, uint8_t flags = 0);
+
+/// @brief Delta encodes samples into trace records
+class TraceEncoder {
+    public:
+        /// @param startMicros Recording start, the first record's delta is relative to this
+        void begin(uint32_t startMicros);
+        /// @brief Encode one sample into out, which must have room for TRACE_MAX_RECORD_SIZE bytes
+        /// @return Number of bytes written
+        size_t encode(uint32_t micros, int distance, uint8_t* out);
+        /// @brief Encode one sample of a trace with TRACE_FLAG_STATE
+        size_t encode(uint32_t micros, int distance, uint8_t state, uint8_t* out);
+
+    private:
+        uint32_t lastMicros = 0;
+};
+
+/// @brief Iterates over the samples of a trace held in memory
+class TraceReader {
+    public:
+        TraceReader(const uint8_t* data, size_t size);
+        /// @brief Whether the header was recognised
+        bool valid() const { return ok; }
+        uint8_t flags() const { return headerFlags; }
+        /// @return false at the end of the trace or on a truncated record
+        bool next(TraceSample& sample);
+        /// @brief Only return samples of one gate, -1 for all. Traces without TRACE_FLAG_STATE only have gate 0.
+        void selectGate(int gate) { selectedGate = gate; }
+        void rewind();
+
+    private:
+        const uint8_t* data;
+        size_t size;
+        size_t position;
+        uint64_t micros;
+        uint8_t headerFlags;
+        int selectedGate = -1;
+        bool ok;
+
+        bool readVarint(uint32_t& value);
+};
+
+/// @brief Records samples to a file. Samples are buffered in RAM and appended in blocks.
+///
+/// Two buffers take turns: add() fills one while the other waits for flushFull(), so the ranging
+/// hot path never writes to flash. A sample that finds both buffers full is dropped and counted.
+class TraceRecorder {
+    public:
+        TraceRecorder(Storage& storage, const char* path);
+
+        /// @brief Start a new recording, replacing any previous one
+        bool start(uint32_t nowMicros);
+        void add(uint32_t micros, int distance);
+        /// @brief Flush buffered samples and stop recording
+        bool stop();
+        /// @brief Append all buffered samples to the file
+        bool flush();
+        /// @brief Append the buffer that filled up, if any. Call regularly from a scheduler task.
+        bool flushFull();
+
+        bool recording() const { return active; }
+        /// @brief Bytes recorded so far, including the ones still buffered
+        size_t size() const { return written + pending + fill; }
+        uint32_t samples() const { return sampleCount; }
+        /// @brief Samples lost because flushFull() did not keep up
+        uint32_t dropped() const { return droppedCount; }
+
+    private:
+        Storage& storage;
+        const char* path;
+        TraceEncoder encoder;
+        uint8_t buffers[2][256];
+        int current = 0;            // Buffer add() fills
+        size_t fill = 0;
+        size_t pending = 0;         // Bytes in the other buffer waiting for flushFull(), 0 if none
+        size_t written = 0;
+        uint32_t sampleCount = 0;
+        uint32_t droppedCount = 0;
+        bool active = false;
+
+        bool append(const uint8_t* data, size_t length);
+};
+
+#endif
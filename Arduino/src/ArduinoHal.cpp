@@ -0,0 +1,138 @@
+#include <LittleFS.h>
+#include "ArduinoHal.h"
+
+bool LittleFsStorage::begin() {
+  return LittleFS.begin();
+}
+
+size_t LittleFsStorage::read(const char* path, size_t offset, void* data, size_t size) {
+  File file = LittleFS.open(path, "r");
+  if (!file) {
+    return 0;
+  }
+
+  size_t read = 0;
+  if (file.seek(offset)) {
+    read = file.read((uint8_t*) data, size);
+  }
+
+  file.close();
+  return read;
+}
+
+bool LittleFsStorage::write(const char* path, const void* data, size_t size) {
+  File file = LittleFS.open(path, "w");
+  if (!file) {
+    return false;
+  }
+
+  bool ok = file.write((const uint8_t*) data, size) == size;
+  file.close();
+  return ok;
+}
+
+bool LittleFsStorage::append(const char* path, const void* data, size_t size) {
+  File file = LittleFS.open(path, "a");
+  if (!file) {
+    return false;
+  }
+
+  bool ok = file.write((const uint8_t*) data, size) == size;
+  file.close();
+  return ok;
+}
+
+size_t LittleFsStorage::size(const char* path) {
+  File file = LittleFS.open(path, "r");
+  if (!file) {
+    return 0;
+  }
+
+  size_t size = file.size();
+  file.close();
+  return size;
+}
+
+bool LittleFsStorage::remove(const char* path) {
+  return LittleFS.remove(path);
+}
+
+bool LittleFsStorage::truncate(const char* path, size_t size) {
+  if (size == 0) {
+    LittleFS.remove(path);
+    return true;
+  }
+
+  File file = LittleFS.open(path, "r+");
+  if (!file) {
+    return false;
+  }
+
+  bool ok = file.truncate(size);
+  file.close();
+  return ok;
+}
+
+EventSourceConnection::EventSourceConnection(AsyncWebServerRequest *request, EventBroadcaster& broadcaster) :
+  client(request -> client()), broadcaster(broadcaster) {
+  String lastEventId;
+  if (request -> hasHeader("Last-Event-ID")) {
+    lastEventId = request -> getHeader("Last-Event-ID") -> value();
+  }
+
+  // The stream stays open for good, only a stalled peer times out
+  client -> setRxTimeout(0);
+  client -> onError(NULL, NULL);
+  client -> onData(NULL, NULL);
+  client -> onTimeout([](void *arg, AsyncClient *c, uint32_t time) {
+    c -> close(true);
+  }, this);
+  client -> onDisconnect([](void *arg, AsyncClient *c) {
+    EventSourceConnection* connection = (EventSourceConnection*) arg;
+    connection -> broadcaster.disconnect(*connection);
+    delete connection;
+    delete c;
+  }, this);
+
+  // Browsers reconnect after a second and send the id of the last event they got
+  client -> write("retry: 1000\n\n", 13);
+  if (!broadcaster.connect(*this, lastEventId.c_str())) {
+    // All client slots taken. Closes on the next poll, not from inside the constructor.
+    client -> close();
+  }
+  delete request;
+}
+
+EventSourceResponse::EventSourceResponse(EventBroadcaster& broadcaster) : broadcaster(broadcaster) {
+  _code = 200;
+  _contentType = "text/event-stream";
+  _sendContentLength = false;
+  addHeader("Cache-Control", "no-cache");
+  addHeader("Connection", "keep-alive");
+}
+
+void EventSourceResponse::_respond(AsyncWebServerRequest *request) {
+  String head = _assembleHead(request -> version());
+  request -> client() -> write(head.c_str(), _headLength);
+  _state = RESPONSE_WAIT_ACK;
+}
+
+size_t EventSourceResponse::_ack(AsyncWebServerRequest *request, size_t len, uint32_t time) {
+  // Once the headers are out the connection belongs to the broadcaster, which also frees the request
+  if (len) {
+    new EventSourceConnection(request, broadcaster);
+  }
+  return 0;
+}
+
+bool EventSourceHandler::canHandle(AsyncWebServerRequest *request) {
+  if (request -> method() != HTTP_GET || !request -> url().equals(url)) {
+    return false;
+  }
+  request -> addInterestingHeader("Last-Event-ID");
+  return true;
+}
+
+void EventSourceHandler::handleRequest(AsyncWebServerRequest *request) {
+  request -> send(new EventSourceResponse(broadcaster));
+}
@@ -0,0 +1,115 @@
+#ifndef ArduinoHal_H
+#define ArduinoHal_H
+
+#include <Arduino.h>
+#include <Ultrasonic.h>
+#include <ESPAsyncWebServer.h>
+#include "Clock.h"
+#include "EventBroadcaster.h"
+#include "EventConnection.h"
+#include "EventSink.h"
+#include "Ranger.h"
+#include "Storage.h"
+
+/*
+* HAL implementations for the ESP8266
+*/
+
+class ArduinoClock : public Clock {
+  public:
+    uint32_t millis() override { return ::millis(); }
+    uint32_t micros() override { return ::micros(); }
+    void delay(uint32_t ms) override { ::delay(ms); }
+};
+
+/// @brief Grove ultrasonic ranger. Measurements are interrupt driven and time out after the maximum range.
+class UltrasonicRanger : public Ranger {
+  public:
+    explicit UltrasonicRanger(Ultrasonic& ultrasonic) : ultrasonic(ultrasonic) {}
+
+    long measureInCentimeters() override {
+      // pulseIn() reports a timeout as 0
+      long centimeters = ultrasonic.MeasureInCentimeters(ultrasonic.EchoTimeout());
+      return centimeters == 0 ? RANGER_TIMEOUT : centimeters;
+    }
+
+    bool startMeasurement() override { return ultrasonic.StartMeasurement(); }
+
+    bool pollMeasurement(long& centimeters) override {
+      if (!ultrasonic.PollInCentimeters(centimeters)) {
+        return false;
+      }
+      if (centimeters == ULTRASONIC_TIMEOUT) {
+        centimeters = RANGER_TIMEOUT;
+      }
+      return true;
+    }
+
+  private:
+    Ultrasonic& ultrasonic;
+};
+
+/// @brief An /events client on its TCP connection, written by an EventBroadcaster. Takes over the
+/// connection from the request like AsyncEventSource does, and deletes itself once it is closed.
+class EventSourceConnection : public EventConnection {
+  public:
+    EventSourceConnection(AsyncWebServerRequest *request, EventBroadcaster& broadcaster);
+
+    bool connected() override { return client -> connected(); }
+    size_t space() override { return client -> canSend() ? client -> space() : 0; }
+    void write(const char* data, size_t length) override { client -> write(data, length); }
+    void close() override { client -> close(true); }
+
+  private:
+    AsyncClient* client;
+    EventBroadcaster& broadcaster;
+};
+
+/// @brief GET /events: the EventSource headers, then the connection goes to the broadcaster
+class EventSourceResponse : public AsyncWebServerResponse {
+  public:
+    explicit EventSourceResponse(EventBroadcaster& broadcaster);
+    void _respond(AsyncWebServerRequest *request) override;
+    size_t _ack(AsyncWebServerRequest *request, size_t len, uint32_t time) override;
+    bool _sourceValid() const override { return true; }
+
+  private:
+    EventBroadcaster& broadcaster;
+};
+
+/// @brief Serves an EventBroadcaster as an EventSource, replaces AsyncEventSource
+class EventSourceHandler : public AsyncWebHandler {
+  public:
+    EventSourceHandler(const char* url, EventBroadcaster& broadcaster) : url(url), broadcaster(broadcaster) {}
+    bool canHandle(AsyncWebServerRequest *request) override;
+    void handleRequest(AsyncWebServerRequest *request) override;
+
+  private:
+    const char* url;
+    EventBroadcaster& broadcaster;
+};
+
+/// @brief Prints messages to a serial port, one per line. Never blocks: canSend() checks the TX buffer.
+class SerialSink : public EventSink {
+  public:
+    explicit SerialSink(HardwareSerial& serial) : serial(serial) {}
+    void send(const char* message, const char* event, uint32_t id) override { serial.println(message); }
+    bool canSend(size_t length) override { return serial.availableForWrite() >= (int) length + 2; }
+
+  private:
+    HardwareSerial& serial;
+};
+
+/// @brief Storage on the LittleFS flash partition. Call begin() before use.
+class LittleFsStorage : public Storage {
+  public:
+    bool begin();
+    size_t read(const char* path, size_t offset, void* data, size_t size) override;
+    bool write(const char* path, const void* data, size_t size) override;
+    bool append(const char* path, const void* data, size_t size) override;
+    size_t size(const char* path) override;
+    bool remove(const char* path) override;
+    bool truncate(const char* path, size_t size) override;
+};
+
+#endif
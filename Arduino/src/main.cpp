@@ -2,34 +2,37 @@
 #include <Ultrasonic.h>
 #include <ESP8266WiFi.h>
 #include <ESPAsyncWebServer.h>
-#include "RollingWindow.h"
+#include "ArduinoHal.h"
+#include "ConfigApi.h"
+#include "ConfigStore.h"
+#include "Detector.h"
+#include "EventBroadcaster.h"
+#include "FlightRecorder.h"
+#include "Gate.h"
+#include "JsonReader.h"
+#include "JsonWriter.h"
+#include "LapStore.h"
+#include "LapTimer.h"
+#include "Log.h"
+#include "Metrics.h"
+#include "Parameters.h"
+#include "PowerMonitor.h"
+#include "PrometheusWriter.h"
+#include "Scheduler.h"
+#include "Telemetry.h"
+#include "Trace.h"
+#include "WebUi.h"
 
 /*
 * Constants
 */
 
-// Ranger
+// Rangers, one per gate. Free pins on the NodeMCU are 5, 4, 14, 12 and 13.
 #define RANGERPIN 5
 
-int WINDOW_SIZE = 20;
-int DETECTION_SIZE = 5;
-int PERCENT_DIFF_TRIGGER = 30;    // If a reading is this % different from before, treat this as a potential trigger
-int AFTER_DETECTION_DELAY = 2000;   // Delay after detecting something moving across barrier
-
-RollingWindow window(WINDOW_SIZE);
-RollingWindow detection(DETECTION_SIZE);
-
-long lastMatchedTriggerMillis = 0;   // msec
+Parameters params;
 
 bool run = false;
-long potentialTriggerMillis = 0;
-long firstTriggerMillis = 0;
-bool runDetection = false;
-
-int DELAY = 100;    // msec to delay between readings
-const int STEP = 10;  // valid stepping interval in msec
-const int MAX_DELAY = 500;    // Max ranging delay
-const int MIN_DELAY = 50;   // Minimum ranging delay
 
 // Soft Access Point
 const char* ssid = "ESP8266 Timer";
@@ -40,410 +43,837 @@ const char* password = "motogymkhana";
 */
 
 // Ranger
-Ultrasonic ultrasonic(RANGERPIN);
+Ultrasonic ultrasonic(RANGERPIN, RANGER_MAX_CM);
+UltrasonicRanger ranger(ultrasonic);
+
+// Gates. One sensor is a combined start/finish gate. For separate gates add a ranger per gate, e.g.
+//   Gate("start", LapTimer::START, startRanger, params),
+//   Gate("split", LapTimer::SPLIT, splitRanger, params),
+//   Gate("finish", LapTimer::FINISH, finishRanger, params),
+// Up to GATE_MAX gates are pinged one after another, so their echoes never cross.
+Gate gates[] = {
+  Gate("gate", LapTimer::START_FINISH, ranger, params),
+};
+const int GATE_COUNT = sizeof(gates) / sizeof(gates[0]);
+static_assert(GATE_COUNT <= GATE_MAX && GATE_COUNT <= TELEMETRY_MAX_GATES, "Too many gates");
 
 // Webserver
 AsyncWebServer server(80);
-AsyncEventSource events("/events");
+
+// HAL
+ArduinoClock systemClock;
+SerialSink serialSink(Serial);
+LittleFsStorage storage;
+
+// Web UI events. Queued per client and written from loop(), so a slow phone never holds up timing.
+EventBroadcaster events(systemClock);
+EventSourceHandler eventsHandler("/events", events);
+
+GateRanging gateRanging(systemClock, params, gates, GATE_COUNT);
+LapTimer lapTimer(params);
+Scheduler scheduler(systemClock);
+
+// Scheduler tasks
+const uint32_t STATUS_INTERVAL = 1000;      // msec between status events
+const uint32_t JITTER_LOG_INTERVAL = 10000; // msec between jitter statistics log lines
+int rangingTask = -1;
+int statusTask = -1;
+int jitterLogTask = -1;
+int logFlushTask = -1;
+const uint32_t LOG_FLUSH_INTERVAL = 20;     // msec between log flushes
+int telemetryTask = -1;
+const uint32_t TELEMETRY_POLL_INTERVAL = 250; // msec between checks for a partial telemetry frame to send
+
+// Lap history on flash
+const char* LAPS_PATH = "/laps.bin";
+const uint32_t LAPS_DEFAULT_LIMIT = 50;
+LapStore lapStore(storage, LAPS_PATH);
+
+// Live readings for the chart on the web page
+TelemetryStream telemetry(events);
+
+// JSON request bodies are collected in RAM, so they are capped
+const size_t API_MAX_BODY = 512;
+
+// Settings and gate calibrations on flash, loaded at boot
+const char* CONFIG_PATH = "/config.bin";
+ConfigStore configStore(storage, CONFIG_PATH);
+Calibration savedCalibrations[GATE_COUNT];
+bool savedCalibrated[GATE_COUNT] = {};
+uint32_t configSavedMillis = 0;
+int calibrationTask = -1;
+const uint32_t CALIBRATION_CHECK_INTERVAL = 60000;    // msec between checks whether the calibrations need saving
+const uint32_t CALIBRATION_SAVE_INTERVAL = 600000;    // msec between saves of a drifting baseline, to spare the flash
+const int32_t CALIBRATION_SAVE_DRIFT = STATS_ONE;     // 1 cm
+
+// Raw reading recorder, see lib/Trace for the format
+const char* TRACE_PATH = "/trace.bin";
+TraceRecorder traceRecorder(storage, TRACE_PATH);
+int traceFlushTask = -1;
+const uint32_t TRACE_FLUSH_INTERVAL = 100;  // msec between appends of full trace buffers, one fills in ~1.5 sec at burst rate
+
+// Hot path timing for GET /metrics, the log and SSE sinks time themselves
+LatencyHistogram rangingLatency;
+LatencyHistogram detectionLatency;
+
+// The last readings of all gates in RAM, frozen around suspicious events for GET /flight
+FlightRecorder flightRecorder;
+
+// Power management. The soft-AP keeps the radio listening, so savings come from transmitting less
+// and from keeping the CPU asleep between tasks.
+PowerMonitor power(systemClock);
+int beaconMillis;                                     // Beacon interval the soft-AP runs with
+int powerTask = -1;
+const uint32_t POWER_CHECK_INTERVAL = 5000;           // msec between checks whether the soft-AP can take a new beacon interval
+const uint32_t DEEP_IDLE_STATUS_INTERVAL = 5000;      // msec between status events while stopped in power saving mode
+const uint32_t DEEP_IDLE_LOG_FLUSH_INTERVAL = 250;    // msec between log flushes, also the longest loop() sleeps then
 
 /*
 * Main Logic
 */
 
-// index.html contents
-const char index_html[] PROGMEM = R"rawLiteral(
-<!DOCTYPE HTML><html>
- <head>
-    <meta name="viewport" content="width=device-width, initial-scale=1">
-    <style>
-      html {
-        font-family: Arial;
-        display: inline-block;
-        margin: 0px auto;
-        text-align: center;
-      }
-    </style>
-  </head>
-  <body>
-    <h2>Lap Timer</h2>
-    <p>
-      <span>Last Trigger</span>
-      <h1><span id="lasttrigger">%TIMEINTERVAL% sec</span></h1>
-      <br>
-      <br>
-      <button id="btn_startstop" type="button">%STARTSTOP%</button>
-      <h3>Settings</h3>
-      <form action="/parameters" method="post">
-        <label>Ranging Interval (msec)</label>
-        <input type="number" id="ranging-interval" name="interval" value="%DELAY%" step="%STEP%" max="%MAX_DELAY%" min="%MIN_DELAY%">
-        <br>
-        <label>Window Size</label>
-        <input type="number" id="window-size" name="window-size" value="%WINDOW_SIZE%" min="1">
-        <br>
-        <label>Detection Size</label>
-        <input type="number" id="detection-size" name="detection-size" value="%DETECTION_SIZE%" min="1">
-        <br>
-        <label>Percent Difference Trigger</label>
-        <input type="number" id="percent-diff-trigger" name="percent-diff-trigger" value="%PERCENT_DIFF_TRIGGER%" min="1" max="99">
-        <br>
-        <label>After Detection Delay</label>
-        <input type="number" id="after-detection-delay" name="after-detection-delay" value="%AFTER_DETECTION_DELAY%" min="500" max="3000">
-        <br>
-        <label>Log Level</label>
-        <select name="log-level" id="log-level">
-          <!-- Sadly the templating engine of ESPAsyncWebServer is very basic, and I am lazy -->
-          <option value="0" %DEBUGLOGLEVEL%>DEBUG</option>
-          <option value="1" %INFOLOGLEVEL%>INFO</option>
-          <option value="2" %WARNINGLOGLEVEL%>WARNING</option>
-          <option value="3" %ERRORLOGLEVEL%>ERROR</option>
-        </select>
-        <br><br>
-        <input type="submit" value="Update">
-        <input type="reset" value="Reset">
-      </form>
-    </p>
-    <p>
-      <h3>Log</h3>
-      <br>
-      <textarea readonly id="log" rows="50" cols="50"></textarea>
-    </p>
-  </body>
-  <script>
-    document.getElementById("btn_startstop").addEventListener("click", () => {
-        let xhr = new XMLHttpRequest(), data = "start=toggle";
-        xhr.open('POST', '/parameters')
-        xhr.setRequestHeader("Content-Type", "application/x-www-form-urlencoded");
-        xhr.send(data)
-
-        xhr.addEventListener("load", (event) => {
-          window.location.reload(false)
-        })
-    });
-
-    document.addEventListener('DOMContentLoaded', function () {
-      if (!!window.EventSource) {
-        var source = new EventSource('/events');
-
-        source.addEventListener('open', function(e) {
-          console.log("Events Connected");
-        }, false);
-
-        source.addEventListener('error', function(e) {
-          if (e.target.readyState != EventSource.OPEN) {
-            console.log("Events Disconnected");
-          }
-        }, false);
-
-        source.addEventListener('log', function(e) {
-          document.getElementById('log').value += (e.data + "\n");
-        }, false);
-
-        source.addEventListener('trigger', function(e) {
-          const msec = e.data
-          const sec = (parseFloat(msec) / 1000).toFixed(3);
-          document.getElementById('lasttrigger').innerHTML = (sec + " sec");
-        }, false);
-      }
-    }, false);
-  </script>
-</html>
-)rawLiteral";
-
-enum LogLevel: int {
-  DEBUG = 0,
-  INFO = 1,
-  WARNING = 2,
-  ERROR = 3
-};
+/// @brief Send a finished lap over EventSource connection: {"run":3,"lapMillis":41234}
+void sendTrigger(uint32_t runId, uint32_t lapMillis) {
+  char message[48];
+  JsonBuffer buffer(message, sizeof(message));
+  JsonWriter<JsonBuffer> json(buffer);
+  json.beginObject().field("run", runId).field("lapMillis", lapMillis).endObject();
+  events.send(message, "trigger", systemClock.millis());
+}
+
+/// @brief Send a split time over EventSource connection: {"run":3,"split":0,"millis":12034}
+void sendSplit(uint32_t runId, int split, uint32_t splitMillis) {
+  char message[64];
+  JsonBuffer buffer(message, sizeof(message));
+  JsonWriter<JsonBuffer> json(buffer);
+  json.beginObject().field("run", runId).field("split", split).field("millis", splitMillis).endObject();
+  events.send(message, "split", systemClock.millis());
+}
 
-int percentDifference(double lhs, double rhs) {
-  return abs(lhs - rhs) / ((lhs + rhs) / 2) * 100;
+/// @brief The runs on the course, oldest first: [{"run":4,"elapsedMillis":12034},...]
+template <typename Output>
+void writeRuns(JsonWriter<Output>& json) {
+  const uint32_t now = systemClock.micros();
+  json.beginArray();
+  for (int i = 0; i < lapTimer.inFlight(); i++) {
+    const LapTimer::Run& run = lapTimer.run(i);
+    json.beginObject().field("run", run.id).field("elapsedMillis", (now - run.startMicros) / 1000).endObject();
+  }
+  json.endArray();
+}
+
+/// @brief Last recorded lap time in msec, also after a reboot
+long lastLapMillis() {
+  return lapStore.hasLast() ? lapStore.last().durationMicros / 1000 : 0;
 }
 
-/// @brief Send trigger time over EventSource connection
-/// @param triggerMillis Trigger time in msec to convert to string and send
-void sendTrigger(long triggerMillis) {
-  events.send(String(triggerMillis).c_str(), "trigger", millis());
+/// @brief Store the settings and the current calibrations. Gates that are calibrating keep their stored one.
+void saveConfig() {
+  for (int i = 0; i < GATE_COUNT; i++) {
+    Calibration current;
+    if (gates[i].detector.calibration(current)) {
+      savedCalibrations[i] = current;
+      savedCalibrated[i] = true;
+    }
+  }
+
+  configSavedMillis = systemClock.millis();
+  if (!configStore.save(params, savedCalibrations, savedCalibrated, GATE_COUNT)) {
+    LOG_ERROR("Could not save settings");
+  }
 }
 
-LogLevel logLevel = INFO;
-/// @brief Send log message over EventSource connection
-/// @param level The log level
-/// @param message The message
-void sendLog(LogLevel level, String message) {
-  Serial.println(message);
-  if (logLevel <= level) {
-    events.send(message.c_str(), "log", millis());
+/// @brief Scheduler task: save calibrations once they are first known, and after drifting by a cm
+void checkCalibration() {
+  bool save = false;
+  for (int i = 0; i < GATE_COUNT; i++) {
+    Calibration current;
+    if (!gates[i].detector.calibration(current)) {
+      continue;
+    }
+    if (!savedCalibrated[i]) {
+      save = true;
+    } else {
+      const int32_t drift = current.meanFixed - savedCalibrations[i].meanFixed;
+      save |= (drift >= CALIBRATION_SAVE_DRIFT || drift <= -CALIBRATION_SAVE_DRIFT)
+        && systemClock.millis() - configSavedMillis >= CALIBRATION_SAVE_INTERVAL;
+    }
+  }
+
+  if (save) {
+    LOG_DEBUG("Saving calibration");
+    saveConfig();
   }
 }
 
 void restart() {
-  sendLog(DEBUG, "Resetting");
-
-  runDetection = false;
-  detection.clear();
-  window.clear();
-  firstTriggerMillis = 0;
-  potentialTriggerMillis = 0;
-  lastMatchedTriggerMillis = 0;
-}
-
-/// Simple templating engine processor.
-/// See: https://github.com/me-no-dev/ESPAsyncWebServer#template-processing
-String templateProcessor(const String& var) {
-  if (var == "TIMEINTERVAL") {
-    return String(lastMatchedTriggerMillis);
-  } else if (var == "DELAY") {
-    return String(DELAY);
-  } else if (var == "STEP") {
-    return String(STEP);
-  } else if (var == "MAX_DELAY") {
-    return String(MAX_DELAY);
-  } else if (var == "MIN_DELAY") {
-    return String(MIN_DELAY);
-  } else if (var == "STARTSTOP") {
-    return run ? "Stop" : "Start";
-  } else if (var == "WINDOW_SIZE") {
-    return String(WINDOW_SIZE);
-  } else if (var == "DETECTION_SIZE") {
-    return String(DETECTION_SIZE);
-  } else if (var == "PERCENT_DIFF_TRIGGER") {
-    return String(PERCENT_DIFF_TRIGGER);
-  } else if (var == "AFTER_DETECTION_DELAY") {
-    return String(AFTER_DETECTION_DELAY);
-  } else if (var == "DEBUGLOGLEVEL" && logLevel == DEBUG) {
-    return "selected";
-  } else if (var == "INFOLOGLEVEL" && logLevel == INFO) {
-    return "selected";
-  } else if (var == "WARNINGLOGLEVEL" && logLevel == WARNING) {
-    return "selected";
-  } else if (var == "ERRORLOGLEVEL" && logLevel == ERROR) {
-    return "selected";
+  LOG_DEBUG("Resetting");
+
+  // Keep the baselines: a few fresh readings confirm them instead of a full calibration
+  Calibration calibrations[GATE_COUNT];
+  bool calibrated[GATE_COUNT];
+  for (int i = 0; i < GATE_COUNT; i++) {
+    calibrated[i] = gates[i].detector.calibration(calibrations[i]);
+    if (!calibrated[i] && savedCalibrated[i]) {
+      calibrations[i] = savedCalibrations[i];
+      calibrated[i] = true;
+    }
+  }
+
+  gateRanging.restart();
+  for (int i = 0; i < GATE_COUNT; i++) {
+    if (calibrated[i]) {
+      gates[i].detector.warmStart(calibrations[i]);
+    }
+  }
+  scheduler.setPeriod(rangingTask, gateRanging.slotMicros());
+  lapTimer.clear();
+  telemetry.clear();
+}
+
+/// @brief Stopped in power saving mode: nothing to range or chart, the CPU only wakes for the web UI
+bool deepIdle() {
+  return !run && params.powerMode == POWER_SAVING;
+}
+
+int wantedBeaconMillis() {
+  return params.powerMode == POWER_SAVING ? POWER_SAVING_BEACON_MILLIS : POWER_FULL_BEACON_MILLIS;
+}
+
+void startAccessPoint() {
+  beaconMillis = wantedBeaconMillis();
+  WiFi.softAP(ssid, password, 1, 0, 4, beaconMillis);    // Default IP 192.168.4.1
+}
+
+/// @brief Apply the power mode and whether timing runs: transmit power and task rates.
+/// The beacon interval follows in checkPower().
+void applyPowerMode() {
+  WiFi.setOutputPower(params.powerMode == POWER_SAVING ? POWER_SAVING_TX_DBM : POWER_FULL_TX_DBM);
+
+  const bool idle = deepIdle();
+  scheduler.setEnabled(rangingTask, !idle);
+  scheduler.setEnabled(telemetryTask, !idle);
+  scheduler.setPeriod(statusTask, (idle ? DEEP_IDLE_STATUS_INTERVAL : STATUS_INTERVAL) * 1000UL);
+  scheduler.setPeriod(logFlushTask, (idle ? DEEP_IDLE_LOG_FLUSH_INTERVAL : LOG_FLUSH_INTERVAL) * 1000UL);
+}
+
+/// @brief Start or stop timing. Starting begins a new lap history session.
+void setRunning(bool running) {
+  run = running;
+  restart();
+  if (run) {
+    LOG_INFO("Starting session %u", lapStore.beginSession());
+  }
+  applyPowerMode();
+  scheduler.trigger(rangingTask);
+}
+
+/// @brief Start or stop the sensor trace recording
+/// @return false if the recording could not be started
+bool setRecording(bool recording) {
+  if (!recording) {
+    traceRecorder.stop();
+    LOG_INFO("Stopped trace recording. %u samples, %u bytes, %u dropped", (unsigned) traceRecorder.samples(),
+             (unsigned) traceRecorder.size(), (unsigned) traceRecorder.dropped());
+  } else if (traceRecorder.start(systemClock.micros())) {
+    LOG_INFO("Started trace recording");
   } else {
-    return String();
+    LOG_ERROR("Could not start trace recording");
+    return false;
   }
+  return true;
 }
 
-void setup() {
-  // Debug
-  Serial.begin(9600);
+const char* ROLE_NAMES[] = {"start/finish", "start", "split", "finish"};
 
-  // Soft Access Point
-  WiFi.softAP(ssid, password);    // Default IP 192.168.4.1
+uint32_t totalTimeouts() {
+  uint32_t timeouts = 0;
+  for (int i = 0; i < GATE_COUNT; i++) {
+    timeouts += gates[i].timeouts;
+  }
+  return timeouts;
+}
 
-  // Webserver route setup
-  server.on("/", HTTP_GET, [](AsyncWebServerRequest *request) {
-      request -> send_P(200, "text/html", index_html, templateProcessor);
-  });
-  server.on("/parameters", HTTP_POST, [](AsyncWebServerRequest *request) {
-    if (request -> hasParam("interval", true)) {
-      AsyncWebParameter* p = request->getParam("interval", true);
-      
-      int newdelay = (p -> value()).toInt();
-      if (newdelay != 0 && newdelay >= MIN_DELAY) {
-        DELAY = (p -> value()).toInt();
-        sendLog(INFO, "Updated DELAY to: " + String(DELAY));
-        request -> redirect("/");
+const char* runState() {
+  return !run ? "Stopped" : gateRanging.holdingOff() ? "Holdoff" : "Ranging";
+}
+
+/// @brief Scheduler task: ping the next gate. The echo is picked up by pollRanging().
+void ranging() {
+  if (!run) {
+    return;
+  }
+  LatencyTimer timer(systemClock, rangingLatency);
+
+  if (!gateRanging.ping()) {
+    LOG_WARNING("Previous measurement still in flight, skipping reading");
+  }
+  // Burst mode decays a little with every ping
+  scheduler.setPeriod(rangingTask, gateRanging.slotMicros());
+}
+
+/// @brief Called from loop(): run a completed measurement through its gate's detector
+void pollRanging() {
+  int index;
+  long reading;
+  uint32_t pingMicros;
+  if (!gateRanging.poll(index, reading, pingMicros)) {
+    return;
+  }
+
+  // Stopped while the echo was in flight
+  if (!run) {
+    return;
+  }
+
+  Gate& gate = gateRanging.gate(index);
+  if (reading == RANGER_TIMEOUT) {
+    LOG_DEBUG("%s: No echo within %d cm", gate.name, RANGER_MAX_CM);
+  }
+
+  // The trace format has no gate field, it records the first gate
+  if (index == 0) {
+    traceRecorder.add(pingMicros, reading);
+  }
+  const uint32_t detectionStartMicros = systemClock.micros();
+  const Detector::Result result = gate.detector.update(reading, pingMicros);
+  detectionLatency.record(systemClock.micros() - detectionStartMicros);
+  flightRecorder.add(pingMicros, reading, traceState(index, result.event));
+
+  // Switch to the maximum rate right away: the next ping comes one burst slot after this one
+  if (gate.detector.deviating(result) && gateRanging.burst()) {
+    scheduler.setPeriod(rangingTask, gateRanging.slotMicros());
+    scheduler.reschedule(rangingTask, pingMicros + gateRanging.slotMicros());
+    LOG_DEBUG("%s: Burst mode, ranging every %u usec", gate.name, (unsigned) gateRanging.gateIntervalMicros());
+  }
+
+  LOG_DEBUG("%s: Reading: %ld Average: %d", gate.name, reading, result.average);
+
+  // Detection decisions stay on the chart even when it is downsampled
+  const bool decision = result.event == Detector::POTENTIAL_TRIGGER || result.event == Detector::FLUKE
+    || result.event == Detector::TRIGGER;
+  telemetry.add(systemClock.millis(), reading, result.average, result.event, decision, index);
+
+  switch (result.event) {
+    case Detector::CALIBRATING:
+      LOG_DEBUG("%s: Calibrating %d/%d Current avg.: %d", gate.name, gate.detector.windowFill(), params.windowSize, result.average);
+      if (gate.detector.warmStarted() && gate.detector.windowFill() == params.windowSize) {
+        LOG_INFO("%s: Stored calibration confirmed, avg.: %d", gate.name, result.average);
+      }
+      break;
+    case Detector::POTENTIAL_TRIGGER:
+      if (params.detectionMethod == DETECTION_STATISTICAL) {
+        LOG_INFO("%s: Reading z-score: %d.%02d Starting detection.", gate.name, result.zScore / 100, result.zScore % 100);
       } else {
-        sendLog(WARNING, "Received invalid new DELAY value: " + p -> value());
-        request -> send(401);
+        LOG_INFO("%s: Reading %% difference: %d Starting detection.", gate.name, result.percentDiff);
       }
-    }
+      LOG_DEBUG("Potential trigger. Starting detection phase.");
+      break;
+    case Detector::DETECTING:
+      LOG_DEBUG("%s: Detection %d/%d", gate.name, gate.detector.detectionFill(), params.detectionSize);
+      break;
+    case Detector::FLUKE:
+    case Detector::TRIGGER:
+      if (params.detectionMethod == DETECTION_STATISTICAL) {
+        LOG_INFO("%s: Average detection distance: %d Current avg.: %d  z-score: %d.%02d", gate.name, result.detectionAverage, result.average, result.zScore / 100, result.zScore % 100);
+      } else {
+        LOG_INFO("%s: Average detection distance: %d Current avg.: %d  Diff: %d%%", gate.name, result.detectionAverage, result.average, result.percentDiff);
+      }
+      LOG_INFO("Detection complete. isTrigger: %d", result.event != Detector::FLUKE);
+      if (result.event == Detector::FLUKE) {
+        gate.flukes++;
+        flightRecorder.freeze("fluke");
+      } else {
+        gate.triggers++;
+      }
+      break;
+    case Detector::NONE:
+    case Detector::TIMEOUT:
+      break;
+  }
 
-    if (request -> hasParam("start", true)) {
-      run = !run;
-      request -> send(200);
-      restart();
-    }
+  if (result.event != Detector::TRIGGER) {
+    return;
+  }
 
-    if (request -> hasParam("window-size", true)) {
-      AsyncWebParameter* p = request->getParam("window-size", true);
-      int windowSize = (p -> value()).toInt();
-      if (windowSize < 1) {
-        request -> send(400);
-        sendLog(WARNING, "Received invalid new WINDOW_SIZE value: " + p -> value());
-        return;
+  // Give the bike time to leave the beam before looking for the next one
+  gateRanging.startHoldoff(index);
+
+  const LapTimer::Result crossing = lapTimer.crossing(result.crossingMicros, result.confidence, gate.role, gate.split);
+  if (crossing.abandoned > 0) {
+    LOG_WARNING("Dropped %d runs without a finish within %d msec", crossing.abandoned, params.maxLapTime);
+    flightRecorder.freeze("abandoned run");
+  }
+
+  switch (crossing.event) {
+    case LapTimer::STARTED:
+      LOG_INFO("Run %u started, %d on course", (unsigned) crossing.runId, lapTimer.inFlight());
+      break;
+    case LapTimer::SPLIT_TIME:
+      sendSplit(crossing.runId, crossing.split, crossing.lapMicros / 1000);
+      LOG_INFO("Run %u split %d: %lu.%03lu msec", (unsigned) crossing.runId, crossing.split + 1, (unsigned long) crossing.lapMicros / 1000, (unsigned long) crossing.lapMicros % 1000);
+      break;
+    case LapTimer::FINISHED:
+      if (lapStore.full()) {
+        LOG_WARNING("Lap history full, clear it to store new laps");
+      } else if (!lapStore.append(crossing.startMicros, crossing.endMicros, crossing.lapMicros, crossing.confidence)) {
+        LOG_ERROR("Could not store lap");
       }
-      sendLog(INFO, "Updated WINDOW_SIZE to: " + String(windowSize));
+      sendTrigger(crossing.runId, crossing.lapMicros / 1000);
+      LOG_INFO("Run %u finished: %lu.%03lu msec", (unsigned) crossing.runId, (unsigned long) crossing.lapMicros / 1000, (unsigned long) crossing.lapMicros % 1000);
+      break;
+    case LapTimer::IGNORED:
+      LOG_WARNING("%s: No run to assign the crossing to, ignoring it", gate.name);
+      flightRecorder.freeze("ignored crossing");
+      break;
+  }
+}
+
+/// @brief Scheduler task: send current state, the runs on the course and ranging jitter to the web UI
+void sendStatus() {
+  const int abandoned = lapTimer.expire(systemClock.micros());
+  if (abandoned > 0) {
+    LOG_WARNING("Dropped %d runs without a finish within %d msec", abandoned, params.maxLapTime);
+  }
+
+  char runs[384];
+  JsonBuffer buffer(runs, sizeof(runs));
+  JsonWriter<JsonBuffer> json(buffer);
+  writeRuns(json);
+  events.send(runs, "runs", systemClock.millis());
+
+  const JitterStats& stats = scheduler.stats(rangingTask);
+  char status[176];
+  snprintf(status, sizeof(status), "%s%s | every %u msec | jitter avg. %u usec, max %u usec, %u skipped | %u timeouts | %u log messages dropped | awake %u.%u%%",
+           runState(), gateRanging.bursting() ? " (burst)" : deepIdle() ? " (deep idle)" : "", (unsigned) gateRanging.gateIntervalMicros() / 1000, (unsigned) stats.meanLateMicros(), (unsigned) stats.maxLateMicros, (unsigned) stats.skipped, (unsigned) totalTimeouts(), (unsigned) logger.dropped(),
+           (unsigned) power.dutyCyclePermille() / 10, (unsigned) power.dutyCyclePermille() % 10);
+  events.send(status, "status", systemClock.millis());
+}
 
-      WINDOW_SIZE = windowSize;
-      restart();
+/// @brief Scheduler task: log jitter statistics of every task and start a new measurement period
+void logJitter() {
+  for (int task = 0; task < scheduler.size(); task++) {
+    const JitterStats& stats = scheduler.stats(task);
+    LOG_DEBUG("%s: %u runs, late avg. %u usec, max %u usec, %u skipped, longest run %u usec", scheduler.name(task),
+              (unsigned) stats.runs, (unsigned) stats.meanLateMicros(), (unsigned) stats.maxLateMicros, (unsigned) stats.skipped, (unsigned) stats.maxRunMicros);
+  }
+  scheduler.resetStats();
+}
+
+/// @brief Scheduler task: restart the soft-AP with the beacon interval of the power mode. A restart drops
+/// the phones, so it waits until none is connected, e.g. the next morning.
+void checkPower() {
+  if (beaconMillis != wantedBeaconMillis() && WiFi.softAPgetStationNum() == 0) {
+    startAccessPoint();
+    applyPowerMode();
+    LOG_INFO("Soft-AP beacon interval now %d msec", beaconMillis);
+  }
+}
+
+/// @brief Scheduler task: send the pending telemetry frame if it got old, e.g. during holdoff
+void pollTelemetry() {
+  telemetry.poll(systemClock.millis());
+}
+
+/// @brief Scheduler task: write queued log messages to Serial and the web UI
+void flushLog() {
+  logger.flush();
+}
+
+/// @brief Scheduler task: append full trace buffers to flash, away from the ranging hot path
+void flushTrace() {
+  traceRecorder.flushFull();
+}
+
+/// @brief GET /metrics in the Prometheus text format
+void sendMetrics(AsyncWebServerRequest *request) {
+  AsyncResponseStream *response = request -> beginResponseStream("text/plain; version=0.0.4");
+  PrometheusWriter<AsyncResponseStream> metrics(*response);
+
+  metrics.family("laptimer_uptime_seconds", "gauge", "Time since boot")
+    .sample("laptimer_uptime_seconds", systemClock.millis() / 1000);
+  metrics.family("laptimer_heap_free_bytes", "gauge", "Free heap")
+    .sample("laptimer_heap_free_bytes", ESP.getFreeHeap());
+  metrics.family("laptimer_heap_max_free_block_bytes", "gauge", "Largest allocatable block, low values mean fragmentation")
+    .sample("laptimer_heap_max_free_block_bytes", ESP.getMaxFreeBlockSize());
+  metrics.family("laptimer_sse_clients", "gauge", "Connected /events clients")
+    .sample("laptimer_sse_clients", events.clients());
+  metrics.family("laptimer_sse_dropped_total", "counter", "Events a slow client did not get, by class");
+  for (int i = 0; i < PRIORITY_COUNT; i++) {
+    metrics.sample("laptimer_sse_dropped_total", "class", BROADCAST_PRIORITY_NAMES[i], events.dropped((BroadcastPriority) i));
+  }
+  metrics.family("laptimer_sse_coalesced_total", "counter", "State events replaced by a newer one before they were sent")
+    .sample("laptimer_sse_coalesced_total", events.coalesced());
+  metrics.family("laptimer_sse_slow_clients_closed_total", "counter", "Clients closed for falling behind on triggers, they resume from the journal")
+    .sample("laptimer_sse_slow_clients_closed_total", events.slowClientsClosed());
+  metrics.family("laptimer_cpu_awake_permille", "gauge", "Share of the last 10 sec the CPU was not sleeping in loop()")
+    .sample("laptimer_cpu_awake_permille", power.dutyCyclePermille());
+  metrics.family("laptimer_estimated_current_milliamps", "gauge", "Board current estimated from the duty cycle and power mode")
+    .sample("laptimer_estimated_current_milliamps", power.estimatedMilliamps(params.powerMode == POWER_SAVING));
+  metrics.family("laptimer_log_dropped_total", "counter", "Log messages dropped because the queue was full")
+    .sample("laptimer_log_dropped_total", logger.dropped());
+
+  metrics.family("laptimer_lap_history_records", "gauge", "Laps on flash, damaged ones included")
+    .sample("laptimer_lap_history_records", lapStore.size());
+  metrics.family("laptimer_lap_history_capacity", "gauge", "Laps that fit before the history has to be cleared")
+    .sample("laptimer_lap_history_capacity", LAPSTORE_MAX_RECORDS);
+  metrics.family("laptimer_lap_history_damaged", "gauge", "Damaged laps skipped since boot")
+    .sample("laptimer_lap_history_damaged", lapStore.damaged());
+
+  metrics.family("laptimer_ranging_timeouts_total", "counter", "Pings without an echo");
+  for (int i = 0; i < GATE_COUNT; i++) {
+    metrics.sample("laptimer_ranging_timeouts_total", "gate", gates[i].name, gates[i].timeouts);
+  }
+  metrics.family("laptimer_triggers_total", "counter", "Confirmed gate crossings");
+  for (int i = 0; i < GATE_COUNT; i++) {
+    metrics.sample("laptimer_triggers_total", "gate", gates[i].name, gates[i].triggers);
+  }
+  metrics.family("laptimer_flukes_total", "counter", "Potential triggers the detection window rejected");
+  for (int i = 0; i < GATE_COUNT; i++) {
+    metrics.sample("laptimer_flukes_total", "gate", gates[i].name, gates[i].flukes);
+  }
+
+  metrics.family("laptimer_duration_seconds", "histogram", "Time spent in the hot path: pinging, a detector step, formatting a log message, queueing an SSE event")
+    .histogram("laptimer_duration_seconds", "section", "ranging", rangingLatency)
+    .histogram("laptimer_duration_seconds", "section", "detection", detectionLatency)
+    .histogram("laptimer_duration_seconds", "section", "log", logger.writeLatency())
+    .histogram("laptimer_duration_seconds", "section", "sse_send", events.sendLatency());
+
+  request -> send(response);
+}
+
+/// @brief Body handler: collect a small JSON request body as a C string in request->_tempObject.
+/// The server frees _tempObject along with the request.
+void collectBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+  if (total > API_MAX_BODY) {
+    return;
+  }
+  if (index == 0) {
+    request -> _tempObject = malloc(total + 1);
+  }
+  if (request -> _tempObject == NULL) {
+    return;
+  }
+  char* body = (char*) request -> _tempObject;
+  memcpy(body + index, data, len);
+  body[index + len] = '\0';
+}
+
+void sendError(AsyncWebServerRequest *request, int code, const char* message) {
+  AsyncResponseStream *response = request -> beginResponseStream("application/json");
+  response -> setCode(code);
+  JsonWriter<AsyncResponseStream> json(*response);
+  json.beginObject().field("error", message).endObject();
+  request -> send(response);
+}
+
+/// @brief The collected request body, or NULL after replying with an error
+const char* requestBody(AsyncWebServerRequest *request) {
+  if (request -> _tempObject == NULL) {
+    if (request -> contentLength() > API_MAX_BODY) {
+      sendError(request, 413, "request body too large");
+    } else {
+      sendError(request, 400, "expected a JSON body");
     }
+    return NULL;
+  }
+  return (const char*) request -> _tempObject;
+}
 
-    if (request -> hasParam("detection-size", true)) {
-      AsyncWebParameter* p = request->getParam("detection-size", true);
-      int windowSize = (p -> value()).toInt();
-      if (windowSize < 1) {
-        request -> send(400);
-        sendLog(WARNING, "Received invalid new DETECTION_SIZE value: " + p -> value());
-        return;
-      }
-      sendLog(INFO, "DETECTION_SIZE WINDOW_SIZE to: " + String(windowSize));
+void sendState(AsyncWebServerRequest *request) {
+  const JitterStats& stats = scheduler.stats(rangingTask);
+
+  AsyncResponseStream *response = request -> beginResponseStream("application/json");
+  JsonWriter<AsyncResponseStream> json(*response);
+  json.beginObject()
+    .field("running", run)
+    .field("state", runState())
+    .field("session", lapStore.currentSession())
+    .field("lastLapMillis", lastLapMillis())
+    .field("lastLapRun", lapTimer.lastLapRunId())
+    .field("recording", traceRecorder.recording())
+    .field("uptimeMillis", systemClock.millis())
+    .field("timeouts", totalTimeouts())
+    .field("gateIntervalMicros", gateRanging.gateIntervalMicros())
+    .field("bursting", gateRanging.bursting())
+    .field("droppedLogMessages", logger.dropped())
+    .field("telemetryDecimation", telemetry.decimation());
+  json.key("runs");
+  writeRuns(json);
+  json.key("gates").beginArray();
+  for (int i = 0; i < GATE_COUNT; i++) {
+    json.beginObject()
+      .field("name", gates[i].name)
+      .field("role", ROLE_NAMES[gates[i].role])
+      .field("holdoff", gates[i].holdoff)
+      .field("warmStart", gates[i].detector.warmStarted())
+      .field("sampleIntervalMicros", gates[i].detector.sampleIntervalMicros())
+      .field("timeouts", gates[i].timeouts)
+      .endObject();
+  }
+  json.endArray();
+  json.key("lapHistory").beginObject()
+    .field("records", lapStore.size())
+    .field("capacity", LAPSTORE_MAX_RECORDS)
+    .field("full", lapStore.full())
+    .field("damaged", lapStore.damaged())
+    .endObject();
+  json.key("flightRecorder").beginObject()
+    .field("samples", flightRecorder.samples())
+    .field("frozen", flightRecorder.frozen())
+    .field("freezing", flightRecorder.freezing())
+    .field("reason", flightRecorder.reason())
+    .endObject();
+  const bool saving = params.powerMode == POWER_SAVING;
+  json.key("power").beginObject()
+    .field("deepIdle", deepIdle())
+    .field("beaconMillis", beaconMillis)
+    .field("dutyCyclePermille", power.dutyCyclePermille())
+    .field("estimatedMilliamps", power.estimatedMilliamps(saving))
+    .field("batteryMinutes", power.batteryMinutes(params.batteryCapacity, saving))
+    .endObject();
+  json.key("jitter").beginObject()
+    .field("meanLateMicros", stats.meanLateMicros())
+    .field("maxLateMicros", stats.maxLateMicros)
+    .field("skipped", stats.skipped)
+    .endObject();
+  json.endObject();
+  request -> send(response);
+}
 
-      DETECTION_SIZE = windowSize;
-      restart();
+void sendConfig(AsyncWebServerRequest *request) {
+  AsyncResponseStream *response = request -> beginResponseStream("application/json");
+  JsonWriter<AsyncResponseStream> json(*response);
+  writeConfig(json, params);
+  request -> send(response);
+}
+
+/// @brief Act on the settings that differ from previous
+void configChanged(const Parameters& previous) {
+  bool changed = false;
+  bool restartDetector = false;
+  for (int i = 0; i < PARAMETER_FIELD_COUNT; i++) {
+    const ParameterField& field = PARAMETER_FIELDS[i];
+    if (previous.*field.value != params.*field.value) {
+      LOG_INFO("Updated %s to: %d", field.name, params.*field.value);
+      changed = true;
+      restartDetector |= field.restartsDetector;
     }
+  }
+  // Nothing to apply, and no flash write for an empty or repeated request
+  if (!changed) {
+    return;
+  }
 
-    if (request -> hasParam("percent-diff-trigger", true)) {
-      AsyncWebParameter* p = request->getParam("percent-diff-trigger", true);
-      int param = (p -> value()).toInt();
-      if (param < 1 || param > 99) {
-        request -> send(400);
-        sendLog(WARNING, "Received invalid new PERCENT_DIFF_TRIGGER value: " + p -> value());
-        return;
-      }
-      sendLog(INFO, "PERCENT_DIFF_TRIGGER to: " + String(param));
-      
-      PERCENT_DIFF_TRIGGER = param;
-      restart();
+  scheduler.setPeriod(rangingTask, gateRanging.slotMicros());
+  logger.setLevel(params.logLevel);
+  applyPowerMode();
+  saveConfig();
+  if (restartDetector) {
+    restart();
+  }
+}
+
+/// @brief Register a scheduler task. SCHEDULER_MAX_TASKS has room for all of them, so a full
+/// scheduler is a bug; the scheduler ignores the -1 id then.
+int addTask(const char* name, Scheduler::TaskCallback callback, uint32_t periodMicros) {
+  const int task = scheduler.add(name, callback, periodMicros);
+  if (task < 0) {
+    LOG_ERROR("No scheduler slot for task %s", name);
+  }
+  return task;
+}
+
+void setup() {
+  // Debug
+  Serial.begin(115200);
+  // Event ids start over on every boot, the random part keeps a page's Last-Event-ID from an earlier boot apart
+  events.begin(ESP.random());
+  logger.begin(systemClock);
+  logger.setLevel(params.logLevel);
+  logger.addSink(serialSink);
+  logger.addSink(events);
+
+  storage.begin();
+  lapStore.begin();
+  if (lapStore.damaged() > 0) {
+    LOG_WARNING("Lap history: skipped %u damaged laps", (unsigned) lapStore.damaged());
+  }
+
+  // Before loading the settings: restart() sets the period of the ranging task. Nothing runs before loop().
+  rangingTask = addTask("ranging", ranging, gateRanging.slotMicros());
+  statusTask = addTask("status", sendStatus, STATUS_INTERVAL * 1000UL);
+  jitterLogTask = addTask("jitterlog", logJitter, JITTER_LOG_INTERVAL * 1000UL);
+  logFlushTask = addTask("logflush", flushLog, LOG_FLUSH_INTERVAL * 1000UL);
+  traceFlushTask = addTask("traceflush", flushTrace, TRACE_FLUSH_INTERVAL * 1000UL);
+  telemetryTask = addTask("telemetry", pollTelemetry, TELEMETRY_POLL_INTERVAL * 1000UL);
+  calibrationTask = addTask("calibration", checkCalibration, CALIBRATION_CHECK_INTERVAL * 1000UL);
+  powerTask = addTask("power", checkPower, POWER_CHECK_INTERVAL * 1000UL);
+
+  if (configStore.load(params, savedCalibrations, savedCalibrated, GATE_COUNT)) {
+    LOG_INFO("Loaded settings from flash");
+    logger.setLevel(params.logLevel);
+    // Apply the loaded window sizes and warm start from the stored calibrations
+    restart();
+  }
+
+  // Soft Access Point
+  startAccessPoint();
+
+  // Webserver route setup
+  server.on("/", HTTP_GET, [](AsyncWebServerRequest *request) {
+    // The page is static, so a matching ETag means the browser's copy is current
+    if (request -> hasHeader("If-None-Match") && request -> getHeader("If-None-Match") -> value() == INDEX_HTML_ETAG) {
+      AsyncWebServerResponse *response = request -> beginResponse(304);
+      response -> addHeader("ETag", INDEX_HTML_ETAG);
+      request -> send(response);
+      return;
     }
 
-    if (request -> hasParam("after-detection-delay", true)) {
-      AsyncWebParameter* p = request->getParam("after-detection-delay", true);
-      int param = (p -> value()).toInt();
-      if (param < 500 || param > 3000) {
-        request -> send(400);
-        sendLog(WARNING, "Received invalid new AFTER_DETECTION_DELAY value: " + p -> value());
+    AsyncWebServerResponse *response = request -> beginResponse_P(200, "text/html", INDEX_HTML_GZ, INDEX_HTML_GZ_SIZE);
+    response -> addHeader("Content-Encoding", "gzip");
+    response -> addHeader("ETag", INDEX_HTML_ETAG);
+    // Cache, but ask every time whether the page is still current
+    response -> addHeader("Cache-Control", "no-cache");
+    request -> send(response);
+  });
+  server.on("/api/v1/state", HTTP_GET, [](AsyncWebServerRequest *request) {
+    sendState(request);
+  });
+  server.on("/api/v1/state", HTTP_POST, [](AsyncWebServerRequest *request) {
+    const char* body = requestBody(request);
+    if (body == NULL) {
+      return;
+    }
+
+    // Check the whole body before acting on any of it, -1 means not given
+    int running = -1;
+    int recording = -1;
+    int frozen = -1;
+    JsonReader reader(body, strlen(body));
+    JsonMember member;
+    while (reader.next(member)) {
+      int* target = member.is("running") ? &running : member.is("recording") ? &recording
+        : member.is("frozen") ? &frozen : NULL;
+      if (target == NULL || member.type != JSON_BOOL) {
+        sendError(request, 400, "expected running, recording and/or frozen as true or false");
         return;
       }
-      sendLog(INFO, "AFTER_DETECTION_DELAY to: " + String(param));
+      *target = member.flag;
+    }
+    if (reader.error() != NULL) {
+      sendError(request, 400, reader.error());
+      return;
+    }
 
-      AFTER_DETECTION_DELAY = param;
-      restart();
+    if (recording != -1 && recording != traceRecorder.recording() && !setRecording(recording)) {
+      sendError(request, 500, "could not start trace recording");
+      return;
     }
+    if (running != -1 && running != run) {
+      setRunning(running);
+    }
+    if (frozen == 1) {
+      flightRecorder.freeze("manual");
+    } else if (frozen == 0) {
+      flightRecorder.release();
+    }
+    sendState(request);
+  }, NULL, collectBody);
 
-    if (request -> hasParam("log-level", true)) {
-      AsyncWebParameter* p = request->getParam("log-level", true);
-      String level = p -> value();
-      // Could probably just have frontend pass int here...
-      if (level == "0") {
-        logLevel = DEBUG;
-      } else if (level == "1") {
-        logLevel = INFO;
-      } else if (level == "2") {
-        logLevel = WARNING;
-      } else if (level == "3") {
-        logLevel = ERROR;
-      } else {
-        sendLog(WARNING, "Received invalid new log level: " + level);
-        return;
-      }
-      sendLog(INFO, "Set new log level: " + level);
+  server.on("/api/v1/config", HTTP_GET, [](AsyncWebServerRequest *request) {
+    sendConfig(request);
+  });
+  server.on("/api/v1/config", HTTP_POST, [](AsyncWebServerRequest *request) {
+    const char* body = requestBody(request);
+    if (body == NULL) {
+      return;
+    }
+
+    const Parameters previous = params;
+    char error[64];
+    if (!applyConfig(body, strlen(body), params, error, sizeof(error))) {
+      LOG_WARNING("Rejected settings update: %s", error);
+      sendError(request, 400, error);
+      return;
     }
+    configChanged(previous);
+    sendConfig(request);
+  }, NULL, collectBody);
+
+  server.on("/api/v1/laps", HTTP_GET, [](AsyncWebServerRequest *request) {
+    const uint16_t session = request -> hasParam("session") ? request -> getParam("session") -> value().toInt() : 0;
+    const uint32_t offset = request -> hasParam("offset") ? request -> getParam("offset") -> value().toInt() : 0;
+    const uint32_t limit = request -> hasParam("limit") ? request -> getParam("limit") -> value().toInt() : LAPS_DEFAULT_LIMIT;
+
+    // Streams a block of records at a time from flash, the response is never held in RAM as a whole
+    LapJsonStream stream(lapStore, session, offset, limit);
+    request -> send(request -> beginChunkedResponse("application/json", [stream](uint8_t *buffer, size_t maxLen, size_t index) mutable -> size_t {
+      return stream.read(buffer, maxLen);
+    }));
   });
-  server.on("/parameters", HTTP_GET, [](AsyncWebServerRequest *request) {
-    String formData = "";
-    formData += "TIMEINTERVAL=" + String(lastMatchedTriggerMillis) + "\n";
-    formData += "DELAY=" + String(DELAY) + "\n";
-    formData += "MAX_DELAY=" + String(MAX_DELAY) + "\n";
-    formData += "MIN_DELAY=" + String(MIN_DELAY) + "\n";
-    formData += "STARTSTOP=" + run ? "Start" : "Stop" + String("\n");
-    formData += "WINDOW_SIZE=" + String(WINDOW_SIZE) + "\n";
-    formData += "DETECTION_SIZE=" + String(DETECTION_SIZE) + "\n";
-    formData += "PERCENT_DIFF_TRIGGER=" + String(PERCENT_DIFF_TRIGGER) + "\n";
-    formData += "AFTER_DETECTION_DELAY=" + String(AFTER_DETECTION_DELAY) + "\n";
-    formData += "DEBUGLOGLEVEL=" + String(logLevel) + "\n";
-    request -> send(200, "text/plain", formData);
+  server.on("/api/v1/laps", HTTP_DELETE, [](AsyncWebServerRequest *request) {
+    lapStore.clear();
+    LOG_INFO("Cleared lap history");
+    sendState(request);
   });
-  
-  // EventSource setup
-  events.onConnect([](AsyncEventSourceClient *client) {
-    client -> send(String(lastMatchedTriggerMillis).c_str(), NULL, millis(), 1000);
+  server.on("/api/v1/sessions", HTTP_GET, [](AsyncWebServerRequest *request) {
+    AsyncResponseStream *response = request -> beginResponseStream("application/json");
+    JsonWriter<AsyncResponseStream> json(*response);
+    json.beginArray();
+    for (int i = 0; i < lapStore.sessionCount(); i++) {
+      uint16_t session;
+      uint32_t firstRecord;
+      uint32_t laps;
+      lapStore.sessionAt(i, session, firstRecord, laps);
+      json.beginObject().field("session", session).field("laps", laps).endObject();
+    }
+    json.endArray();
+    request -> send(response);
   });
-  server.addHandler(&events);
-  server.begin();
-}
 
-void loop() {
-  if (!run) {
-    delay(DELAY);
-    return;
-  }
-  
-  long timeSinceBoot = millis();
+  server.on("/trace", HTTP_GET, [](AsyncWebServerRequest *request) {
+    traceRecorder.flush();
+    // Stream straight from flash, a day of readings does not fit in RAM
+    request -> send(request -> beginChunkedResponse("application/octet-stream", [](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+      return storage.read(TRACE_PATH, index, buffer, maxLen);
+    }));
+  });
 
-  int reading = ultrasonic.MeasureInCentimeters();
-  int average = window.average();
+  server.on("/metrics", HTTP_GET, [](AsyncWebServerRequest *request) {
+    sendMetrics(request);
+  });
 
-  sendLog(DEBUG, "Reading: " + String(reading) + " Average: " + String(window.average()));
+  server.on("/flight", HTTP_GET, [](AsyncWebServerRequest *request) {
+    // Encoded straight from the ring buffer. New readings are dropped until the download completes.
+    const uint32_t dump = flightRecorder.beginDump();
+    if (dump == 0) {
+      sendError(request, 503, "flight recorder download already in progress");
+      return;
+    }
+    request -> send(request -> beginChunkedResponse("application/octet-stream", [dump](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+      return flightRecorder.readDump(dump, buffer, maxLen);
+    }));
+  });
 
-  // we must allow window to fill in order for our average calculation to be useful
-  if (window.size() != WINDOW_SIZE) {
-    window.append(reading);
-    sendLog(DEBUG, "Calibrating " + String(window.size()) + "/" + String(WINDOW_SIZE) + "Current avg.: " + String(window.average()));
-    delay(DELAY);
+  server.addHandler(&eventsHandler);
+  server.begin();
 
-    Serial.println("----------------------------------------");
-    return;
-  }
+  applyPowerMode();
+}
 
-  const int percentDiff = percentDifference(reading, average);
-
-  // if (percentDiff > 100) {
-  //   // something triggered further away, we ignore this for now.
-  //   sendLog(DEBUG, "Percent difference " + String(percentDiff) + " > 100, ignoring.");
-  //   delay(DELAY);
-
-  //   Serial.println("----------------------------------------");
-  //   return;
-  // }
-
-  if (runDetection == false) {
-    window.append(reading);
-  }
-  
-  if (runDetection == false && percentDiff >= PERCENT_DIFF_TRIGGER) {
-    runDetection = true;
-    sendLog(INFO, "Reading % difference: " + String(percentDiff) + " Starting detection.");
-  }
-
-  if (runDetection && detection.size() == 0) {
-    // Initial measurement. Start rolling window to see if we actually have a trigger
-    runDetection = true;
-    potentialTriggerMillis = timeSinceBoot;
-    detection.append(reading);
-    
-    sendLog(DEBUG, "Potential trigger. Starting stopwatch. Starting detection phase.");
-  } else if (runDetection && detection.size() < DETECTION_SIZE) {
-    // Still need to fill detection window...
-    detection.append(reading);
-    
-    sendLog(DEBUG, String("Detection ") + String(detection.size()) + String("/") + String(DETECTION_SIZE));
-  } else if (runDetection && detection.size() >= DETECTION_SIZE) {
-    // Window is full...Check if conditions are right for a trigger
-    runDetection = false;
-    int percentDiff = percentDifference(detection.average(), window.average());
-    const bool isTrigger = percentDiff > PERCENT_DIFF_TRIGGER;
-    sendLog(INFO, "Average detection distance: " + String(detection.average()) + " Current avg.: " + String(window.average()) + "  Diff: " + String(percentDiff) + "%");
-    sendLog(INFO, "Detection complete. isTrigger: " + String(isTrigger));
-    // We must clear the detection window so we do not immediately register the next close reading as a trigger
-    detection.clear();
-
-    if (isTrigger && firstTriggerMillis == 0) {
-      sendLog(INFO, "Trigger 1/2");
-      firstTriggerMillis = potentialTriggerMillis;
-    } else if (isTrigger && firstTriggerMillis != 0) {
-      // MATCHED TRIGGER
-      lastMatchedTriggerMillis = millis() - firstTriggerMillis;
-      sendTrigger(lastMatchedTriggerMillis);
-      sendLog(INFO, String("Trigger 2/2: Time between triggers: ") + String(lastMatchedTriggerMillis) + " msec");
-      potentialTriggerMillis = 0;
-      firstTriggerMillis = 0;
-
-      delay(AFTER_DETECTION_DELAY);
-    } else {
-      // fluke, discard potential trigger
-      potentialTriggerMillis = 0;
-    }
+void loop() {
+  scheduler.run();
+  pollRanging();
+  events.pump();
+
+  // Sleep in whole msec while the next deadline is far enough away so we never oversleep it, yield otherwise.
+  // Keep polling while an echo is in flight. The msec of margin keeps wake-up latency out of the ping timing.
+  const uint32_t idleMicros = scheduler.microsUntilNext();
+  if (!gateRanging.measuring() && idleMicros >= 2000) {
+    power.sleep(idleMicros / 1000 - 1);
+  } else {
+    yield();
   }
-  
-  Serial.println("----------------------------------------");
-  delay(DELAY);
-
-  // Serial.println("-------------------------------------");
-  // Serial.println("Number of WiFi clients: " + String(WiFi.softAPgetStationNum()));
-  // Serial.println("Last TimeInterval: " + String(currentTimeInterval));
-  // Serial.println("DELAY: " + String(DELAY));
-  // Serial.println("Window average:" + String(window -> average()));
-  // Serial.println("-------------------------------------");
+  power.update();
 }
@@ -0,0 +1,309 @@
+// Host microbenchmarks of the timing hot path: time and heap allocations per operation.
+//
+//   pio run -e bench && .pio/build/bench/program [--json] [--iterations=<n>] [--filter=<text>]
+//
+// Covers the baseline estimators, percentDifference, a detector step per detection method, the same
+// with window sizes fixed at compile time, one firmware detection step (detector, flight recorder,
+// telemetry and a disabled DEBUG log), the config API rendering and parsing, log formatting, and
+// sending an event to four web UI clients.
+// --json prints
+//   {"iterations":n,"results":[{"name":"...","nsPerOp":1.2,"allocsPerOp":0},...]}
+// for comparing commits, e.g. with jq. Allocations are counted through operator new; the hot path
+// should have none.
+//
+// Input is a baseline with noise and 2% zero readings, like missed echoes, and a bike crossing the
+// gate every 400 readings. Host timings only show how code paths compare, the ESP8266 is a lot slower.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <new>
+#include <vector>
+#include "ConfigApi.h"
+#include "Detector.h"
+#include "EventBroadcaster.h"
+#include "EventConnection.h"
+#include "EventSink.h"
+#include "FlightRecorder.h"
+#include "HampelFilter.h"
+#include "JsonWriter.h"
+#include "Log.h"
+#include "Parameters.h"
+#include "RollingMedian.h"
+#include "RollingWindow.h"
+#include "Telemetry.h"
+#include "VirtualClock.h"
+
+static unsigned long allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    void* block = malloc(size > 0 ? size : 1);
+    if (block == NULL)
+        throw std::bad_alloc();
+    return block;
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* block) noexcept { free(block); }
+void operator delete[](void* block) noexcept { free(block); }
+void operator delete(void* block, size_t) noexcept { free(block); }
+void operator delete[](void* block, size_t) noexcept { free(block); }
+
+static const int INPUT_SIZE = 4096;     // Power of two
+static const int CROSSING_EVERY = 400;
+static const int CROSSING_READINGS = 8;
+static int16_t input[INPUT_SIZE];
+
+// Keeps the compiler from dropping the work
+static volatile long sink;
+
+struct BenchResult {
+    char name[48];
+    double nsPerOp;
+    double allocsPerOp;
+};
+
+static std::vector<BenchResult> results;
+static long iterations = 2000000;
+static const char* filter = NULL;
+
+template <typename Step>
+static void run(const char* name, Step step) {
+    if (filter != NULL && strstr(name, filter) == NULL)
+        return;
+
+    // Warm up caches and branch predictors, and fill windows
+    long total = 0;
+    for (long i = 0; i < iterations / 10; i++)
+        total += step(i);
+
+    const unsigned long allocationsBefore = allocations;
+    const auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i++)
+        total += step(i);
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    sink = total;
+
+    BenchResult result;
+    snprintf(result.name, sizeof(result.name), "%s", name);
+    result.nsPerOp = elapsed.count() / iterations;
+    result.allocsPerOp = (double) (allocations - allocationsBefore) / iterations;
+    results.push_back(result);
+}
+
+static int16_t reading(long i) {
+    return input[i & (INPUT_SIZE - 1)];
+}
+
+/// @brief Discards events, e.g. the SSE stream
+class NullSink : public EventSink {
+    public:
+        void send(const char* message, const char* event, uint32_t id) override { sink = sink + message[0]; }
+};
+
+/// @brief A client that reads everything right away
+class NullConnection : public EventConnection {
+    public:
+        bool connected() override { return true; }
+        size_t space() override { return 2920; }
+        void write(const char* data, size_t length) override { sink = sink + data[length - 1]; }
+        void close() override {}
+};
+
+/// @brief Counts the bytes of a rendered response
+struct NullOutput {
+    size_t length = 0;
+    size_t write(const uint8_t* data, size_t size) {
+        length += size;
+        return size;
+    }
+};
+
+static void benchEstimators(size_t size) {
+    char name[48];
+
+    RollingWindow<int, MAX_WINDOW_SIZE> window(size);
+    snprintf(name, sizeof(name), "rolling_window/%zu", size);
+    run(name, [&](long i) {
+        window.append(reading(i));
+        return window.average();
+    });
+
+    RollingMedian<int16_t, MAX_WINDOW_SIZE> median(size);
+    snprintf(name, sizeof(name), "rolling_median/%zu", size);
+    run(name, [&](long i) {
+        median.append(reading(i));
+        return median.median();
+    });
+
+    HampelFilter<int16_t, MAX_WINDOW_SIZE> hampel(size);
+    RollingWindow<int, MAX_WINDOW_SIZE> filtered(size);
+    snprintf(name, sizeof(name), "hampel/%zu", size);
+    run(name, [&](long i) {
+        filtered.append(hampel.filter(reading(i)));
+        return filtered.average();
+    });
+}
+
+static void benchDetector(const char* name, int detectionMethod, int baselineEstimator) {
+    Parameters params;
+    params.detectionMethod = detectionMethod;
+    params.baselineEstimator = baselineEstimator;
+    Detector detector(params);
+    uint32_t micros = 0;
+    run(name, [&](long i) {
+        micros += 30000;
+        return (long) detector.update(reading(i), micros).event;
+    });
+}
+
+/// @brief The same with window sizes and method fixed at compile time, at the default sizes
+template <class FixedDetector>
+static void benchFixedDetector(const char* name, int detectionMethod) {
+    Parameters params;
+    params.detectionMethod = detectionMethod;
+    FixedDetector detector(params);
+    uint32_t micros = 0;
+    run(name, [&](long i) {
+        micros += 30000;
+        return (long) detector.step({ reading(i), micros });
+    });
+}
+
+/// @brief What pollRanging() does per reading apart from the lap timer
+static void benchLoopStep() {
+    static FlightRecorder flightRecorder;
+    Parameters params;
+    Detector detector(params);
+    NullSink events;
+    TelemetryStream telemetry(events);
+    uint32_t micros = 0;
+    run("loop_step", [&](long i) {
+        micros += 30000;
+        const int distance = reading(i);
+        const Detector::Result result = detector.update(distance, micros);
+        flightRecorder.add(micros, distance, traceState(0, result.event));
+        const bool decision = result.event == Detector::POTENTIAL_TRIGGER || result.event == Detector::FLUKE
+            || result.event == Detector::TRIGGER;
+        telemetry.add(micros / 1000, distance, result.average, result.event, decision);
+        LOG_DEBUG("gate: Reading: %d Average: %d", distance, result.average);
+        return (long) result.event;
+    });
+}
+
+static void benchConfig() {
+    Parameters params;
+    run("config_render", [&](long i) {
+        NullOutput output;
+        JsonWriter<NullOutput> json(output);
+        writeConfig(json, params);
+        return (long) output.length;
+    });
+
+    const char* body = "{\"windowSize\":30,\"detectionSize\":6,\"logLevel\":1}";
+    const size_t length = strlen(body);
+    run("config_apply", [&](long i) {
+        char error[64];
+        return (long) applyConfig(body, length, params, error, sizeof(error));
+    });
+}
+
+static void benchLog() {
+    static VirtualClock clock;
+    NullSink events;
+    logger.begin(clock);
+    logger.addSink(events);
+    logger.setLevel(INFO);
+    run("log_format", [&](long i) {
+        LOG_INFO("%s: Average detection distance: %d Current avg.: %d  Diff: %d%%", "gate", 120, reading(i), 60);
+        return (long) logger.flush();
+    });
+    run("log_disabled", [&](long i) {
+        LOG_DEBUG("gate: Reading: %d Average: %d", reading(i), 300);
+        return (long) logger.pending();
+    });
+}
+
+/// @brief Queueing an event for all clients, and writing it out
+static void benchBroadcast() {
+    static VirtualClock clock;
+    static EventBroadcaster broadcaster(clock);
+    static NullConnection connections[BROADCAST_MAX_CLIENTS];
+    for (NullConnection& connection : connections)
+        broadcaster.connect(connection, NULL);
+    run("broadcast_trigger", [&](long i) {
+        broadcaster.send("{\"run\":3,\"lapMillis\":41234}", "trigger", 0);
+        broadcaster.pump();
+        return (long) broadcaster.lastId();
+    });
+    run("broadcast_debug_log", [&](long i) {
+        broadcaster.sendLog("gate: Reading: 301 Average: 300", DEBUG, 0);
+        broadcaster.pump();
+        return (long) broadcaster.lastId();
+    });
+}
+
+static void printTable() {
+    printf("%-32s %10s %12s\n", "benchmark", "ns/op", "allocs/op");
+    for (const BenchResult& result : results)
+        printf("%-32s %10.1f %12.2f\n", result.name, result.nsPerOp, result.allocsPerOp);
+}
+
+static void printJson() {
+    printf("{\"iterations\":%ld,\"results\":[", iterations);
+    for (size_t i = 0; i < results.size(); i++) {
+        printf("%s\n{\"name\":\"%s\",\"nsPerOp\":%.2f,\"allocsPerOp\":%.4f}", i > 0 ? "," : "",
+               results[i].name, results[i].nsPerOp, results[i].allocsPerOp);
+    }
+    printf("\n]}\n");
+}
+
+int main(int argc, char** argv) {
+    bool json = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (strncmp(argv[i], "--iterations=", 13) == 0) {
+            iterations = atol(argv[i] + 13);
+        } else if (strncmp(argv[i], "--filter=", 9) == 0) {
+            filter = argv[i] + 9;
+        } else {
+            fprintf(stderr, "Usage: %s [--json] [--iterations=<n>] [--filter=<text>]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (iterations < 1)
+        iterations = 1;
+
+    srand(1);
+    for (int i = 0; i < INPUT_SIZE; i++) {
+        if (i % CROSSING_EVERY < CROSSING_READINGS)
+            input[i] = 120 + rand() % 11 - 5;
+        else
+            input[i] = rand() % 50 == 0 ? 0 : 300 + rand() % 7 - 3;
+    }
+
+    benchEstimators(Parameters().windowSize);
+    benchEstimators(MAX_WINDOW_SIZE);
+    run("percent_difference", [](long i) {
+        return (long) percentDifference(reading(i), 300);
+    });
+    benchDetector("detector_step/percent", DETECTION_PERCENT, BASELINE_MEAN);
+    benchDetector("detector_step/median", DETECTION_PERCENT, BASELINE_MEDIAN);
+    benchDetector("detector_step/hampel", DETECTION_PERCENT, BASELINE_HAMPEL);
+    benchDetector("detector_step/statistical", DETECTION_STATISTICAL, BASELINE_MEAN);
+    benchFixedDetector<LapDetector<MeanBaseline<20, 5>, PercentTrigger, MicrosClock>>("detector_step/fixed_percent", DETECTION_PERCENT);
+    benchFixedDetector<LapDetector<HampelBaseline<20, 5>, PercentTrigger, MicrosClock>>("detector_step/fixed_hampel", DETECTION_PERCENT);
+    benchFixedDetector<LapDetector<StatsBaseline<20, 5>, ZScoreTrigger, MicrosClock>>("detector_step/fixed_statistical", DETECTION_STATISTICAL);
+    benchLoopStep();
+    benchConfig();
+    benchLog();
+    benchBroadcast();
+
+    if (json)
+        printJson();
+    else
+        printTable();
+    return 0;
+}
@@ -0,0 +1,284 @@
+// Drives the web UI event broadcaster with simulated phones that read at different speeds.
+//
+//   pio run -e broadcast && .pio/build/broadcast/program [--seconds=<n>] [--no-debug]
+//
+// The board's event mix is generated on a virtual clock: a DEBUG log line per reading, telemetry
+// frames, runs and status every second, INFO logs, and a trigger and a split every 3 sec. Four
+// clients read it:
+//   fast      takes everything
+//   slow      reads 1.5 KB/s, less than is sent, so it has to lose DEBUG logs and telemetry
+//   stalled   stops reading from 20 to 50 sec, like a phone with the screen off
+//   flaky     drops off the Wi-Fi from 60 to 65 sec and reconnects with Last-Event-ID
+// A client closed by the broadcaster reconnects a second later like a browser does, once it reads again.
+//
+// Prints what every client got per class. Fails if a client missed a trigger or split that was
+// neither replayed from the journal nor followed by a "resync" event, or got one twice.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <set>
+#include <string>
+#include <vector>
+#include "EventBroadcaster.h"
+#include "EventConnection.h"
+#include "VirtualClock.h"
+
+static VirtualClock virtualClock;
+static EventBroadcaster broadcaster(virtualClock);
+static const uint32_t BOOT_ID = 48879;
+
+static const uint32_t TCP_WINDOW = 2920;        // Bytes in flight on the ESP8266, two segments
+static const uint32_t READING_INTERVAL = 33;    // msec, one DEBUG line per reading
+static const uint32_t TELEMETRY_INTERVAL = 250;
+static const uint32_t STATUS_INTERVAL = 1000;
+static const uint32_t INFO_INTERVAL = 2000;
+static const uint32_t TRIGGER_INTERVAL = 3000;
+
+/// @brief A phone on the soft-AP: reads at a fixed rate and parses the event stream
+class FakeClient : public EventConnection {
+    public:
+        const char* name;
+        uint32_t bytesPerSecond;
+        uint32_t stallFrom;         // msec, the client reads nothing in [stallFrom, stallTo)
+        uint32_t stallTo;
+        uint32_t dropFrom;          // msec, the client is off the network in [dropFrom, dropTo)
+        uint32_t dropTo;
+
+        bool open = false;
+        uint32_t reconnectAt = 0;   // msec, 0 for none
+        uint32_t closedAt = 0;      // msec, when the connection was last lost
+        std::string lastEventId;        // "<boot>-<sequence>" as sent, empty before the first event
+        uint64_t bytes = 0;
+        uint32_t received[PRIORITY_COUNT] = {};
+        uint32_t closedByServer = 0;
+        uint32_t resyncs = 0;
+        uint32_t lastResyncId = 0;  // Criticals up to this id are covered by a state reload
+        uint32_t duplicates = 0;
+        uint32_t outOfOrder = 0;
+        std::set<uint32_t> criticalIds;
+
+        FakeClient(const char* name, uint32_t bytesPerSecond, uint32_t stallFrom = 0, uint32_t stallTo = 0,
+                   uint32_t dropFrom = 0, uint32_t dropTo = 0) :
+            name(name), bytesPerSecond(bytesPerSecond), stallFrom(stallFrom), stallTo(stallTo),
+            dropFrom(dropFrom), dropTo(dropTo) {}
+
+        bool stalled(uint32_t millis) const { return millis >= stallFrom && millis < stallTo; }
+        bool offline(uint32_t millis) const { return millis >= dropFrom && millis < dropTo; }
+
+        /// @brief Since when the client has not been reading: stalled, off the network or waiting to
+        /// reconnect. millis itself if it reads.
+        uint32_t awaySince(uint32_t millis) const {
+            if (stalled(millis))
+                return stallFrom;
+            if (offline(millis))
+                return dropFrom;
+            if (!open && reconnectAt != 0)
+                return closedAt;
+            return millis;
+        }
+
+        /// @brief One msec of reading
+        void tick(uint32_t millis) {
+            if (!stalled(millis))
+                creditMilliBytes += bytesPerSecond;
+            if (creditMilliBytes > TCP_WINDOW * 1000ULL)
+                creditMilliBytes = TCP_WINDOW * 1000ULL;
+        }
+
+        bool connected() override { return open; }
+        size_t space() override { return (size_t) (creditMilliBytes / 1000); }
+
+        void write(const char* data, size_t length) override {
+            creditMilliBytes -= length * 1000ULL;
+            bytes += length;
+            pending.append(data, length);
+            size_t end;
+            while ((end = pending.find("\n\n")) != std::string::npos) {
+                parse(pending.substr(0, end));
+                pending.erase(0, end + 2);
+            }
+        }
+
+        void close() override {
+            open = false;
+            closedByServer++;
+            pending.clear();
+            closedAt = virtualClock.millis();
+            reconnectAt = closedAt + 1000;
+        }
+
+        void connect() {
+            open = true;
+            reconnectAt = 0;
+            pending.clear();
+            broadcaster.connect(*this, lastEventId.c_str());
+        }
+
+    private:
+        uint64_t creditMilliBytes = 0;
+        std::string pending;
+
+        void parse(const std::string& message) {
+            std::string idText;
+            std::string event;
+            size_t start = 0;
+            while (start < message.size()) {
+                size_t end = message.find('\n', start);
+                if (end == std::string::npos)
+                    end = message.size();
+                const std::string line = message.substr(start, end - start);
+                if (line.compare(0, 4, "id: ") == 0)
+                    idText = line.substr(4);
+                else if (line.compare(0, 7, "event: ") == 0)
+                    event = line.substr(7);
+                start = end + 1;
+            }
+
+            // Sequence part, the boot is the same all along
+            uint32_t id = 0;
+            if (!idText.empty()) {
+                lastEventId = idText;
+                id = (uint32_t) strtoul(idText.c_str() + idText.find('-') + 1, NULL, 10);
+            }
+            if (event == "resync") {
+                resyncs++;
+                lastResyncId = id;
+                return;
+            }
+            const BroadcastPriority priority = event == "log" && message.find("DEBUG") != std::string::npos
+                ? PRIORITY_DEBUG : EventBroadcaster::priority(event.c_str());
+            received[priority]++;
+            if (priority == PRIORITY_CRITICAL) {
+                if (!criticalIds.empty() && id < *criticalIds.rbegin())
+                    outOfOrder++;
+                if (!criticalIds.insert(id).second)
+                    duplicates++;
+            }
+        }
+};
+
+struct Published {
+    uint32_t id;
+    uint32_t millis;
+};
+
+int main(int argc, char** argv) {
+    uint32_t seconds = 120;
+    bool debug = true;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--seconds=", 10) == 0) {
+            seconds = (uint32_t) atol(argv[i] + 10);
+        } else if (strcmp(argv[i], "--no-debug") == 0) {
+            debug = false;
+        } else {
+            fprintf(stderr, "Usage: %s [--seconds=<n>] [--no-debug]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<FakeClient*> clients = {
+        new FakeClient("fast", 50000),
+        new FakeClient("slow", 1500),
+        new FakeClient("stalled", 50000, 20000, 50000),
+        new FakeClient("flaky", 50000, 0, 0, 60000, 65000),
+    };
+    broadcaster.begin(BOOT_ID);
+    for (FakeClient* client : clients)
+        client->connect();
+
+    std::vector<Published> criticals;
+    uint32_t published[PRIORITY_COUNT] = {};
+    uint32_t run = 0;
+    char text[BROADCAST_MESSAGE_SIZE];
+    std::string frame(224, 'A');    // Size of a base64 telemetry frame
+
+    for (uint32_t millis = 0; millis < seconds * 1000; millis++) {
+        if (debug && millis % READING_INTERVAL == 0) {
+            snprintf(text, sizeof(text), "DEBUG gate: Reading: %u Average: 300", 290 + millis % 20);
+            broadcaster.sendLog(text, 0, millis);
+            published[PRIORITY_DEBUG]++;
+        }
+        if (millis % TELEMETRY_INTERVAL == 0) {
+            broadcaster.send(frame.c_str(), "telemetry", millis);
+            published[PRIORITY_TELEMETRY]++;
+        }
+        if (millis % INFO_INTERVAL == 0) {
+            snprintf(text, sizeof(text), "gate: Average detection distance: 120 Current avg.: %u", millis / 1000);
+            broadcaster.sendLog(text, 1, millis);
+            published[PRIORITY_LOG]++;
+        }
+        if (millis % STATUS_INTERVAL == 0) {
+            snprintf(text, sizeof(text), "[{\"run\":%u,\"elapsedMillis\":%u}]", run, millis % TRIGGER_INTERVAL);
+            broadcaster.send(text, "runs", millis);
+            snprintf(text, sizeof(text), "Running | every 30 msec | jitter avg. 120 usec, max 900 usec, 0 skipped | 0 timeouts | uptime %u", millis / 1000);
+            broadcaster.send(text, "status", millis);
+            published[PRIORITY_STATE] += 2;
+        }
+        if (millis % TRIGGER_INTERVAL == 0 && millis > 0) {
+            snprintf(text, sizeof(text), "{\"run\":%u,\"lapMillis\":%u}", ++run, 40000 + millis % 997);
+            broadcaster.send(text, "trigger", millis);
+            criticals.push_back({ broadcaster.lastId(), millis });
+            published[PRIORITY_CRITICAL]++;
+        }
+        if (millis % TRIGGER_INTERVAL == TRIGGER_INTERVAL / 2) {
+            snprintf(text, sizeof(text), "{\"run\":%u,\"split\":0,\"millis\":%u}", run, 12000 + millis % 991);
+            broadcaster.send(text, "split", millis);
+            criticals.push_back({ broadcaster.lastId(), millis });
+            published[PRIORITY_CRITICAL]++;
+        }
+
+        for (FakeClient* client : clients) {
+            if (client->open && client->offline(millis)) {
+                // The browser notices the connection is gone, the board only once writes fail
+                client->open = false;
+                client->closedAt = millis;
+                client->reconnectAt = client->dropTo;
+            }
+            if (!client->open && client->reconnectAt != 0 && millis >= client->reconnectAt
+                && !client->stalled(millis) && !client->offline(millis))
+                client->connect();
+            client->tick(millis);
+        }
+        broadcaster.pump();
+        virtualClock.advanceMicros(1000);
+    }
+
+    printf("%-8s %8s %7s %9s %5s %5s %8s %6s %6s %6s\n", "client", "KB/s", "debug", "telemetry", "log",
+           "state", "critical", "closed", "resync", "missed");
+    printf("%-8s %8s %7u %9u %5u %5u %8u\n", "sent", "", published[PRIORITY_DEBUG],
+           published[PRIORITY_TELEMETRY], published[PRIORITY_LOG], published[PRIORITY_STATE], published[PRIORITY_CRITICAL]);
+
+    bool ok = true;
+    const uint32_t end = seconds * 1000;
+    for (FakeClient* client : clients) {
+        // Every trigger and split must have arrived, unless a resync told the page to reload the state
+        uint32_t missed = 0;
+        for (const Published& critical : criticals) {
+            // Still queued when the simulation ended, or waiting for a client that was away at the end
+            if (critical.millis + 2000 > client->awaySince(end - 1))
+                continue;
+            if (client->criticalIds.count(critical.id) == 0 && critical.id > client->lastResyncId)
+                missed++;
+        }
+        printf("%-8s %8.1f %7u %9u %5u %5u %8u %6u %6u %6u\n", client->name, client->bytes / 1000.0 / seconds,
+               client->received[PRIORITY_DEBUG], client->received[PRIORITY_TELEMETRY], client->received[PRIORITY_LOG],
+               client->received[PRIORITY_STATE], client->received[PRIORITY_CRITICAL], client->closedByServer,
+               client->resyncs, missed);
+        if (missed > 0 || client->duplicates > 0 || client->outOfOrder > 0) {
+            fprintf(stderr, "%s: %u missed, %u duplicate, %u out of order triggers or splits\n", client->name,
+                    missed, client->duplicates, client->outOfOrder);
+            ok = false;
+        }
+    }
+
+    printf("\ndropped:");
+    for (int i = 0; i < PRIORITY_COUNT; i++)
+        printf(" %s %u", BROADCAST_PRIORITY_NAMES[i], broadcaster.dropped((BroadcastPriority) i));
+    printf(", coalesced %u, slow clients closed %u, longest send %u usec\n", broadcaster.coalesced(),
+           broadcaster.slowClientsClosed(), broadcaster.sendLatency().maxMicros());
+
+    for (FakeClient* client : clients)
+        delete client;
+    return ok ? 0 : 1;
+}
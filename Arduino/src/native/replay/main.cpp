@@ -0,0 +1,161 @@
+// Replays a recorded sensor trace through the lap detector at full CPU speed.
+//
+//   pio run -e replay && .pio/build/replay/program <trace.bin> [truth.txt] [--quiet] [--compare] [--gate=<index>] [--<parameter>=<value> ...]
+//
+// Parameters: every setting of the config API in kebab case, e.g. --window-size, --detection-size,
+//             --baseline-estimator (0 mean, 1 median, 2 Hampel), --detection-method (0 percent, 1 statistical),
+//             --percent-diff-trigger, --z-score-trigger, --after-detection-delay, --min-lap-time, --max-lap-time
+// --gate picks the gate to replay from a flight recorder dump (GET /flight), default 0.
+// --compare replays the trace with both detection methods and prints the results side by side.
+// Ground truth: one lap per line, "<start msec> <end msec>" since trace start.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "Parameters.h"
+#include "Replay.h"
+#include "Trace.h"
+
+static bool readFile(const char* path, std::vector<uint8_t>& out) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL)
+        return false;
+
+    uint8_t buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        out.insert(out.end(), buffer, buffer + read);
+
+    fclose(file);
+    return true;
+}
+
+static bool parseParameter(const char* arg, Parameters& params) {
+    const char* value;
+    const ParameterField* field = parseParameterFlag(arg, &value);
+    return field != NULL && params.set(*field, atol(value));
+}
+
+static void printLap(const ReplayLap& lap, void* context) {
+    const uint32_t number = ++*(uint32_t*) context;
+    printf("lap %4u  run %4u  start %10.3f s  end %10.3f s  time %8.3f s", number, lap.runId,
+           lap.startMillis / 1000.0, lap.endMillis / 1000.0, lap.lapMicros / 1e6);
+    if (lap.matched)
+        printf("  error %+8.1f msec\n", lap.errorMicros / 1000.0);
+    else
+        printf("  (no ground truth)\n");
+}
+
+static void printComparison(const ReplayReport& percent, const ReplayReport& statistical, bool withTruth) {
+    printf("                    %12s %12s\n", "percent", "statistical");
+    printf("Triggers:           %12u %12u\n", percent.triggers, statistical.triggers);
+    printf("Flukes:             %12u %12u\n", percent.flukes, statistical.flukes);
+    printf("Detected laps:      %12u %12u\n", percent.detected, statistical.detected);
+    if (!withTruth)
+        return;
+    printf("Matched laps:       %12u %12u\n", percent.matched, statistical.matched);
+    printf("Missed laps:        %12u %12u\n", percent.missed, statistical.missed);
+    printf("False laps:         %12u %12u\n", percent.falseLaps, statistical.falseLaps);
+    printf("Mean abs. error:    %9.1f ms %9.1f ms\n", percent.meanAbsErrorMillis(), statistical.meanAbsErrorMillis());
+    printf("Worst abs. error:   %9.1f ms %9.1f ms\n", percent.maxAbsErrorMillis(), statistical.maxAbsErrorMillis());
+}
+
+int main(int argc, char** argv) {
+    const char* tracePath = NULL;
+    const char* truthPath = NULL;
+    bool quiet = false;
+    bool compare = false;
+    int gate = 0;
+    Parameters params;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quiet") == 0) {
+            quiet = true;
+        } else if (strcmp(argv[i], "--compare") == 0) {
+            compare = true;
+        } else if (strncmp(argv[i], "--gate=", 7) == 0) {
+            gate = atoi(argv[i] + 7);
+        } else if (strncmp(argv[i], "--", 2) == 0) {
+            if (!parseParameter(argv[i], params)) {
+                fprintf(stderr, "Invalid parameter: %s\n", argv[i]);
+                return 2;
+            }
+        } else if (tracePath == NULL) {
+            tracePath = argv[i];
+        } else {
+            truthPath = argv[i];
+        }
+    }
+
+    if (tracePath == NULL) {
+        fprintf(stderr, "Usage: %s <trace.bin> [truth.txt] [--quiet] [--compare] [--gate=<index>] [--<parameter>=<value> ...]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<uint8_t> data;
+    if (!readFile(tracePath, data)) {
+        fprintf(stderr, "Cannot read %s\n", tracePath);
+        return 1;
+    }
+
+    TraceReader trace(data.data(), data.size());
+    if (!trace.valid()) {
+        fprintf(stderr, "%s is not a trace\n", tracePath);
+        return 1;
+    }
+    trace.selectGate(gate);
+
+    std::vector<GroundTruthLap> truth;
+    if (truthPath != NULL) {
+        std::vector<uint8_t> text;
+        if (!readFile(truthPath, text)) {
+            fprintf(stderr, "Cannot read %s\n", truthPath);
+            return 1;
+        }
+        text.push_back('\0');
+
+        // Every lap needs at least four characters, "0 1\n"
+        truth.resize(text.size() / 4 + 1);
+        truth.resize(parseGroundTruth((const char*) text.data(), truth.data(), truth.size()));
+    }
+
+    if (compare) {
+        Parameters percentParams = params;
+        percentParams.detectionMethod = DETECTION_PERCENT;
+        Parameters statisticalParams = params;
+        statisticalParams.detectionMethod = DETECTION_STATISTICAL;
+        TraceReader statisticalTrace(data.data(), data.size());
+        statisticalTrace.selectGate(gate);
+        const ReplayReport percent = replayTrace(trace, percentParams, truth.data(), truth.size());
+        const ReplayReport statistical = replayTrace(statisticalTrace, statisticalParams, truth.data(), truth.size());
+        printComparison(percent, statistical, truthPath != NULL);
+        return 0;
+    }
+
+    uint32_t lapNumber = 0;
+    const auto wallStart = std::chrono::steady_clock::now();
+    const ReplayReport report = replayTrace(trace, params, truth.data(), truth.size(),
+                                            quiet ? NULL : printLap, &lapNumber);
+    const std::chrono::duration<double> wallSeconds = std::chrono::steady_clock::now() - wallStart;
+
+    const double traceSeconds = report.traceMicros / 1e6;
+    printf("Samples:            %u (%.1f min of trace)\n", report.samples, traceSeconds / 60);
+    printf("Triggers:           %u (%u flukes)\n", report.triggers, report.flukes);
+    printf("Detected laps:      %u (%u runs abandoned)\n", report.detected, report.abandoned);
+    if (trace.flags() & TRACE_FLAG_STATE)
+        printf("Recorded triggers:  %u (on the board)\n", report.recordedTriggers);
+    if (truthPath != NULL) {
+        printf("Annotated laps:     %zu\n", truth.size());
+        printf("Matched laps:       %u\n", report.matched);
+        printf("Missed laps:        %u\n", report.missed);
+        printf("False laps:         %u\n", report.falseLaps);
+        printf("Mean abs. error:    %.1f msec\n", report.meanAbsErrorMillis());
+        printf("Worst abs. error:   %.1f msec\n", report.maxAbsErrorMillis());
+    }
+    printf("Wall time:          %.3f sec (%.0fx real time)\n", wallSeconds.count(),
+           wallSeconds.count() > 0 ? traceSeconds / wallSeconds.count() : 0);
+
+    return 0;
+}
@@ -0,0 +1,207 @@
+// Host simulator: runs the lap detector against a synthetic course on a virtual clock.
+//
+//   pio run -e native && .pio/build/native/program [laps] [seed] [trace-prefix] [--riders=N]
+//       [--pass=MSEC] [--noise=CM] [--dropout=PERMILLE] [--delay=MSEC] [--burst-hold=MSEC] [--detection-method=0|1]
+//
+// Ranging is driven by the same Scheduler as on the board, including burst mode and the holdoff after
+// each crossing. With --riders, N bikes are on the course at once and the lap timer has to keep them apart.
+// --pass sets how long a bike is in the beam, --noise and --dropout how bad the sensor is, --delay and --burst-hold the idle interval and burst mode
+// (0 turns it off), to see how fast a bike can be before laps get missed. --detection-method=1 runs the
+// statistical detector.
+// With a trace prefix, the sensor readings are also recorded to <prefix>.bin and the true laps to
+// <prefix>.truth, ready for the replay tool.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "Detector.h"
+#include "FileStorage.h"
+#include "Gate.h"
+#include "LapTimer.h"
+#include "Parameters.h"
+#include "Scheduler.h"
+#include "SimulatedCourse.h"
+#include "Trace.h"
+#include "VirtualClock.h"
+
+// Scheduler tasks are plain functions, so the simulation state lives at file scope
+static VirtualClock virtualClock;
+static Parameters params;
+static LapTimer timer(params);
+static SimulatedCourse* course;
+static GateRanging* gateRanging;
+static Scheduler* scheduler;
+static int rangingTask;
+static TraceRecorder* recorder;
+static const uint32_t TRACE_FLUSH_INTERVAL = 100;  // msec, as on the board
+static FILE* truthFile = NULL;
+
+static uint32_t recordedLaps = 0;
+static uint32_t detected = 0;
+static uint32_t matched = 0;
+static uint32_t lastMatchedCourseLap = 0;
+static long long errorSum = 0;     // usec
+static long long absErrorSum = 0;  // usec
+static long errorMax = 0;          // usec
+
+static void flushTrace() {
+    recorder->flushFull();
+}
+
+static void ranging() {
+    // The course measures right away, so the result is there unless the gate is in holdoff.
+    // Readings are stamped with the time of the ping, like on the board.
+    int index;
+    long reading;
+    uint32_t pingMicros;
+    const bool pinged = gateRanging->ping();
+    scheduler->setPeriod(rangingTask, gateRanging->slotMicros());
+    if (!pinged || !gateRanging->poll(index, reading, pingMicros))
+        return;
+    // The echo takes a while to come back, ~58 usec per cm
+    virtualClock.advanceMicros(reading * 58);
+
+    recorder->add(pingMicros, reading);
+    if (truthFile != NULL && course->finishedLaps() != recordedLaps) {
+        recordedLaps = course->finishedLaps();
+        fprintf(truthFile, "%u %u\n", course->lastLapStartMillis(), course->lastLapStartMillis() + course->lastLapMillis());
+    }
+
+    Gate& gate = gateRanging->gate(index);
+    const Detector::Result result = gate.detector.update(reading, pingMicros);
+    if (gate.detector.deviating(result) && gateRanging->burst()) {
+        scheduler->setPeriod(rangingTask, gateRanging->slotMicros());
+        scheduler->reschedule(rangingTask, pingMicros + gateRanging->slotMicros());
+    }
+    if (result.event != Detector::TRIGGER)
+        return;
+
+    gateRanging->startHoldoff(index);
+
+    const LapTimer::Result crossing = timer.crossing(result.crossingMicros, result.confidence, gate.role);
+    if (crossing.event != LapTimer::FINISHED)
+        return;
+    detected++;
+
+    // Only compare against a lap the course actually finished since the last match
+    if (course->finishedLaps() != lastMatchedCourseLap) {
+        lastMatchedCourseLap = course->finishedLaps();
+        const long error = (long) crossing.lapMicros - (long) course->lastLapMillis() * 1000;
+        errorSum += error;
+        absErrorSum += labs(error);
+        if (labs(error) > labs(errorMax))
+            errorMax = error;
+        matched++;
+    }
+}
+
+int main(int argc, char** argv) {
+    // Positional arguments, with the flags taken out
+    const char* positional[3] = {NULL, NULL, NULL};
+    int positionalCount = 0;
+    int riders = 1;
+    long passMillis = 0;
+    long noiseCm = -1;
+    long dropoutPermille = -1;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--riders=", 9) == 0)
+            riders = atoi(argv[i] + 9);
+        else if (strncmp(argv[i], "--pass=", 7) == 0)
+            passMillis = atol(argv[i] + 7);
+        else if (strncmp(argv[i], "--noise=", 8) == 0)
+            noiseCm = atol(argv[i] + 8);
+        else if (strncmp(argv[i], "--dropout=", 10) == 0)
+            dropoutPermille = atol(argv[i] + 10);
+        else if (strncmp(argv[i], "--delay=", 8) == 0)
+            params.set("delay", atol(argv[i] + 8));
+        else if (strncmp(argv[i], "--burst-hold=", 13) == 0)
+            params.set("burstHold", atol(argv[i] + 13));
+        else if (strncmp(argv[i], "--detection-method=", 19) == 0)
+            params.set("detectionMethod", atol(argv[i] + 19));
+        else if (positionalCount < 3)
+            positional[positionalCount++] = argv[i];
+    }
+
+    const uint32_t laps = positional[0] != NULL ? (uint32_t) atol(positional[0]) : 1000;
+
+    SimulatedCourse::Config config;
+    config.seed = positional[1] != NULL ? (uint32_t) atol(positional[1]) : 1;
+    config.riders = riders;
+    if (passMillis > 0)
+        config.passMillis = (uint32_t) passMillis;
+    if (noiseCm >= 0)
+        config.noiseCm = (int) noiseCm;
+    if (dropoutPermille >= 0)
+        config.dropoutPermille = (int) dropoutPermille;
+    if (riders > 1) {
+        // Everybody has to be on the course before the first finish, and the timer has to be able to
+        // tell the last start from the first finish
+        const uint32_t minLapMillis = (riders + 1) * config.startGapMillis;
+        if (config.minLapMillis < minLapMillis) {
+            config.maxLapMillis += minLapMillis - config.minLapMillis;
+            config.minLapMillis = minLapMillis;
+        }
+        params.set("minLapTime", config.minLapMillis - config.startGapMillis / 2);
+    }
+    SimulatedCourse simulatedCourse(virtualClock, config);
+    course = &simulatedCourse;
+    Gate gates[] = { Gate("gate", LapTimer::START_FINISH, simulatedCourse, params) };
+    GateRanging roundRobin(virtualClock, params, gates, 1);
+    gateRanging = &roundRobin;
+
+    const char* tracePrefix = positional[2];
+    char tracePath[256] = "";
+    FileStorage storage("");
+    TraceRecorder traceRecorder(storage, tracePath);
+    recorder = &traceRecorder;
+    if (tracePrefix != NULL) {
+        snprintf(tracePath, sizeof(tracePath), "%s.bin", tracePrefix);
+        char truthPath[256];
+        snprintf(truthPath, sizeof(truthPath), "%s.truth", tracePrefix);
+        truthFile = fopen(truthPath, "w");
+        if (truthFile == NULL || !traceRecorder.start(virtualClock.micros())) {
+            fprintf(stderr, "Cannot write trace %s\n", tracePrefix);
+            return 1;
+        }
+    }
+
+    Scheduler taskScheduler(virtualClock);
+    scheduler = &taskScheduler;
+    rangingTask = taskScheduler.add("ranging", ranging, roundRobin.slotMicros());
+    taskScheduler.add("traceflush", flushTrace, TRACE_FLUSH_INTERVAL * 1000UL);
+
+    const auto wallStart = std::chrono::steady_clock::now();
+
+    // Keep ranging a bit after the last finish crossing so the detector can confirm it
+    uint32_t stopMillis = 0;
+    while (stopMillis == 0 || virtualClock.millis() < stopMillis) {
+        if (stopMillis == 0 && course->finishedLaps() >= laps)
+            stopMillis = virtualClock.millis() + 5000;
+
+        taskScheduler.run();
+        virtualClock.advanceMicros(taskScheduler.microsUntilNext());
+    }
+
+    traceRecorder.stop();
+    if (truthFile != NULL)
+        fclose(truthFile);
+
+    const std::chrono::duration<double> wallSeconds = std::chrono::steady_clock::now() - wallStart;
+    const JitterStats& stats = taskScheduler.stats(rangingTask);
+
+    printf("Simulated laps:     %u (%.1f h course time, %d riders at once)\n", laps, virtualClock.micros64() / 3.6e9, config.riders);
+    printf("Detected laps:      %u (%u runs abandoned)\n", detected, timer.abandonedRuns());
+    printf("Matched laps:       %u\n", matched);
+    printf("Missed laps:        %u\n", laps > matched ? laps - matched : 0);
+    if (matched > 0) {
+        printf("Mean error:         %+.2f msec\n", (double) errorSum / matched / 1000);
+        printf("Mean abs. error:    %.2f msec\n", (double) absErrorSum / matched / 1000);
+        printf("Worst error:        %+.2f msec\n", errorMax / 1000.0);
+    }
+    printf("Ranging ticks:      %u (late avg. %u usec, max %u usec, %u skipped)\n",
+           stats.runs, stats.meanLateMicros(), stats.maxLateMicros, stats.skipped);
+    printf("Wall time:          %.3f sec\n", wallSeconds.count());
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+#ifndef WorkStealingPool_H
+#define WorkStealingPool_H
+
+#include <stddef.h>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// @brief Runs a batch of independent jobs on all cores.
+///
+/// Every worker starts with an even share of the job indices and takes from the back of its own
+/// queue. A worker that runs dry steals from the front of the others, so a few slow jobs, e.g.
+/// configurations with large windows, do not leave the other cores idle at the end of the batch.
+class WorkStealingPool {
+    public:
+        /// @param threads 0 for one per hardware thread
+        explicit WorkStealingPool(unsigned threads = 0) : threadCount(threads) {
+            if (threadCount == 0)
+                threadCount = std::thread::hardware_concurrency();
+            if (threadCount == 0)
+                threadCount = 1;
+        }
+
+        unsigned threads() const { return threadCount; }
+
+        /// @brief Call job(index, worker) for every index in [0, count). Returns once all jobs are done.
+        /// Jobs run concurrently, so they must only share read-only state or guard it themselves.
+        template <typename Job>
+        void run(size_t count, Job job) {
+            std::vector<Queue> queues(threadCount);
+            for (unsigned worker = 0; worker < threadCount; worker++) {
+                const size_t first = count * worker / threadCount;
+                const size_t last = count * (worker + 1) / threadCount;
+                for (size_t index = first; index < last; index++)
+                    queues[worker].jobs.push_back(index);
+            }
+
+            std::vector<std::thread> workers;
+            for (unsigned worker = 0; worker < threadCount; worker++) {
+                workers.emplace_back([&queues, &job, worker, this]() {
+                    size_t index;
+                    while (take(queues, worker, index))
+                        job(index, worker);
+                });
+            }
+            for (std::thread& worker : workers)
+                worker.join();
+        }
+
+    private:
+        struct Queue {
+            std::mutex lock;
+            std::deque<size_t> jobs;
+        };
+
+        unsigned threadCount;
+
+        // No job adds jobs, so once every queue was found empty the batch is done
+        bool take(std::vector<Queue>& queues, unsigned worker, size_t& index) {
+            {
+                Queue& own = queues[worker];
+                std::lock_guard<std::mutex> guard(own.lock);
+                if (!own.jobs.empty()) {
+                    index = own.jobs.back();
+                    own.jobs.pop_back();
+                    return true;
+                }
+            }
+            for (unsigned offset = 1; offset < threadCount; offset++) {
+                Queue& victim = queues[(worker + offset) % threadCount];
+                std::lock_guard<std::mutex> guard(victim.lock);
+                if (!victim.jobs.empty()) {
+                    index = victim.jobs.front();
+                    victim.jobs.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+};
+
+#endif
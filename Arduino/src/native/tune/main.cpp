@@ -0,0 +1,300 @@
+// Searches detector settings that time a set of labelled sensor traces best.
+//
+//   pio run -e tune && .pio/build/tune/program [options] <trace.bin> ...
+//
+// Every trace needs its ground truth next to it, <trace>.truth for <trace>.bin, as written by the
+// simulator. Settings to search are given like replay parameters, either as a list or as
+// from:to:step, e.g. --window-size=10,20,30 --percent-diff-trigger=10:50:5. A single value fixes a
+// setting. Without any, windowSize, detectionSize and percentDiffTrigger are searched.
+//
+// --delay= is emulated by dropping readings, so it only works for delays above the one the trace was
+// recorded with, and burst mode is not modelled.
+//
+// Options: --random=<n> evaluates n distinct random points of the grid instead of all of it (--seed=<n>),
+//          --threads=<n> (default all cores), --top=<n> configurations to print (default 10).
+//
+// Prints the configurations ranked by missed plus false laps, then by mean timing error, as JSON.
+// The "config" object of a result is a body for POST /api/v1/config.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "Parameters.h"
+#include "Replay.h"
+#include "Trace.h"
+#include "WorkStealingPool.h"
+
+struct LabelledTrace {
+    std::string path;
+    std::vector<TraceSample> samples;
+    std::vector<GroundTruthLap> truth;
+};
+
+/// @brief A setting and the values to try
+struct Dimension {
+    const ParameterField* field;
+    std::vector<int> values;
+};
+
+struct Evaluation {
+    std::vector<int> values;        // One per dimension
+    ReplayReport report;            // Summed over all traces
+};
+
+static bool readFile(const std::string& path, std::vector<uint8_t>& out) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == NULL)
+        return false;
+
+    uint8_t buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        out.insert(out.end(), buffer, buffer + read);
+
+    fclose(file);
+    return true;
+}
+
+/// @brief Decode a trace and its ground truth once, every configuration replays the samples
+static bool loadTrace(const char* path, LabelledTrace& trace) {
+    trace.path = path;
+    std::vector<uint8_t> data;
+    if (!readFile(path, data)) {
+        fprintf(stderr, "Cannot read %s\n", path);
+        return false;
+    }
+    TraceReader reader(data.data(), data.size());
+    if (!reader.valid()) {
+        fprintf(stderr, "%s is not a trace\n", path);
+        return false;
+    }
+    reader.selectGate(0);
+    TraceSample sample;
+    while (reader.next(sample))
+        trace.samples.push_back(sample);
+
+    std::string truthPath = trace.path;
+    const size_t extension = truthPath.rfind(".bin");
+    truthPath = (extension != std::string::npos ? truthPath.substr(0, extension) : truthPath) + ".truth";
+    std::vector<uint8_t> text;
+    if (!readFile(truthPath, text)) {
+        fprintf(stderr, "Cannot read the ground truth %s\n", truthPath.c_str());
+        return false;
+    }
+    text.push_back('\0');
+    trace.truth.resize(text.size() / 4 + 1);
+    trace.truth.resize(parseGroundTruth((const char*) text.data(), trace.truth.data(), trace.truth.size()));
+    return true;
+}
+
+/// @brief Parse "a,b,c" or "from:to:step" and check every value against the setting's bounds
+static bool parseValues(const ParameterField& field, const char* text, std::vector<int>& values) {
+    long from;
+    long to;
+    long step;
+    if (sscanf(text, "%ld:%ld:%ld", &from, &to, &step) == 3) {
+        if (step <= 0 || from > to)
+            return false;
+        for (long value = from; value <= to; value += step)
+            values.push_back((int) value);
+    } else {
+        for (const char* c = text; *c != '\0'; ) {
+            char* end;
+            values.push_back((int) strtol(c, &end, 10));
+            if (end == c || (*end != ',' && *end != '\0'))
+                return false;
+            c = *end == ',' ? end + 1 : end;
+        }
+    }
+
+    Parameters check;
+    for (int value : values) {
+        if (!check.set(field, value))
+            return false;
+    }
+    return !values.empty();
+}
+
+static void addDefault(std::vector<Dimension>& dimensions, const char* name, std::vector<int> values) {
+    for (const Dimension& dimension : dimensions) {
+        if (strcmp(dimension.field->name, name) == 0)
+            return;
+    }
+    dimensions.push_back({ findParameter(name), values });
+}
+
+static void accumulate(ReplayReport& total, const ReplayReport& report) {
+    total.samples += report.samples;
+    total.triggers += report.triggers;
+    total.flukes += report.flukes;
+    total.detected += report.detected;
+    total.abandoned += report.abandoned;
+    total.matched += report.matched;
+    total.missed += report.missed;
+    total.falseLaps += report.falseLaps;
+    total.absErrorSum += report.absErrorSum;
+    total.maxAbsError = std::max(total.maxAbsError, report.maxAbsError);
+}
+
+static ReplayReport evaluate(const Parameters& params, bool emulateDelay, const std::vector<LabelledTrace>& traces) {
+    ReplayReport total;
+    for (const LabelledTrace& trace : traces) {
+        Replayer replayer(params, trace.truth.data(), trace.truth.size());
+        // A longer ranging interval keeps the first reading that is at least about delay after the last one kept
+        const uint64_t minGapMicros = emulateDelay ? params.delay * 900ULL : 0;
+        uint64_t lastMicros = 0;
+        bool first = true;
+        for (const TraceSample& sample : trace.samples) {
+            if (!first && sample.micros - lastMicros < minGapMicros)
+                continue;
+            first = false;
+            lastMicros = sample.micros;
+            replayer.add(sample);
+        }
+        accumulate(total, replayer.finish());
+    }
+    return total;
+}
+
+static bool better(const Evaluation& lhs, const Evaluation& rhs) {
+    const uint32_t lhsErrors = lhs.report.missed + lhs.report.falseLaps;
+    const uint32_t rhsErrors = rhs.report.missed + rhs.report.falseLaps;
+    if (lhsErrors != rhsErrors)
+        return lhsErrors < rhsErrors;
+    if (lhs.report.meanAbsErrorMillis() != rhs.report.meanAbsErrorMillis())
+        return lhs.report.meanAbsErrorMillis() < rhs.report.meanAbsErrorMillis();
+    return lhs.report.flukes < rhs.report.flukes;
+}
+
+static void printResults(const std::vector<Dimension>& dimensions, const std::vector<Evaluation>& ranked,
+                         size_t top, size_t traceCount, size_t annotatedLaps, double wallSeconds) {
+    printf("{\"configurations\":%zu,\"traces\":%zu,\"annotatedLaps\":%zu,\"wallSeconds\":%.2f,\"results\":[",
+           ranked.size(), traceCount, annotatedLaps, wallSeconds);
+    for (size_t rank = 0; rank < ranked.size() && rank < top; rank++) {
+        const Evaluation& evaluation = ranked[rank];
+        const ReplayReport& report = evaluation.report;
+        printf("%s\n{\"rank\":%zu,\"missed\":%u,\"falseLaps\":%u,\"flukes\":%u,\"triggers\":%u,"
+               "\"meanAbsErrorMillis\":%.1f,\"maxAbsErrorMillis\":%.1f,\"config\":{",
+               rank > 0 ? "," : "", rank + 1, report.missed, report.falseLaps, report.flukes, report.triggers,
+               report.meanAbsErrorMillis(), report.maxAbsErrorMillis());
+        for (size_t i = 0; i < dimensions.size(); i++)
+            printf("%s\"%s\":%d", i > 0 ? "," : "", dimensions[i].field->name, evaluation.values[i]);
+        printf("}}");
+    }
+    printf("\n]}\n");
+}
+
+int main(int argc, char** argv) {
+    std::vector<Dimension> dimensions;
+    std::vector<LabelledTrace> traces;
+    long randomCount = 0;
+    unsigned seed = 1;
+    unsigned threads = 0;
+    size_t top = 10;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strncmp(arg, "--random=", 9) == 0) {
+            randomCount = atol(arg + 9);
+        } else if (strncmp(arg, "--seed=", 7) == 0) {
+            seed = (unsigned) atol(arg + 7);
+        } else if (strncmp(arg, "--threads=", 10) == 0) {
+            threads = (unsigned) atol(arg + 10);
+        } else if (strncmp(arg, "--top=", 6) == 0) {
+            top = (size_t) atol(arg + 6);
+        } else if (strncmp(arg, "--", 2) == 0) {
+            const char* text;
+            const ParameterField* field = parseParameterFlag(arg, &text);
+            Dimension dimension = { field, {} };
+            if (field == NULL || !parseValues(*field, text, dimension.values)) {
+                fprintf(stderr, "Invalid parameter: %s\n", arg);
+                return 2;
+            }
+            dimensions.push_back(dimension);
+        } else {
+            traces.emplace_back();
+            if (!loadTrace(arg, traces.back()))
+                return 1;
+        }
+    }
+
+    if (traces.empty()) {
+        fprintf(stderr, "Usage: %s [--<parameter>=<a,b,c|from:to:step> ...] [--random=<n>] [--seed=<n>] "
+                "[--threads=<n>] [--top=<n>] <trace.bin> ...\n", argv[0]);
+        return 2;
+    }
+
+    bool searching = false;
+    for (const Dimension& dimension : dimensions)
+        searching |= dimension.values.size() > 1;
+    if (!searching) {
+        addDefault(dimensions, "windowSize", { 10, 20, 30, 50 });
+        addDefault(dimensions, "detectionSize", { 3, 4, 5, 6, 8 });
+        addDefault(dimensions, "percentDiffTrigger", { 10, 15, 20, 25, 30, 35, 40, 45, 50 });
+    }
+    bool emulateDelay = false;
+    for (const Dimension& dimension : dimensions)
+        emulateDelay |= dimension.field->value == &Parameters::delay;
+
+    // Grid points as mixed radix numbers, one digit per dimension
+    size_t gridSize = 1;
+    for (const Dimension& dimension : dimensions)
+        gridSize *= dimension.values.size();
+    std::vector<size_t> points;
+    if (randomCount > 0 && (size_t) randomCount < gridSize) {
+        // Distinct points, so no configuration is evaluated twice
+        std::mt19937_64 random(seed);
+        std::uniform_int_distribution<size_t> pick(0, gridSize - 1);
+        std::unordered_set<size_t> chosen;
+        while (chosen.size() < (size_t) randomCount) {
+            const size_t point = pick(random);
+            if (chosen.insert(point).second)
+                points.push_back(point);
+        }
+    } else {
+        for (size_t point = 0; point < gridSize; point++)
+            points.push_back(point);
+    }
+
+    std::vector<Evaluation> evaluations(points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        size_t point = points[i];
+        for (const Dimension& dimension : dimensions) {
+            evaluations[i].values.push_back(dimension.values[point % dimension.values.size()]);
+            point /= dimension.values.size();
+        }
+    }
+
+    size_t annotatedLaps = 0;
+    for (const LabelledTrace& trace : traces)
+        annotatedLaps += trace.truth.size();
+
+    WorkStealingPool pool(threads);
+    fprintf(stderr, "Evaluating %zu configurations on %zu traces with %u threads\n",
+            evaluations.size(), traces.size(), pool.threads());
+    const auto wallStart = std::chrono::steady_clock::now();
+    pool.run(evaluations.size(), [&](size_t index, unsigned worker) {
+        Evaluation& evaluation = evaluations[index];
+        Parameters params;
+        for (size_t i = 0; i < dimensions.size(); i++)
+            params.set(*dimensions[i].field, evaluation.values[i]);
+        if (params.minLapTime >= params.maxLapTime) {
+            // Rejected by the config API, rank it last
+            evaluation.report.missed = (uint32_t) annotatedLaps;
+            evaluation.report.falseLaps = UINT32_MAX / 2;
+            return;
+        }
+        evaluation.report = evaluate(params, emulateDelay, traces);
+    });
+    const std::chrono::duration<double> wallSeconds = std::chrono::steady_clock::now() - wallStart;
+
+    std::stable_sort(evaluations.begin(), evaluations.end(), better);
+    printResults(dimensions, evaluations, top, traces.size(), annotatedLaps, wallSeconds.count());
+    return 0;
+}
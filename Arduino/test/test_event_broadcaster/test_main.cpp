@@ -0,0 +1,297 @@
+// EventBroadcaster delivery classes, journal replay and resync on reconnect.
+//
+//   pio test -e native -f test_event_broadcaster
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include "EventBroadcaster.h"
+#include "EventConnection.h"
+#include "Log.h"
+#include "VirtualClock.h"
+
+static const uint32_t BOOT_ID = 4660;
+
+struct Event {
+    std::string id;
+    std::string event;
+    std::string data;
+};
+
+/// @brief Connection that takes as much as it is told to and parses what it got
+class FakeConnection : public EventConnection {
+    public:
+        bool open = true;
+        size_t room = 100000;
+        int closes = 0;
+        std::vector<Event> events;
+
+        bool connected() override { return open; }
+        size_t space() override { return room; }
+
+        void write(const char* data, size_t length) override {
+            room -= length;
+            pending.append(data, length);
+            size_t end;
+            while ((end = pending.find("\n\n")) != std::string::npos) {
+                parse(pending.substr(0, end));
+                pending.erase(0, end + 2);
+            }
+        }
+
+        void close() override {
+            open = false;
+            closes++;
+        }
+
+        /// @brief Events of one name, in order
+        std::vector<std::string> data(const char* event) const {
+            std::vector<std::string> out;
+            for (const Event& received : events) {
+                if (received.event == event)
+                    out.push_back(received.data);
+            }
+            return out;
+        }
+
+    private:
+        std::string pending;
+
+        void parse(const std::string& message) {
+            Event parsed;
+            size_t start = 0;
+            while (start < message.size()) {
+                size_t end = message.find('\n', start);
+                if (end == std::string::npos)
+                    end = message.size();
+                const std::string line = message.substr(start, end - start);
+                if (line.compare(0, 4, "id: ") == 0)
+                    parsed.id = line.substr(4);
+                else if (line.compare(0, 7, "event: ") == 0)
+                    parsed.event = line.substr(7);
+                else if (line.compare(0, 6, "data: ") == 0)
+                    parsed.data = line.substr(6);
+                start = end + 1;
+            }
+            events.push_back(parsed);
+        }
+};
+
+static std::string eventId(uint32_t sequence) {
+    char text[24];
+    snprintf(text, sizeof(text), "%u-%u", (unsigned) BOOT_ID, (unsigned) sequence);
+    return text;
+}
+
+static void sendNumbered(EventBroadcaster& broadcaster, const char* event, int from, int to) {
+    char text[16];
+    for (int i = from; i <= to; i++) {
+        snprintf(text, sizeof(text), "%d", i);
+        broadcaster.send(text, event, 0);
+    }
+}
+
+static VirtualClock virtualClock;
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_ids_carry_the_boot(void) {
+    EventBroadcaster broadcaster(virtualClock);
+    broadcaster.begin(BOOT_ID);
+    FakeConnection phone;
+    TEST_ASSERT_TRUE(broadcaster.connect(phone, NULL));
+
+    broadcaster.send("{\"run\":1}", "trigger", 0);
+    broadcaster.sendLog("gate: Reading", INFO, 0);
+    broadcaster.pump();
+
+    TEST_ASSERT_EQUAL(2, phone.events.size());
+    TEST_ASSERT_EQUAL_STRING(eventId(1).c_str(), phone.events[0].id.c_str());
+    TEST_ASSERT_EQUAL_STRING("trigger", phone.events[0].event.c_str());
+    TEST_ASSERT_EQUAL_STRING("{\"run\":1}", phone.events[0].data.c_str());
+    TEST_ASSERT_EQUAL_STRING(eventId(2).c_str(), phone.events[1].id.c_str());
+    TEST_ASSERT_EQUAL_STRING("log", phone.events[1].event.c_str());
+    TEST_ASSERT_EQUAL_UINT32(2, broadcaster.lastId());
+}
+
+void test_full_queue_drops_lowest_class_first(void) {
+    EventBroadcaster broadcaster(virtualClock);
+    broadcaster.begin(BOOT_ID);
+    FakeConnection phone;
+    broadcaster.connect(phone, NULL);
+    phone.room = 0;
+
+    // Fills the queue: 4 of each droppable class
+    for (int i = 0; i < 4; i++) {
+        broadcaster.sendLog("DEBUG", DEBUG, 0);
+        broadcaster.send("frame", "telemetry", 0);
+        broadcaster.sendLog("INFO", INFO, 0);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, broadcaster.dropped(PRIORITY_DEBUG));
+
+    // Six triggers push out all DEBUG logs, then the oldest telemetry frames
+    sendNumbered(broadcaster, "trigger", 1, 6);
+    TEST_ASSERT_EQUAL_UINT32(4, broadcaster.dropped(PRIORITY_DEBUG));
+    TEST_ASSERT_EQUAL_UINT32(2, broadcaster.dropped(PRIORITY_TELEMETRY));
+    TEST_ASSERT_EQUAL_UINT32(0, broadcaster.dropped(PRIORITY_LOG));
+
+    // A lower class never pushes out a higher one
+    broadcaster.sendLog("DEBUG", DEBUG, 0);
+    TEST_ASSERT_EQUAL_UINT32(5, broadcaster.dropped(PRIORITY_DEBUG));
+
+    phone.room = 100000;
+    broadcaster.pump();
+    TEST_ASSERT_EQUAL(4, phone.data("log").size());
+    TEST_ASSERT_EQUAL(2, phone.data("telemetry").size());
+    const std::vector<std::string> triggers = phone.data("trigger");
+    TEST_ASSERT_EQUAL(6, triggers.size());
+    for (int i = 0; i < 6; i++)
+        TEST_ASSERT_EQUAL_INT(i + 1, atoi(triggers[i].c_str()));
+    TEST_ASSERT_EQUAL(0, phone.closes);
+}
+
+void test_newer_state_replaces_queued_one(void) {
+    EventBroadcaster broadcaster(virtualClock);
+    broadcaster.begin(BOOT_ID);
+    FakeConnection phone;
+    broadcaster.connect(phone, NULL);
+    phone.room = 0;
+
+    sendNumbered(broadcaster, "status", 1, 3);
+    broadcaster.send("[]", "runs", 0);
+    TEST_ASSERT_EQUAL_UINT32(2, broadcaster.coalesced());
+
+    phone.room = 100000;
+    broadcaster.pump();
+    TEST_ASSERT_EQUAL(2, phone.events.size());
+    TEST_ASSERT_EQUAL_STRING("3", phone.data("status")[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("runs", phone.events[1].event.c_str());
+}
+
+void test_client_behind_on_triggers_is_closed(void) {
+    EventBroadcaster broadcaster(virtualClock);
+    broadcaster.begin(BOOT_ID);
+    FakeConnection stalled;
+    FakeConnection fast;
+    broadcaster.connect(stalled, NULL);
+    broadcaster.connect(fast, NULL);
+    stalled.room = 0;
+
+    // Triggers are never dropped, so a full queue of them closes the client
+    for (int i = 1; i <= BROADCAST_QUEUE_LENGTH; i++) {
+        sendNumbered(broadcaster, "trigger", i, i);
+        broadcaster.pump();
+    }
+    TEST_ASSERT_EQUAL(0, stalled.closes);
+    broadcaster.send("13", "trigger", 0);
+    TEST_ASSERT_EQUAL(1, stalled.closes);
+    TEST_ASSERT_EQUAL_UINT32(1, broadcaster.slowClientsClosed());
+    TEST_ASSERT_EQUAL(1, broadcaster.clients());
+
+    // The client that keeps up loses nothing
+    broadcaster.pump();
+    TEST_ASSERT_EQUAL(BROADCAST_QUEUE_LENGTH + 1, fast.data("trigger").size());
+}
+
+void test_reconnect_replays_journal(void) {
+    EventBroadcaster broadcaster(virtualClock);
+    broadcaster.begin(BOOT_ID);
+    FakeConnection phone;
+    broadcaster.connect(phone, NULL);
+    sendNumbered(broadcaster, "trigger", 1, 2);
+    broadcaster.pump();
+    const std::string lastEventId = phone.events.back().id;
+    broadcaster.disconnect(phone);
+
+    // Missed while away: logs are gone, triggers, splits and the latest state are in the journal
+    broadcaster.sendLog("INFO", INFO, 0);
+    sendNumbered(broadcaster, "trigger", 3, 4);
+    broadcaster.send("1", "split", 0);
+    sendNumbered(broadcaster, "status", 1, 2);
+
+    FakeConnection again;
+    broadcaster.connect(again, lastEventId.c_str());
+    broadcaster.pump();
+    TEST_ASSERT_EQUAL(4, again.events.size());
+    TEST_ASSERT_EQUAL_STRING("3", again.events[0].data.c_str());
+    TEST_ASSERT_EQUAL_STRING("4", again.events[1].data.c_str());
+    TEST_ASSERT_EQUAL_STRING("split", again.events[2].event.c_str());
+    TEST_ASSERT_EQUAL_STRING("2", again.data("status")[0].c_str());
+    TEST_ASSERT_EQUAL(0, again.data("resync").size());
+}
+
+void test_gap_beyond_journal_gets_resync(void) {
+    EventBroadcaster broadcaster(virtualClock);
+    broadcaster.begin(BOOT_ID);
+    FakeConnection phone;
+    broadcaster.connect(phone, NULL);
+    broadcaster.send("1", "trigger", 0);
+    broadcaster.pump();
+    const std::string lastEventId = phone.events.back().id;
+    broadcaster.disconnect(phone);
+
+    // More triggers than the journal holds
+    sendNumbered(broadcaster, "trigger", 2, BROADCAST_JOURNAL_LENGTH + 2);
+
+    FakeConnection again;
+    broadcaster.connect(again, lastEventId.c_str());
+    broadcaster.pump();
+    TEST_ASSERT_EQUAL(1, again.events.size());
+    TEST_ASSERT_EQUAL_STRING("resync", again.events[0].event.c_str());
+    // Reconnecting with the resync id replays nothing more
+    TEST_ASSERT_EQUAL_STRING(eventId(broadcaster.lastId()).c_str(), again.events[0].id.c_str());
+}
+
+void test_other_boot_gets_resync(void) {
+    EventBroadcaster broadcaster(virtualClock);
+    broadcaster.begin(BOOT_ID);
+    sendNumbered(broadcaster, "trigger", 1, 3);
+
+    // Within this boot's sequence, but from an earlier boot, a later one, or no boot at all
+    const char* const stale[] = { "17-1", "4660-9", "1", "4660-", "4660-1x", "garbage" };
+    for (const char* id : stale) {
+        FakeConnection phone;
+        broadcaster.connect(phone, id);
+        broadcaster.pump();
+        TEST_ASSERT_EQUAL(1, phone.events.size());
+        TEST_ASSERT_EQUAL_STRING("resync", phone.events[0].event.c_str());
+        broadcaster.disconnect(phone);
+    }
+
+    // The same sequence number of this boot is replayed from
+    FakeConnection phone;
+    broadcaster.connect(phone, eventId(1).c_str());
+    broadcaster.pump();
+    TEST_ASSERT_EQUAL(2, phone.events.size());
+    TEST_ASSERT_EQUAL_STRING("trigger", phone.events[0].event.c_str());
+}
+
+void test_client_slots_are_limited(void) {
+    EventBroadcaster broadcaster(virtualClock);
+    FakeConnection phones[BROADCAST_MAX_CLIENTS + 1];
+    for (int i = 0; i < BROADCAST_MAX_CLIENTS; i++)
+        TEST_ASSERT_TRUE(broadcaster.connect(phones[i], ""));
+    TEST_ASSERT_FALSE(broadcaster.connect(phones[BROADCAST_MAX_CLIENTS], ""));
+
+    // A closed connection frees its slot on the next pump()
+    phones[0].open = false;
+    broadcaster.pump();
+    TEST_ASSERT_TRUE(broadcaster.connect(phones[BROADCAST_MAX_CLIENTS], ""));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_ids_carry_the_boot);
+    RUN_TEST(test_full_queue_drops_lowest_class_first);
+    RUN_TEST(test_newer_state_replaces_queued_one);
+    RUN_TEST(test_client_behind_on_triggers_is_closed);
+    RUN_TEST(test_reconnect_replays_journal);
+    RUN_TEST(test_gap_beyond_journal_gets_resync);
+    RUN_TEST(test_other_boot_gets_resync);
+    RUN_TEST(test_client_slots_are_limited);
+    return UNITY_END();
+}
@@ -0,0 +1,224 @@
+// LapDetector: the fixed-size policy combinations against the configured Detector, and crossings
+// of a clean synthetic pass.
+//
+//   pio test -e native -f test_lap_detector
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdint.h>
+#include "Detector.h"
+#include "LapDetector.h"
+#include "Parameters.h"
+#include "Ranger.h"
+
+static const uint32_t INTERVAL_MICROS = 30000;
+
+/// @brief Readings of a gate 300 cm from the wall with a bike passing every few seconds. Noise,
+/// slow drift, missed echoes and single wild readings, on the same xorshift32 as SimulatedCourse.
+class SyntheticGate {
+    public:
+        explicit SyntheticGate(uint32_t seed) : random(seed) {}
+
+        DetectorSample<uint32_t> next() {
+            timeMicros += INTERVAL_MICROS + nextRandom() % 2000;
+            if (passLeft == 0 && nextRandom() % 200 == 0)
+                passLeft = 5 + nextRandom() % 12;
+
+            int distance = 300 + (int) (timeMicros / 60000000 % 8) + (int) (nextRandom() % 5) - 2;
+            if (passLeft > 0) {
+                passLeft--;
+                distance = 90 + (int) (nextRandom() % 40);
+            }
+            const uint32_t glitch = nextRandom() % 100;
+            if (glitch == 0)
+                distance = RANGER_TIMEOUT;
+            else if (glitch == 1)
+                distance = 20 + (int) (nextRandom() % 400);
+            return { distance, timeMicros };
+        }
+
+    private:
+        uint32_t random;
+        uint32_t timeMicros = 0;
+        int passLeft = 0;
+
+        uint32_t nextRandom() {
+            random ^= random << 13;
+            random ^= random >> 17;
+            random ^= random << 5;
+            return random;
+        }
+};
+
+static bool sameResult(const DetectorTypes::Result& a, const DetectorTypes::Result& b) {
+    return a.event == b.event && a.reading == b.reading && a.average == b.average && a.percentDiff == b.percentDiff
+        && a.zScore == b.zScore && a.detectionAverage == b.detectionAverage && a.crossingMicros == b.crossingMicros
+        && a.confidence == b.confidence;
+}
+
+/// @brief Feed both detectors the same readings, restart and warm start both halfway through
+template <class Fixed>
+static void checkAgainstConfigured(const Parameters& params, uint32_t seed) {
+    Detector configured(params);
+    Fixed fixed(params);
+    SyntheticGate gate(seed);
+    const uint32_t readings = 100000;
+    uint32_t triggers = 0;
+    uint32_t flukes = 0;
+
+    for (uint32_t i = 0; i < readings; i++) {
+        if (i == readings / 2) {
+            Calibration calibration;
+            TEST_ASSERT_TRUE(configured.calibration(calibration));
+            configured.restart();
+            fixed.restart();
+            configured.warmStart(calibration);
+            fixed.warmStart(calibration);
+        }
+
+        const DetectorSample<uint32_t> sample = gate.next();
+        const Detector::Event event = configured.step(sample);
+        TEST_ASSERT_EQUAL_INT(event, fixed.step(sample));
+        if (!sameResult(configured.result(), fixed.result())) {
+            char message[64];
+            snprintf(message, sizeof(message), "results differ at reading %u", (unsigned) i);
+            TEST_FAIL_MESSAGE(message);
+        }
+        triggers += event == Detector::TRIGGER;
+        flukes += event == Detector::FLUKE;
+    }
+
+    // Otherwise the comparison proves little
+    TEST_ASSERT_GREATER_THAN(100, triggers);
+    TEST_ASSERT_GREATER_THAN(10, flukes);
+    TEST_ASSERT_EQUAL(configured.warmStarted(), fixed.warmStarted());
+}
+
+static Parameters percentParameters(int windowSize, int detectionSize, int estimator) {
+    Parameters params;
+    params.detectionMethod = DETECTION_PERCENT;
+    params.baselineEstimator = estimator;
+    params.windowSize = windowSize;
+    params.detectionSize = detectionSize;
+    params.percentDiffTrigger = 25;
+    return params;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_mean_baseline_matches_configured(void) {
+    checkAgainstConfigured<LapDetector<MeanBaseline<20, 5>, PercentTrigger, MicrosClock>>(
+        percentParameters(20, 5, BASELINE_MEAN), 1);
+    checkAgainstConfigured<LapDetector<MeanBaseline<7, 3>, PercentTrigger, MicrosClock>>(
+        percentParameters(7, 3, BASELINE_MEAN), 2);
+}
+
+void test_median_baseline_matches_configured(void) {
+    checkAgainstConfigured<LapDetector<MedianBaseline<30, 5>, PercentTrigger, MicrosClock>>(
+        percentParameters(30, 5, BASELINE_MEDIAN), 3);
+}
+
+void test_hampel_baseline_matches_configured(void) {
+    checkAgainstConfigured<LapDetector<HampelBaseline<25, 4>, PercentTrigger, MicrosClock>>(
+        percentParameters(25, 4, BASELINE_HAMPEL), 4);
+}
+
+void test_statistical_matches_configured(void) {
+    Parameters params = percentParameters(40, 5, BASELINE_MEAN);
+    params.detectionMethod = DETECTION_STATISTICAL;
+    params.zScoreTrigger = 4;
+    checkAgainstConfigured<LapDetector<StatsBaseline<40, 5>, ZScoreTrigger, MicrosClock>>(params, 5);
+}
+
+void test_millis_clock_reports_micros(void) {
+    const Parameters params = percentParameters(20, 5, BASELINE_MEAN);
+    LapDetector<MeanBaseline<20, 5>, PercentTrigger, MicrosClock> micros(params);
+    LapDetector<MeanBaseline<20, 5>, PercentTrigger, MillisClock> millis(params);
+    SyntheticGate gate(6);
+    uint32_t triggers = 0;
+    for (int i = 0; i < 20000; i++) {
+        DetectorSample<uint32_t> sample = gate.next();
+        // Whole msec, so both clocks see the same times
+        sample.time = sample.time / 1000 * 1000;
+        const Detector::Event event = micros.step(sample);
+        TEST_ASSERT_EQUAL_INT(event, millis.step({ sample.distance, sample.time / 1000 }));
+        TEST_ASSERT_EQUAL_UINT32(micros.result().crossingMicros, millis.result().crossingMicros);
+        triggers += event == Detector::TRIGGER;
+    }
+    TEST_ASSERT_GREATER_THAN(10, triggers);
+}
+
+// Calibrates at 300 cm, then a bike at 100 cm for a detection window from reading 100 on. Holding
+// off after the trigger is up to LapTimer, a longer pass would be detected again.
+static void checkCleanPass(const Parameters& params) {
+    Detector detector(params);
+    uint32_t triggers = 0;
+    uint32_t crossingMicros = 0;
+    for (uint32_t i = 0; i < 200; i++) {
+        const int distance = i >= 100 && i < 100 + (uint32_t) params.detectionSize ? 100 : 300;
+        if (detector.step({ distance, i * INTERVAL_MICROS }) == Detector::TRIGGER) {
+            triggers++;
+            crossingMicros = detector.result().crossingMicros;
+            TEST_ASSERT_GREATER_OR_EQUAL(500, detector.result().confidence);
+        }
+        TEST_ASSERT_TRUE(detector.result().event != Detector::FLUKE);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, triggers);
+    // Interpolated between the last reading at the wall and the first one on the bike
+    TEST_ASSERT_GREATER_THAN(99 * INTERVAL_MICROS, crossingMicros);
+    TEST_ASSERT_LESS_OR_EQUAL(100 * INTERVAL_MICROS, crossingMicros);
+}
+
+void test_clean_pass_is_one_trigger(void) {
+    checkCleanPass(percentParameters(20, 5, BASELINE_MEAN));
+    checkCleanPass(percentParameters(20, 5, BASELINE_MEDIAN));
+    checkCleanPass(percentParameters(20, 5, BASELINE_HAMPEL));
+
+    Parameters params = percentParameters(20, 5, BASELINE_MEAN);
+    params.detectionMethod = DETECTION_STATISTICAL;
+    checkCleanPass(params);
+}
+
+void test_single_wild_reading_is_fluke(void) {
+    // The detector keeps a reference to its settings
+    const Parameters params = percentParameters(20, 5, BASELINE_MEAN);
+    Detector detector(params);
+    uint32_t flukes = 0;
+    for (uint32_t i = 0; i < 100; i++) {
+        const int distance = i == 50 ? 40 : 300;
+        const Detector::Event event = detector.step({ distance, i * INTERVAL_MICROS });
+        TEST_ASSERT_TRUE(event != Detector::TRIGGER);
+        flukes += event == Detector::FLUKE;
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, flukes);
+}
+
+void test_timeouts_leave_windows_alone(void) {
+    const Parameters params = percentParameters(20, 5, BASELINE_MEAN);
+    Detector detector(params);
+    for (uint32_t i = 0; i < 30; i++)
+        detector.step({ 300, i * INTERVAL_MICROS });
+    const int fill = detector.windowFill();
+
+    for (uint32_t i = 30; i < 60; i++) {
+        TEST_ASSERT_EQUAL_INT(Detector::TIMEOUT, detector.step({ (int) RANGER_TIMEOUT, i * INTERVAL_MICROS }));
+        TEST_ASSERT_EQUAL_INT(300, detector.result().average);
+    }
+    TEST_ASSERT_EQUAL_INT(fill, detector.windowFill());
+    TEST_ASSERT_EQUAL_INT(Detector::NONE, detector.step({ 300, 60 * INTERVAL_MICROS }));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_mean_baseline_matches_configured);
+    RUN_TEST(test_median_baseline_matches_configured);
+    RUN_TEST(test_hampel_baseline_matches_configured);
+    RUN_TEST(test_statistical_matches_configured);
+    RUN_TEST(test_millis_clock_reports_micros);
+    RUN_TEST(test_clean_pass_is_one_trigger);
+    RUN_TEST(test_single_wild_reading_is_fluke);
+    RUN_TEST(test_timeouts_leave_windows_alone);
+    return UNITY_END();
+}
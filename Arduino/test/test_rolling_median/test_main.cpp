@@ -0,0 +1,266 @@
+// RollingMedian and HampelFilter against a sorted copy of the window.
+//
+//   pio test -e native -f test_rolling_median
+
+#include <unity.h>
+#include <stdint.h>
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include "HampelFilter.h"
+#include "RollingMedian.h"
+
+static uint32_t seed = 1;
+
+// xorshift32, like SimulatedCourse, so a failure repeats on every machine
+static uint32_t nextRandom() {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+/// @brief Window kept the slow way: a queue of the values, sorted for every median
+class ReferenceWindow {
+    public:
+        explicit ReferenceWindow(size_t size) : maxSize(size) {}
+
+        void append(int32_t value) {
+            if (values.size() == maxSize)
+                values.pop_front();
+            values.push_back(value);
+        }
+
+        int32_t median() const {
+            if (values.empty())
+                return 0;
+            std::vector<int32_t> sorted(values.begin(), values.end());
+            std::sort(sorted.begin(), sorted.end());
+            const size_t middle = sorted.size() / 2;
+            if (sorted.size() % 2 == 1)
+                return sorted[middle];
+            return (sorted[middle - 1] + sorted[middle]) / 2;
+        }
+
+        size_t size() const { return values.size(); }
+        void clear() { values.clear(); }
+
+    private:
+        std::deque<int32_t> values;
+        size_t maxSize;
+};
+
+/// @brief HampelFilter::filter() spelled out on two reference windows
+class ReferenceHampel {
+    public:
+        ReferenceHampel(size_t size, int k, int32_t minDeviation) :
+            values(size), deviations(size), k(k), minDeviation(minDeviation) {}
+
+        int32_t filter(int32_t value) {
+            const int32_t median = values.size() > 0 ? values.median() : value;
+            const int32_t deviation = value < median ? median - value : value - median;
+            values.append(value);
+            deviations.append(deviation);
+            if (values.size() < 3)
+                return value;
+            int32_t scaled = (int32_t) (deviations.median() * 14826L / 10000);
+            if (scaled < minDeviation)
+                scaled = minDeviation;
+            return deviation > k * scaled ? median : value;
+        }
+
+    private:
+        ReferenceWindow values;
+        ReferenceWindow deviations;
+        int k;
+        int32_t minDeviation;
+};
+
+// Values in [base, base + range)
+static int32_t randomValue(int32_t base, uint32_t range) {
+    return base + (int32_t) (nextRandom() % range);
+}
+
+template <size_t N>
+static void checkStream(size_t size, uint32_t count, int32_t base, uint32_t range) {
+    RollingMedian<int32_t, N> window(size);
+    ReferenceWindow reference(window.capacity());
+    for (uint32_t i = 0; i < count; i++) {
+        const int32_t value = randomValue(base, range);
+        window.append(value);
+        reference.append(value);
+        TEST_ASSERT_EQUAL_UINT32(reference.size(), window.size());
+        TEST_ASSERT_EQUAL_INT32(reference.median(), window.median());
+    }
+}
+
+void setUp(void) {
+    seed = 1;
+}
+
+void tearDown(void) {}
+
+void test_empty_window_has_median_zero(void) {
+    RollingMedian<int32_t, 8> window;
+    TEST_ASSERT_EQUAL_UINT32(0, window.size());
+    TEST_ASSERT_EQUAL_INT32(0, window.median());
+    TEST_ASSERT_FALSE(window.isFull());
+}
+
+void test_median_of_random_streams(void) {
+    checkStream<50>(50, 20000, 0, 400);
+    checkStream<50>(31, 20000, -200, 400);
+    checkStream<64>(2, 5000, 0, 1000);
+    checkStream<64>(3, 5000, 0, 1000);
+}
+
+void test_even_count_is_mean_of_middle_values(void) {
+    RollingMedian<int32_t, 4> window;
+    window.append(10);
+    window.append(20);
+    TEST_ASSERT_EQUAL_INT32(15, window.median());
+    window.append(1);
+    window.append(2);
+    TEST_ASSERT_EQUAL_INT32(6, window.median());
+
+    // Truncated towards zero like RollingWindow::average()
+    RollingMedian<int32_t, 2> negative;
+    negative.append(-3);
+    negative.append(-4);
+    TEST_ASSERT_EQUAL_INT32(-3, negative.median());
+}
+
+void test_eviction_drops_oldest_value(void) {
+    RollingMedian<int32_t, 3> window;
+    window.append(100);
+    window.append(1);
+    window.append(2);
+    TEST_ASSERT_EQUAL_INT32(2, window.median());
+    TEST_ASSERT_TRUE(window.isFull());
+
+    // 100 leaves the window, not the largest or the newest value
+    window.append(3);
+    TEST_ASSERT_EQUAL_UINT32(3, window.size());
+    TEST_ASSERT_EQUAL_INT32(2, window.median());
+    window.append(4);
+    TEST_ASSERT_EQUAL_INT32(3, window.median());
+}
+
+void test_window_size_one(void) {
+    checkStream<1>(1, 1000, 0, 100);
+    checkStream<16>(1, 1000, 0, 100);
+
+    RollingMedian<int32_t, 16> window(0);
+    TEST_ASSERT_EQUAL_UINT32(1, window.capacity());
+}
+
+void test_many_equal_values(void) {
+    // Few distinct values, so most comparisons are ties
+    checkStream<40>(40, 20000, 7, 3);
+    checkStream<40>(17, 20000, 7, 1);
+
+    RollingMedian<int32_t, 10> window;
+    for (int i = 0; i < 25; i++)
+        window.append(42);
+    TEST_ASSERT_EQUAL_INT32(42, window.median());
+    window.append(0);
+    TEST_ASSERT_EQUAL_INT32(42, window.median());
+}
+
+void test_resize_and_clear(void) {
+    RollingMedian<int32_t, 32> window(8);
+    for (int i = 0; i < 20; i++)
+        window.append(randomValue(0, 100));
+
+    TEST_ASSERT_EQUAL_UINT32(20, window.resize(20));
+    TEST_ASSERT_EQUAL_UINT32(0, window.size());
+    TEST_ASSERT_EQUAL_UINT32(32, window.resize(100));
+    TEST_ASSERT_EQUAL_UINT32(1, window.resize(0));
+
+    const size_t sizes[] = {5, 32, 12, 1, 30};
+    for (size_t size : sizes) {
+        window.resize(size);
+        ReferenceWindow reference(size);
+        for (int i = 0; i < 500; i++) {
+            const int32_t value = randomValue(0, 100);
+            window.append(value);
+            reference.append(value);
+            TEST_ASSERT_EQUAL_INT32(reference.median(), window.median());
+        }
+
+        window.clear();
+        reference.clear();
+        TEST_ASSERT_EQUAL_UINT32(0, window.size());
+        TEST_ASSERT_EQUAL_UINT32(size, window.capacity());
+        for (int i = 0; i < 100; i++) {
+            const int32_t value = randomValue(-50, 100);
+            window.append(value);
+            reference.append(value);
+            TEST_ASSERT_EQUAL_INT32(reference.median(), window.median());
+        }
+    }
+}
+
+void test_hampel_matches_reference(void) {
+    const size_t sizes[] = {1, 2, 5, 21, 50};
+    for (size_t size : sizes) {
+        HampelFilter<int32_t, 50> filter(size, 3, 2);
+        ReferenceHampel reference(size, 3, 2);
+        for (int i = 0; i < 5000; i++) {
+            // Mostly noise around a level with rare spikes, like sensor readings with echo dropouts
+            int32_t value = randomValue(150, 10);
+            if (nextRandom() % 20 == 0)
+                value = randomValue(0, 400);
+            TEST_ASSERT_EQUAL_INT32(reference.filter(value), filter.filter(value));
+        }
+    }
+}
+
+void test_hampel_replaces_spike_and_follows_step(void) {
+    HampelFilter<int32_t, 9> filter(9, 3, 1);
+    for (int i = 0; i < 9; i++)
+        TEST_ASSERT_EQUAL_INT32(100, filter.filter(100));
+
+    // A single spike is an outlier and replaced by the median
+    TEST_ASSERT_EQUAL_INT32(100, filter.filter(30));
+
+    // A lasting step is accepted once it fills half the window
+    int32_t output = 0;
+    for (int i = 0; i < 9; i++)
+        output = filter.filter(30);
+    TEST_ASSERT_EQUAL_INT32(30, output);
+}
+
+void test_hampel_resize_and_clear(void) {
+    HampelFilter<int32_t, 20> filter(20, 3, 1);
+    for (int i = 0; i < 30; i++)
+        filter.filter(randomValue(0, 100));
+
+    TEST_ASSERT_EQUAL_UINT32(5, filter.resize(5));
+    TEST_ASSERT_EQUAL_UINT32(0, filter.size());
+    ReferenceHampel reference(5, 3, 1);
+    for (int i = 0; i < 1000; i++) {
+        const int32_t value = randomValue(0, 100);
+        TEST_ASSERT_EQUAL_INT32(reference.filter(value), filter.filter(value));
+    }
+
+    // Nothing counts as an outlier with fewer than 3 values
+    filter.clear();
+    TEST_ASSERT_EQUAL_INT32(50, filter.filter(50));
+    TEST_ASSERT_EQUAL_INT32(5000, filter.filter(5000));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_window_has_median_zero);
+    RUN_TEST(test_median_of_random_streams);
+    RUN_TEST(test_even_count_is_mean_of_middle_values);
+    RUN_TEST(test_eviction_drops_oldest_value);
+    RUN_TEST(test_window_size_one);
+    RUN_TEST(test_many_equal_values);
+    RUN_TEST(test_resize_and_clear);
+    RUN_TEST(test_hampel_matches_reference);
+    RUN_TEST(test_hampel_replaces_spike_and_follows_step);
+    RUN_TEST(test_hampel_resize_and_clear);
+    return UNITY_END();
+}
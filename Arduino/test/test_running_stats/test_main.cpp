@@ -0,0 +1,255 @@
+// RunningStats calibration and tracking, and the ZScoreTrigger thresholds built on them.
+//
+//   pio test -e native -f test_running_stats
+
+#include <unity.h>
+#include <math.h>
+#include <stdint.h>
+#include "DetectorBaselines.h"
+#include "DetectorTriggers.h"
+#include "Parameters.h"
+#include "RunningStats.h"
+
+// Fixed point of a value in cm
+static int32_t fixed(double cm) {
+    return (int32_t) lround(cm * STATS_ONE);
+}
+
+static Calibration calibration(double mean, double sigma) {
+    return {fixed(mean), (uint32_t) fixed(sigma)};
+}
+
+static double populationSigma(const int* values, int count) {
+    double mean = 0;
+    for (int i = 0; i < count; i++)
+        mean += values[i];
+    mean /= count;
+    double sum = 0;
+    for (int i = 0; i < count; i++)
+        sum += (values[i] - mean) * (values[i] - mean);
+    return sqrt(sum / count);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_isqrt64_rounds_down(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, isqrt64(0));
+    TEST_ASSERT_EQUAL_UINT32(1, isqrt64(3));
+    TEST_ASSERT_EQUAL_UINT32(2, isqrt64(4));
+    TEST_ASSERT_EQUAL_UINT32(65535, isqrt64(4294967295ULL));
+    TEST_ASSERT_EQUAL_UINT32(65536, isqrt64(4294967296ULL));
+    TEST_ASSERT_EQUAL_UINT32(4294967295UL, isqrt64(18446744073709551615ULL));
+    for (uint64_t value = 1; value < 100000; value += 7) {
+        const uint64_t root = isqrt64(value);
+        TEST_ASSERT_TRUE(root * root <= value && (root + 1) * (root + 1) > value);
+    }
+}
+
+void test_calibration_is_exact(void) {
+    const int values[] = {100, 104, 98, 101, 97, 103, 99, 102, 100, 96};
+    RunningStats stats(10);
+    for (int i = 0; i < 10; i++) {
+        TEST_ASSERT_FALSE(stats.isFull());
+        stats.add(values[i]);
+        TEST_ASSERT_EQUAL_INT(i + 1, stats.fill());
+
+        // Mean and standard deviation of the readings so far, not of a zero-padded window
+        double mean = 0;
+        for (int j = 0; j <= i; j++)
+            mean += values[j];
+        mean /= i + 1;
+        TEST_ASSERT_INT_WITHIN(2, fixed(mean), stats.meanFixed());
+        TEST_ASSERT_INT_WITHIN(2, fixed(populationSigma(values, i + 1)), (int32_t) stats.sigmaFixed());
+    }
+    TEST_ASSERT_TRUE(stats.isFull());
+    TEST_ASSERT_EQUAL_INT(100, stats.average());
+}
+
+void test_handover_to_exponential_weights(void) {
+    // Alternating 95 and 105: mean 100, standard deviation 5
+    const int size = 20;
+    RunningStats stats(size);
+    for (int i = 0; i < size; i++)
+        stats.add(i % 2 == 0 ? 95 : 105);
+    TEST_ASSERT_TRUE(stats.isFull());
+    TEST_ASSERT_EQUAL_INT32(fixed(100), stats.meanFixed());
+    TEST_ASSERT_EQUAL_UINT32(fixed(5), stats.sigmaFixed());
+
+    // The first weighted reading moves the statistics by 1/size, without a jump at the handover
+    const int32_t mean = stats.meanFixed();
+    const uint64_t variance = (uint64_t) stats.sigmaFixed() * stats.sigmaFixed();
+    stats.add(95);
+    const int32_t delta = fixed(95) - mean;
+    TEST_ASSERT_EQUAL_INT32(mean + delta / size, stats.meanFixed());
+    const uint64_t expected = variance + (uint64_t) ((int64_t) delta * delta) / size;
+    TEST_ASSERT_EQUAL_UINT32(isqrt64(expected - expected / size), stats.sigmaFixed());
+    TEST_ASSERT_EQUAL_INT(size, stats.fill());
+
+    // The same stream keeps the same statistics
+    for (int i = 1; i < 1000; i++)
+        stats.add(i % 2 == 0 ? 95 : 105);
+    TEST_ASSERT_INT_WITHIN(STATS_ONE / 4, fixed(100), stats.meanFixed());
+    TEST_ASSERT_INT_WITHIN(STATS_ONE / 4, fixed(5), (int32_t) stats.sigmaFixed());
+}
+
+void test_exponential_weights_follow_drift(void) {
+    const int size = 20;
+    RunningStats stats(size);
+    for (int i = 0; i < size; i++)
+        stats.add(200);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.sigmaFixed());
+
+    // A new level is taken over within a few window lengths, unlike a calibration that never ends
+    for (int i = 0; i < 5 * size; i++)
+        stats.add(150);
+    TEST_ASSERT_INT_WITHIN(1, 150, stats.average());
+
+    // ...and the noise of the step fades again
+    const uint32_t sigmaAfterStep = stats.sigmaFixed();
+    for (int i = 0; i < 10 * size; i++)
+        stats.add(150);
+    TEST_ASSERT_LESS_THAN(sigmaAfterStep, stats.sigmaFixed());
+    TEST_ASSERT_LESS_THAN((uint32_t) STATS_ONE, stats.sigmaFixed());
+}
+
+void test_seed_clear_and_resize(void) {
+    RunningStats stats(10);
+    stats.seed(fixed(123.5), fixed(2));
+    TEST_ASSERT_TRUE(stats.isFull());
+    TEST_ASSERT_EQUAL_INT32(fixed(123.5), stats.meanFixed());
+    TEST_ASSERT_EQUAL_UINT32(fixed(2), stats.sigmaFixed());
+
+    // A seeded window goes straight to exponential weights
+    stats.add(123);
+    TEST_ASSERT_EQUAL_INT(10, stats.fill());
+    TEST_ASSERT_INT_WITHIN(STATS_ONE / 8, fixed(123.45), stats.meanFixed());
+
+    stats.clear();
+    TEST_ASSERT_EQUAL_INT(0, stats.fill());
+    TEST_ASSERT_EQUAL_INT32(0, stats.meanFixed());
+    TEST_ASSERT_EQUAL_UINT32(0, stats.sigmaFixed());
+
+    stats.resize(0);
+    stats.add(42);
+    TEST_ASSERT_TRUE(stats.isFull());
+    TEST_ASSERT_EQUAL_INT(42, stats.average());
+}
+
+static Parameters zScoreParameters() {
+    Parameters params;
+    params.detectionMethod = DETECTION_STATISTICAL;
+    params.zScoreTrigger = 3;
+    return params;
+}
+
+void test_z_score_against_measured_noise(void) {
+    const Parameters params = zScoreParameters();
+    ZScoreTrigger trigger(params);
+    StatsBaseline<20, 5> baseline(params);
+    baseline.seed(calibration(100, 2));
+    TEST_ASSERT_EQUAL_INT(300, trigger.threshold());
+
+    DetectorTypes::Result result = {};
+    result.reading = 106;
+    trigger.rate(baseline, result);
+    TEST_ASSERT_EQUAL_INT(300, trigger.score(result));
+    result.reading = 97;
+    trigger.rate(baseline, result);
+    TEST_ASSERT_EQUAL_INT(150, result.zScore);
+
+    // Readings are whole cm, so a noise level below 1 cm counts as 1 cm
+    baseline.seed(calibration(100, 0.25));
+    result.reading = 102;
+    trigger.rate(baseline, result);
+    TEST_ASSERT_EQUAL_INT(200, result.zScore);
+}
+
+void test_z_score_threshold_and_cusum(void) {
+    const Parameters params = zScoreParameters();
+    ZScoreTrigger trigger(params);
+
+    // A single reading at the threshold deviates, one just below does not
+    TEST_ASSERT_TRUE(trigger.deviates(300, false));
+    trigger.restart();
+    TEST_ASSERT_FALSE(trigger.deviates(299, false));
+    trigger.restart();
+
+    // Scores within the slack never add up
+    for (int i = 0; i < 100; i++)
+        TEST_ASSERT_FALSE(trigger.deviates(DETECTOR_CUSUM_SLACK, false));
+
+    // Two readings of 2.5 sigma do: 150 + 150 reaches the threshold
+    TEST_ASSERT_FALSE(trigger.deviates(250, false));
+    TEST_ASSERT_TRUE(trigger.deviates(250, false));
+
+    // Baseline readings drain the sum again
+    trigger.restart();
+    TEST_ASSERT_FALSE(trigger.deviates(250, false));
+    TEST_ASSERT_FALSE(trigger.deviates(0, false));
+    TEST_ASSERT_FALSE(trigger.deviates(250, false));
+
+    // While detecting, the sum belongs to the detection window
+    trigger.restart();
+    TEST_ASSERT_FALSE(trigger.deviates(250, true));
+    TEST_ASSERT_FALSE(trigger.deviates(250, true));
+}
+
+void test_z_score_confirm_needs_half_the_window(void) {
+    const Parameters params = zScoreParameters();
+    ZScoreTrigger trigger(params);
+    StatsBaseline<20, 4> baseline(params);
+    baseline.seed(calibration(100, 2));
+    DetectorTypes::Result result = {};
+
+    // Four readings, so 2 * (300 - 100) = 400 is required. A wild reading is clipped to the threshold.
+    trigger.startDetection();
+    for (int i = 0; i < 4; i++)
+        baseline.addDetection(100);
+    trigger.addDetection(10000);
+    trigger.addDetection(0);
+    trigger.addDetection(0);
+    trigger.addDetection(0);
+    result.detectionAverage = 100;
+    TEST_ASSERT_FALSE(trigger.confirm(baseline, result));
+    TEST_ASSERT_EQUAL_UINT16(0, result.confidence);
+
+    trigger.startDetection();
+    trigger.addDetection(300);
+    trigger.addDetection(300);
+    trigger.addDetection(100);
+    trigger.addDetection(100);
+    result.detectionAverage = 106;
+    TEST_ASSERT_TRUE(trigger.confirm(baseline, result));
+    TEST_ASSERT_EQUAL_UINT16(500, result.confidence);
+    TEST_ASSERT_EQUAL_INT(300, result.zScore);
+
+    // confirm() starts the next sum from zero
+    TEST_ASSERT_FALSE(trigger.deviates(250, false));
+}
+
+void test_z_score_warm_start(void) {
+    const Parameters params = zScoreParameters();
+    ZScoreTrigger trigger(params);
+    TEST_ASSERT_FALSE(trigger.accepts(calibration(100, 0)));
+    TEST_ASSERT_TRUE(trigger.accepts(calibration(100, 2)));
+
+    // Within half the threshold of the stored calibration
+    TEST_ASSERT_TRUE(trigger.agrees(calibration(100, 2), 102));
+    TEST_ASSERT_FALSE(trigger.agrees(calibration(100, 2), 103));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_isqrt64_rounds_down);
+    RUN_TEST(test_calibration_is_exact);
+    RUN_TEST(test_handover_to_exponential_weights);
+    RUN_TEST(test_exponential_weights_follow_drift);
+    RUN_TEST(test_seed_clear_and_resize);
+    RUN_TEST(test_z_score_against_measured_noise);
+    RUN_TEST(test_z_score_threshold_and_cusum);
+    RUN_TEST(test_z_score_confirm_needs_half_the_window);
+    RUN_TEST(test_z_score_warm_start);
+    return UNITY_END();
+}
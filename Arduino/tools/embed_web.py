@@ -0,0 +1,65 @@
+# Embeds web/index.html into include/WebUi.h as a gzip compressed PROGMEM array.
+#
+# Runs before every firmware build (extra_scripts in platformio.ini) and only rewrites the header when
+# the page changed, so the result is also committed and the firmware builds without this script.
+# Can be run by hand as well:
+#
+#   python3 tools/embed_web.py
+#
+# The ETag is a hash of the page, so browsers revalidate with If-None-Match and get a 304 until the
+# firmware ships a different page.
+
+import gzip
+import hashlib
+import os
+
+try:
+    # Inside PlatformIO, where __file__ is not set
+    Import("env")  # noqa: F821
+    PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SOURCE = os.path.join(PROJECT_DIR, "web", "index.html")
+HEADER = os.path.join(PROJECT_DIR, "include", "WebUi.h")
+
+
+def render(page):
+    # mtime=0 keeps the output byte identical between runs
+    compressed = gzip.compress(page, compresslevel=9, mtime=0)
+    etag = hashlib.sha1(page).hexdigest()[:16]
+
+    lines = [
+        "// Generated by tools/embed_web.py from web/index.html. Do not edit.",
+        "#ifndef WebUi_H",
+        "#define WebUi_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "// %d bytes, %d uncompressed" % (len(compressed), len(page)),
+        "const char INDEX_HTML_ETAG[] = \"\\\"%s\\\"\";" % etag,
+        "const size_t INDEX_HTML_GZ_SIZE = %d;" % len(compressed),
+        "const uint8_t INDEX_HTML_GZ[] PROGMEM = {",
+    ]
+    for offset in range(0, len(compressed), 16):
+        chunk = compressed[offset:offset + 16]
+        lines.append("    " + ", ".join("0x%02x" % b for b in chunk) + ",")
+    lines += ["};", "", "#endif", ""]
+    return "\n".join(lines)
+
+
+def embed():
+    with open(SOURCE, "rb") as f:
+        header = render(f.read())
+
+    if os.path.exists(HEADER):
+        with open(HEADER) as f:
+            if f.read() == header:
+                return
+
+    with open(HEADER, "w") as f:
+        f.write(header)
+    print("Embedded %s into %s" % (os.path.relpath(SOURCE, PROJECT_DIR), os.path.relpath(HEADER, PROJECT_DIR)))
+
+
+embed()